@@ -69,6 +69,16 @@
     XCTAssertTrue([url isEqualToString:expectedUrlStr]);
 }
 
+- (void)testLinkBulkServiceURL {
+    BNCServerAPI *serverAPI = [BNCServerAPI new];
+    serverAPI.automaticallyEnableTrackingDomain = NO;
+    
+    NSString *url = [serverAPI linkBulkServiceURL];
+    NSString *expectedUrlStr = @"https://api3.branch.io/v1/url/bulk";
+    
+    XCTAssertTrue([url isEqualToString:expectedUrlStr]);
+}
+
 - (void)testQRCodeServiceURL {
     BNCServerAPI *serverAPI = [BNCServerAPI new];
     serverAPI.automaticallyEnableTrackingDomain = NO;
@@ -10,6 +10,10 @@
 #import "BNCApplication.h"
 #import "BNCKeyChain.h"
 
+@interface BNCApplication (Test)
++ (BNCApplication *)createApplicationWithSnapshotURL:(NSURL *)snapshotURL;
+@end
+
 @interface BNCApplicationTests : XCTestCase
 @end
 
@@ -72,4 +76,40 @@
     XCTAssertEqualObjects(application.firstInstallDate, firstInstallDate);
 }
 
+- (void)testSnapshotIsReusedBySameBuild {
+    NSURL *url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"BNCApplicationSnapshotTest"]];
+    [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+
+    BNCApplication *probed = [BNCApplication createApplicationWithSnapshotURL:url];
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:url.path]);
+
+    BNCApplication *loaded = [BNCApplication createApplicationWithSnapshotURL:url];
+    XCTAssertEqualObjects(probed.currentBuildDate, loaded.currentBuildDate);
+    XCTAssertEqualObjects(probed.firstInstallBuildDate, loaded.firstInstallBuildDate);
+    XCTAssertEqualObjects(probed.currentInstallDate, loaded.currentInstallDate);
+    XCTAssertEqualObjects(probed.teamID, loaded.teamID);
+    XCTAssertEqualObjects(probed.firstInstallDate, loaded.firstInstallDate);
+
+    [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+}
+
+- (void)testSnapshotFromOtherBuildIsIgnored {
+    NSURL *url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"BNCApplicationSnapshotTest"]];
+    NSDate *staleDate = [NSDate dateWithTimeIntervalSince1970:1000];
+    NSDictionary *snapshot = @{
+        @"v": @1,
+        @"app": @"0.0|0|/old/bundle/path",
+        @"build": staleDate,
+        @"first_build": staleDate,
+        @"install": staleDate
+    };
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:snapshot format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+    [data writeToURL:url atomically:YES];
+
+    BNCApplication *application = [BNCApplication createApplicationWithSnapshotURL:url];
+    XCTAssertNotEqualObjects(staleDate, application.currentInstallDate);
+
+    [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+}
+
 @end
@@ -0,0 +1,146 @@
+//
+//  BNCContentAnalyticsStoreTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCContentAnalyticsStore.h"
+#import "BNCPreferenceHelper.h"
+
+@interface BNCPreferenceHelper ()
+- (void)setUseStorage:(BOOL)useStorage;
+- (NSUInteger)bytesWritten;
+@end
+
+@interface BNCContentAnalyticsStoreTests : XCTestCase
+@property (nonatomic, strong) NSURL *url;
+@end
+
+@implementation BNCContentAnalyticsStoreTests
+
+- (void)setUp {
+    NSString *name = [NSString stringWithFormat:@"BNCContentAnalyticsStoreTests-%@.log", [NSUUID UUID].UUIDString];
+    self.url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.url error:nil];
+}
+
+- (NSDictionary *)eventForView:(NSInteger)view {
+    return @{ @"v": [NSString stringWithFormat:@"/View%ld", (long)view], @"ck": @[ @"title", @"price" ] };
+}
+
+- (void)testEventsAreGroupedBySession {
+    BNCContentAnalyticsStore *store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    [store appendEvent:[self eventForView:1] sessionID:@"a"];
+    [store appendEvent:[self eventForView:2] sessionID:@"b"];
+    [store appendEvent:[self eventForView:3] sessionID:@"a"];
+
+    NSDictionary *sessions = [store eventsBySession];
+    XCTAssertEqualObjects((@[ [self eventForView:1], [self eventForView:3] ]), sessions[@"a"]);
+    XCTAssertEqualObjects(@[ [self eventForView:2] ], sessions[@"b"]);
+}
+
+- (void)testEventsArePersisted {
+    BNCContentAnalyticsStore *store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    [store appendEvent:[self eventForView:1] sessionID:@"a"];
+    [store appendEvent:[self eventForView:2] sessionID:@"a"];
+    [store drainEventsWithBatchSize:1 handler:^BOOL(NSDictionary<NSString *,NSArray *> *batch) {
+        return [batch[@"a"].firstObject isEqual:[self eventForView:1]];
+    }];
+    store = nil;
+
+    // the drained event stays drained
+    store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    XCTAssertEqualObjects(@[ [self eventForView:2] ], [store eventsBySession][@"a"]);
+}
+
+- (void)testDrainInBatches {
+    BNCContentAnalyticsStore *store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    for (NSInteger i = 0; i < 25; i++) {
+        [store appendEvent:[self eventForView:i] sessionID:@"a"];
+    }
+
+    NSMutableArray<NSNumber *> *sizes = [NSMutableArray new];
+    [store drainEventsWithBatchSize:10 handler:^BOOL(NSDictionary<NSString *,NSArray *> *batch) {
+        [sizes addObject:@(batch[@"a"].count)];
+        return YES;
+    }];
+    XCTAssertEqualObjects((@[ @10, @10, @5 ]), sizes);
+    XCTAssertEqual(0, store.byteCount);
+    XCTAssertEqual(0, [store eventsBySession].count);
+}
+
+- (void)testRejectedBatchIsKept {
+    BNCContentAnalyticsStore *store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    for (NSInteger i = 0; i < 5; i++) {
+        [store appendEvent:[self eventForView:i] sessionID:@"a"];
+    }
+
+    __block NSInteger calls = 0;
+    [store drainEventsWithBatchSize:2 handler:^BOOL(NSDictionary<NSString *,NSArray *> *batch) {
+        return ++calls == 1;
+    }];
+    XCTAssertEqual(2, calls);
+
+    NSArray *remaining = [store eventsBySession][@"a"];
+    XCTAssertEqual(3, remaining.count);
+    XCTAssertEqualObjects([self eventForView:2], remaining.firstObject);
+}
+
+- (void)testOldestEventsAreTrimmed {
+    BNCContentAnalyticsStore *store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    store.byteLimit = 4096;
+    for (NSInteger i = 0; i < 500; i++) {
+        [store appendEvent:[self eventForView:i] sessionID:@"a"];
+    }
+    [store synchronize];
+
+    XCTAssertLessThanOrEqual(store.byteCount, 4096);
+    NSArray *events = [store eventsBySession][@"a"];
+    XCTAssertGreaterThan(events.count, 0);
+    XCTAssertEqualObjects([self eventForView:499], events.lastObject);
+
+    NSNumber *size = [[NSFileManager defaultManager] attributesOfItemAtPath:self.url.path error:nil][NSFileSize];
+    XCTAssertLessThanOrEqual(size.unsignedIntegerValue, 4096 + 16);
+}
+
+- (void)testTornEventIsDropped {
+    BNCContentAnalyticsStore *store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    [store appendEvent:[self eventForView:1] sessionID:@"a"];
+    [store synchronize];
+    store = nil;
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:self.url.path];
+    [handle seekToEndOfFile];
+    [handle writeData:[@"{\"s\":\"a\",\"e\":{\"v\":" dataUsingEncoding:NSUTF8StringEncoding]];
+    [handle closeFile];
+
+    store = [[BNCContentAnalyticsStore alloc] initWithURL:self.url];
+    XCTAssertEqualObjects(@[ [self eventForView:1] ], [store eventsBySession][@"a"]);
+    [store appendEvent:[self eventForView:2] sessionID:@"a"];
+    XCTAssertEqual(2, [[store eventsBySession][@"a"] count]);
+}
+
+- (void)testAnalyticsDoNotGrowPreferenceWrites {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+    prefs.sessionID = @"session";
+    [prefs synchronize];
+
+    NSUInteger bytes = prefs.bytesWritten;
+    for (NSInteger i = 0; i < 100; i++) {
+        [prefs saveBranchAnalyticsData:[self eventForView:i]];
+    }
+    prefs.sessionParams = @"{}";
+    [prefs synchronize];
+    XCTAssertLessThan(prefs.bytesWritten - bytes, 256);
+
+    [prefs clearBranchAnalyticsData];
+    [prefs synchronize];
+}
+
+@end
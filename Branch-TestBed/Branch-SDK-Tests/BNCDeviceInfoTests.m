@@ -9,6 +9,7 @@
 #import <XCTest/XCTest.h>
 #import "BNCDeviceInfo.h"
 #import "BNCUserAgentCollector.h"
+#import "BNCSystemObserver.h"
 
 @interface BNCDeviceInfoTests : XCTestCase
 @property (nonatomic, strong, readwrite) BNCDeviceInfo *deviceInfo;
@@ -187,4 +188,35 @@
     XCTAssert([expectedVersion isEqualToString:self.deviceInfo.pluginVersion]);
 }
 
+- (void)testUserDataSnapshotIsReused {
+    NSDictionary *snapshot = [self.deviceInfo userDataSnapshot];
+    XCTAssertEqualObjects(self.deviceInfo.osVersion, snapshot[@"os_version"]);
+    XCTAssertEqualObjects(@"ios", snapshot[@"sdk"]);
+    XCTAssertTrue(snapshot == [self.deviceInfo userDataSnapshot]);
+}
+
+- (void)testUserDataSnapshotRebuiltOnChange {
+    NSDictionary *snapshot = [self.deviceInfo userDataSnapshot];
+
+    [self.deviceInfo registerPluginName:@"TestPlugin" version:@"1.0"];
+    NSDictionary *rebuilt = [self.deviceInfo userDataSnapshot];
+    XCTAssertFalse(snapshot == rebuilt);
+    XCTAssertEqualObjects(@"TestPlugin", rebuilt[@"plugin_name"]);
+
+    [[NSNotificationCenter defaultCenter] postNotificationName:NSCurrentLocaleDidChangeNotification object:nil];
+    XCTAssertFalse(rebuilt == [self.deviceInfo userDataSnapshot]);
+}
+
+- (void)testUserDataSnapshotRebuiltWhenAppBecomesActive {
+    NSDictionary *snapshot = [self.deviceInfo userDataSnapshot];
+    XCTAssertEqualObjects([BNCSystemObserver attOptedInStatus], snapshot[@"opted_in_status"]);
+
+    // ATT status is read again after the app becomes active, not on every request
+    [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidBecomeActiveNotification object:nil];
+    NSDictionary *rebuilt = [self.deviceInfo userDataSnapshot];
+    XCTAssertFalse(snapshot == rebuilt);
+    XCTAssertEqualObjects([BNCSystemObserver attOptedInStatus], rebuilt[@"opted_in_status"]);
+    XCTAssertTrue(rebuilt == [self.deviceInfo userDataSnapshot]);
+}
+
 @end
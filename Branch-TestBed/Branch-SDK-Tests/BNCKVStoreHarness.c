@@ -0,0 +1,230 @@
+//
+//  BNCKVStoreHarness.c
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+// Host test and benchmark for BNCKVStore. Not part of any Xcode target, build it with any C compiler:
+//
+//   cc -O2 -I Sources/BranchSDK/Private -o kvharness Sources/BranchSDK/BNCKVStore.c Branch-TestBed/Branch-SDK-Tests/BNCKVStoreHarness.c
+//   ./kvharness --bench [directory]
+//
+// The checks cover compaction racing with writes and clears. The benchmark compares one open response written
+// to the store with the same response written the way BNCPreferenceHelper used to, one atomic file rewrite per key.
+
+#include "BNCKVStore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(condition, ...) do { \
+    if (!(condition)) { \
+        failures++; \
+        fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+    } \
+} while (0)
+
+static char directory[512] = "/tmp";
+
+static void pathFor(char *path, size_t size, const char *name) {
+    snprintf(path, size, "%s/%s", directory, name);
+}
+
+static bool hasValue(BNCKVStore *store, const char *key, const char *expected) {
+    const void *value = NULL;
+    size_t length = 0;
+    if (!BNCKVStoreGet(store, key, strlen(key), NULL, &value, &length)) return expected == NULL;
+    return expected && length == strlen(expected) && memcmp(value, expected, length) == 0;
+}
+
+static void put(BNCKVStore *store, const char *key, const void *value, size_t length) {
+    CHECK(BNCKVStorePut(store, key, strlen(key), 1, value, length) == 0, "put %s", key);
+}
+
+// MARK: - Tests
+
+static void testCompactionKeepsWritesMadeWhileWriting(void) {
+    char path[600], tempPath[640];
+    pathFor(path, sizeof(path), "kvharness-compact.kv");
+    snprintf(tempPath, sizeof(tempPath), "%s.compact", path);
+    unlink(path);
+
+    int error = 0;
+    BNCKVStore *store = BNCKVStoreOpen(path, &error);
+    CHECK(store != NULL, "open %d", error);
+    if (!store) return;
+
+    char value[1000];
+    memset(value, 'x', sizeof(value));
+    for (int i = 0; i < 200; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "key%d", i % 10);
+        value[0] = (char)('a' + i % 26);
+        put(store, key, value, sizeof(value));
+    }
+
+    BNCKVCompaction *compaction = BNCKVStoreCompactionBegin(store, &error);
+    CHECK(compaction != NULL, "begin %d", error);
+    CHECK(BNCKVCompactionWrite(compaction) == 0, "write");
+
+    // changes between the snapshot and the finish
+    put(store, "added", "v", 1);
+    put(store, "key2", "z", 1);
+    CHECK(BNCKVStoreDelete(store, "key1", 4) == 0, "delete");
+
+    CHECK(BNCKVStoreCompactionFinish(store, compaction) == 0, "finish");
+    BNCKVCompactionFree(compaction);
+    CHECK(access(tempPath, F_OK) != 0, "temporary file left behind");
+
+    CHECK(BNCKVStoreCount(store) == 10, "count %zu", BNCKVStoreCount(store));
+    CHECK(hasValue(store, "added", "v") && hasValue(store, "key2", "z") && hasValue(store, "key1", NULL), "tail lost");
+    CHECK(BNCKVStoreGarbageBytes(store) < BNCKVStoreLiveBytes(store), "garbage %zu", BNCKVStoreGarbageBytes(store));
+
+    // the compacted file replays the same way
+    BNCKVStoreClose(store);
+    store = BNCKVStoreOpen(path, &error);
+    CHECK(store && BNCKVStoreCount(store) == 10, "reopen");
+    CHECK(store && hasValue(store, "added", "v") && hasValue(store, "key2", "z") && hasValue(store, "key1", NULL), "reopen values");
+
+    // a clear in between makes the compaction stale, and the store stays usable
+    compaction = BNCKVStoreCompactionBegin(store, &error);
+    CHECK(BNCKVCompactionWrite(compaction) == 0, "write");
+    CHECK(BNCKVStoreClear(store) == 0, "clear");
+    CHECK(BNCKVStoreCompactionFinish(store, compaction) == ESTALE, "stale finish");
+    BNCKVCompactionFree(compaction);
+    CHECK(access(tempPath, F_OK) != 0, "stale file left behind");
+    CHECK(BNCKVStoreCount(store) == 0, "clear lost");
+    put(store, "after", "1", 1);
+    CHECK(BNCKVStoreCompact(store) == 0 && hasValue(store, "after", "1"), "compact after clear");
+
+    BNCKVStoreClose(store);
+    unlink(path);
+}
+
+static void testFailedCompactionKeepsStore(void) {
+    char path[600], tempPath[640];
+    pathFor(path, sizeof(path), "kvharness-failed.kv");
+    snprintf(tempPath, sizeof(tempPath), "%s.compact", path);
+    unlink(path);
+    rmdir(tempPath);
+
+    int error = 0;
+    BNCKVStore *store = BNCKVStoreOpen(path, &error);
+    if (!store) return;
+    put(store, "key", "value", 5);
+
+    // a directory in the way of the new file
+    CHECK(mkdir(tempPath, 0700) == 0, "mkdir");
+    CHECK(BNCKVStoreCompact(store) != 0, "compaction should fail");
+    CHECK(hasValue(store, "key", "value"), "store lost its data");
+    put(store, "other", "1", 1);
+    CHECK(hasValue(store, "other", "1"), "store not writable");
+    rmdir(tempPath);
+
+    BNCKVStoreClose(store);
+    unlink(path);
+}
+
+// MARK: - Benchmark
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// The keys an open response updates, with typical sizes
+static const struct { const char *key; size_t length; } openResponse[15] = {
+    {"bnc_session_id", 20}, {"bnc_randomized_bundle_token", 20}, {"bnc_randomized_device_token", 20},
+    {"bnc_session_params", 600}, {"bnc_install_params", 600}, {"bnc_user_url", 60},
+    {"bnc_link_click_identifier", 20}, {"bnc_last_run_branch_key", 40}, {"bnc_app_version", 8},
+    {"bnc_previous_update_time", 8}, {"bnc_request_metadata", 200}, {"bnc_instrumentation", 300},
+    {"bnc_referring_url_query_parameters", 200}, {"bnc_skan_data", 100}, {"bnc_last_open_date", 8},
+};
+
+static void writeOpenResponse(BNCKVStore *store, int iteration) {
+    char value[1024];
+    memset(value, 'a' + iteration % 26, sizeof(value));
+    BNCKVStoreBeginBatch(store);
+    for (int i = 0; i < 15; i++) {
+        put(store, openResponse[i].key, value, openResponse[i].length);
+    }
+    BNCKVStoreCommitBatch(store);
+}
+
+static void benchmark(void) {
+    char path[600];
+    pathFor(path, sizeof(path), "kvharness-bench.kv");
+    unlink(path);
+
+    int error = 0;
+    BNCKVStore *store = BNCKVStoreOpen(path, &error);
+    if (!store) return;
+
+    int iterations = 0;
+    double start = now();
+    while (now() - start < 0.5) {
+        writeOpenResponse(store, iterations++);
+        if (BNCKVStoreNeedsCompaction(store)) BNCKVStoreCompact(store);
+    }
+    printf("%-36s %8.3f ms\n", "open response, 15 puts in a batch", (now() - start) * 1000 / iterations);
+    BNCKVStoreClose(store);
+
+    iterations = 0;
+    start = now();
+    while (now() - start < 0.5) {
+        BNCKVStoreClose(BNCKVStoreOpen(path, &error));
+        iterations++;
+    }
+    printf("%-36s %8.3f ms\n", "open and index", (now() - start) * 1000 / iterations);
+
+    // the archive holding every preference, about 6KB, rewritten once per key
+    char archive[6 * 1024], archivePath[600], tempPath[640];
+    memset(archive, 'a', sizeof(archive));
+    pathFor(archivePath, sizeof(archivePath), "kvharness-bench.archive");
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", archivePath);
+    iterations = 0;
+    start = now();
+    while (now() - start < 0.5) {
+        for (int i = 0; i < 15; i++) {
+            int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+            if (fd < 0) return;
+            if (write(fd, archive, sizeof(archive)) < 0 || fsync(fd) != 0) error = errno;
+            close(fd);
+            rename(tempPath, archivePath);
+        }
+        iterations++;
+    }
+    printf("%-36s %8.3f ms\n", "open response, 15 atomic rewrites", (now() - start) * 1000 / iterations);
+
+    unlink(archivePath);
+    unlink(path);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) snprintf(directory, sizeof(directory), "%s", argv[2]);
+
+    testCompactionKeepsWritesMadeWhileWriting();
+    testFailedCompactionKeepsStore();
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        benchmark();
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+//
+//  BNCKVStoreTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCKVStore.h"
+#import "BNCPreferenceStore.h"
+
+@interface BNCKVStoreTests : XCTestCase
+@property (nonatomic, strong) NSURL *url;
+@end
+
+@implementation BNCKVStoreTests
+
+- (void)setUp {
+    NSString *name = [NSString stringWithFormat:@"BNCKVStoreTests-%@.kv", [NSUUID UUID].UUIDString];
+    self.url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.url error:nil];
+}
+
+- (BNCKVStore *)openStore {
+    int error = 0;
+    BNCKVStore *store = BNCKVStoreOpen(self.url.fileSystemRepresentation, &error);
+    XCTAssertTrue(store != NULL);
+    XCTAssertEqual(0, error);
+    return store;
+}
+
+- (NSString *)stringForKey:(const char *)key store:(BNCKVStore *)store {
+    const void *value = NULL;
+    size_t length = 0;
+    if (!BNCKVStoreGet(store, key, strlen(key), NULL, &value, &length)) return nil;
+    return [[NSString alloc] initWithBytes:value length:length encoding:NSUTF8StringEncoding];
+}
+
+- (void)putString:(NSString *)string key:(const char *)key store:(BNCKVStore *)store {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual(0, BNCKVStorePut(store, key, strlen(key), 1, data.bytes, data.length));
+}
+
+- (void)testPutGetDelete {
+    BNCKVStore *store = [self openStore];
+    [self putString:@"a" key:"first" store:store];
+    [self putString:@"b" key:"second" store:store];
+    [self putString:@"c" key:"first" store:store];
+
+    XCTAssertEqual(2, BNCKVStoreCount(store));
+    XCTAssertEqualObjects(@"c", [self stringForKey:"first" store:store]);
+    XCTAssertEqualObjects(@"b", [self stringForKey:"second" store:store]);
+
+    XCTAssertEqual(0, BNCKVStoreDelete(store, "second", 6));
+    XCTAssertNil([self stringForKey:"second" store:store]);
+    XCTAssertEqual(1, BNCKVStoreCount(store));
+    XCTAssertGreaterThan(BNCKVStoreGarbageBytes(store), 0);
+    BNCKVStoreClose(store);
+}
+
+- (void)testReopenReplaysLog {
+    BNCKVStore *store = [self openStore];
+    for (int i = 0; i < 100; i++) {
+        [self putString:[NSString stringWithFormat:@"value %d", i] key:"counter" store:store];
+    }
+    [self putString:@"gone" key:"deleted" store:store];
+    BNCKVStoreDelete(store, "deleted", 7);
+    BNCKVStoreClose(store);
+
+    store = [self openStore];
+    XCTAssertEqual(1, BNCKVStoreCount(store));
+    XCTAssertEqualObjects(@"value 99", [self stringForKey:"counter" store:store]);
+    XCTAssertNil([self stringForKey:"deleted" store:store]);
+    BNCKVStoreClose(store);
+}
+
+- (void)testIdenticalValueIsNotAppended {
+    BNCKVStore *store = [self openStore];
+    [self putString:@"same" key:"key" store:store];
+    size_t live = BNCKVStoreLiveBytes(store);
+    [self putString:@"same" key:"key" store:store];
+    XCTAssertEqual(live, BNCKVStoreLiveBytes(store));
+    XCTAssertEqual(0, BNCKVStoreGarbageBytes(store));
+    BNCKVStoreClose(store);
+}
+
+- (void)testCompaction {
+    BNCKVStore *store = [self openStore];
+    NSString *large = [@"" stringByPaddingToLength:1000 withString:@"x" startingAtIndex:0];
+    for (int i = 0; !BNCKVStoreNeedsCompaction(store); i++) {
+        [self putString:[large stringByAppendingFormat:@"%d", i] key:"key" store:store];
+        [self putString:@"stable" key:"other" store:store];
+    }
+
+    size_t live = BNCKVStoreLiveBytes(store);
+    XCTAssertEqual(0, BNCKVStoreCompact(store));
+    XCTAssertEqual(0, BNCKVStoreGarbageBytes(store));
+    XCTAssertEqual(live, BNCKVStoreLiveBytes(store));
+    XCTAssertEqualObjects(@"stable", [self stringForKey:"other" store:store]);
+    BNCKVStoreClose(store);
+
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:self.url.path error:nil];
+    XCTAssertLessThan(attributes.fileSize, 64 * 1024);
+    store = [self openStore];
+    XCTAssertEqualObjects(@"stable", [self stringForKey:"other" store:store]);
+    BNCKVStoreClose(store);
+}
+
+- (void)testDamagedTailIsDropped {
+    BNCKVStore *store = [self openStore];
+    [self putString:@"kept" key:"first" store:store];
+    [self putString:@"damaged" key:"second" store:store];
+    BNCKVStoreClose(store);
+
+    // flip a byte in the last record, as a write torn by a crash would
+    NSFileHandle *handle = [NSFileHandle fileHandleForUpdatingURL:self.url error:nil];
+    [handle seekToFileOffset:8];
+    uint64_t used = 0;
+    [[handle readDataOfLength:sizeof(used)] getBytes:&used length:sizeof(used)];
+    [handle seekToFileOffset:used - 12];
+    [handle writeData:[@"!" dataUsingEncoding:NSUTF8StringEncoding]];
+    [handle closeFile];
+
+    store = [self openStore];
+    XCTAssertEqualObjects(@"kept", [self stringForKey:"first" store:store]);
+    XCTAssertNil([self stringForKey:"second" store:store]);
+    BNCKVStoreClose(store);
+}
+
+- (void)testBatchIsAllOrNothing {
+    BNCKVStore *store = [self openStore];
+    [self putString:@"before" key:"first" store:store];
+
+    // closed before the commit, as a crash would
+    XCTAssertEqual(0, BNCKVStoreBeginBatch(store));
+    XCTAssertEqual(EBUSY, BNCKVStoreBeginBatch(store));
+    [self putString:@"uncommitted" key:"first" store:store];
+    [self putString:@"uncommitted" key:"second" store:store];
+    XCTAssertEqualObjects(@"uncommitted", [self stringForKey:"first" store:store]);
+    XCTAssertEqual(EBUSY, BNCKVStoreCompact(store));
+    BNCKVStoreClose(store);
+
+    store = [self openStore];
+    XCTAssertEqualObjects(@"before", [self stringForKey:"first" store:store]);
+    XCTAssertNil([self stringForKey:"second" store:store]);
+
+    XCTAssertEqual(0, BNCKVStoreBeginBatch(store));
+    [self putString:@"committed" key:"first" store:store];
+    [self putString:@"committed" key:"second" store:store];
+    XCTAssertEqual(0, BNCKVStoreCommitBatch(store));
+    BNCKVStoreClose(store);
+
+    store = [self openStore];
+    XCTAssertEqualObjects(@"committed", [self stringForKey:"first" store:store]);
+    XCTAssertEqualObjects(@"committed", [self stringForKey:"second" store:store]);
+    BNCKVStoreClose(store);
+}
+
+- (void)testPreferenceStoreTypes {
+    BNCPreferenceStore *store = [[BNCPreferenceStore alloc] initWithURL:self.url];
+    NSDate *date = [NSDate dateWithTimeIntervalSinceReferenceDate:1000.5];
+    NSDictionary *values = @{
+        @"string": @"value",
+        @"integer": @(42),
+        @"double": @(0.5),
+        @"bool": @YES,
+        @"date": date,
+        @"data": [@"bytes" dataUsingEncoding:NSUTF8StringEncoding],
+        @"array": @[ @"a", @1 ],
+        @"dictionary": @{ @"nested": @"value" }
+    };
+    for (NSString *key in values) {
+        [store setObject:values[key] forKey:key];
+    }
+    [store synchronize];
+    store = nil;
+
+    store = [[BNCPreferenceStore alloc] initWithURL:self.url];
+    XCTAssertEqualObjects(values, [store dictionary]);
+    XCTAssertEqualObjects(date, [store objectForKey:@"date"]);
+
+    [store setObject:nil forKey:@"string"];
+    XCTAssertNil([store objectForKey:@"string"]);
+    XCTAssertEqual(values.count - 1, store.count);
+}
+
+#pragma mark - Benchmarks
+
+- (NSMutableDictionary *)benchmarkPreferences {
+    NSMutableDictionary *preferences = [NSMutableDictionary new];
+    for (int i = 0; i < 60; i++) {
+        preferences[[NSString stringWithFormat:@"bnc_key_%d", i]] = [NSString stringWithFormat:@"%@-%d", [NSUUID UUID].UUIDString, i];
+    }
+    preferences[@"bnc_session_params"] = [@"" stringByPaddingToLength:2048 withString:@"{}" startingAtIndex:0];
+    return preferences;
+}
+
+// One open response changes about 15 keys
+- (void)testArchiveUpdatePerformance {
+    NSMutableDictionary *preferences = [self benchmarkPreferences];
+    [self measureBlock:^{
+        for (int i = 0; i < 15; i++) {
+            preferences[@"bnc_session_id"] = [NSUUID UUID].UUIDString;
+            NSData *data = [NSKeyedArchiver archivedDataWithRootObject:preferences requiringSecureCoding:YES error:NULL];
+            [data writeToURL:self.url options:NSDataWritingAtomic error:NULL];
+        }
+    }];
+}
+
+- (void)testStoreUpdatePerformance {
+    BNCPreferenceStore *store = [[BNCPreferenceStore alloc] initWithURL:self.url];
+    NSMutableDictionary *preferences = [self benchmarkPreferences];
+    for (NSString *key in preferences) {
+        [store setObject:preferences[key] forKey:key];
+    }
+    [self measureBlock:^{
+        for (int i = 0; i < 15; i++) {
+            [store setObject:[NSUUID UUID].UUIDString forKey:@"bnc_session_id"];
+        }
+        [store synchronize];
+    }];
+}
+
+- (void)testArchiveLoadPerformance {
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:[self benchmarkPreferences] requiringSecureCoding:YES error:NULL];
+    [data writeToURL:self.url options:NSDataWritingAtomic error:NULL];
+    NSSet *classes = [NSSet setWithArray:@[ NSNumber.class, NSString.class, NSDate.class, NSArray.class, NSDictionary.class ]];
+    [self measureBlock:^{
+        NSData *loaded = [NSData dataWithContentsOfURL:self.url];
+        XCTAssertNotNil([NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:loaded error:NULL]);
+    }];
+}
+
+- (void)testStoreLoadPerformance {
+    BNCPreferenceStore *store = [[BNCPreferenceStore alloc] initWithURL:self.url];
+    NSMutableDictionary *preferences = [self benchmarkPreferences];
+    for (NSString *key in preferences) {
+        [store setObject:preferences[key] forKey:key];
+    }
+    [store synchronize];
+    store = nil;
+
+    [self measureBlock:^{
+        BNCPreferenceStore *loaded = [[BNCPreferenceStore alloc] initWithURL:self.url];
+        XCTAssertEqual(preferences.count, [loaded dictionary].count);
+    }];
+}
+
+@end
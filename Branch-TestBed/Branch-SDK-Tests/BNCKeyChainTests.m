@@ -9,6 +9,10 @@
 #import <XCTest/XCTest.h>
 #import "BNCKeyChain.h"
 
+@interface BNCKeyChain (Test)
++ (void)deferBatchReadForService:(NSString *)service;
+@end
+
 @interface BNCKeyChainTests : XCTestCase
 @property (nonatomic, copy, readwrite) NSString *serviceName;
 @end
@@ -118,4 +122,71 @@
 }
 
 
+- (void)testReadsAreServedFromCache {
+    NSError *error;
+    NSString *keyA = @"testKeyA";
+    NSString *keyB = @"testKeyB";
+    NSDate *dateA = [NSDate date];
+    NSDate *dateB = [NSDate dateWithTimeIntervalSinceNow:1];
+
+    [BNCKeyChain storeDate:dateA forService:self.serviceName key:keyA cloudAccessGroup:nil];
+    [BNCKeyChain storeDate:dateB forService:self.serviceName key:keyB cloudAccessGroup:nil];
+    [BNCKeyChain clearCache];
+
+    // one batch read for the service
+    NSUInteger roundTrips = [BNCKeyChain roundTripCount];
+    XCTAssertEqualObjects(dateA, [BNCKeyChain retrieveDateForService:self.serviceName key:keyA error:&error]);
+    XCTAssertEqualObjects(dateB, [BNCKeyChain retrieveDateForService:self.serviceName key:keyB error:&error]);
+    XCTAssertNil([BNCKeyChain retrieveDateForService:self.serviceName key:@"missingKey" error:&error]);
+    XCTAssertEqual(error.code, errSecItemNotFound);
+    XCTAssertEqual(roundTrips + 1, [BNCKeyChain roundTripCount]);
+
+    // writes update the cache
+    NSDate *newDate = [NSDate dateWithTimeIntervalSinceNow:2];
+    [BNCKeyChain storeDate:newDate forService:self.serviceName key:keyA cloudAccessGroup:nil];
+    roundTrips = [BNCKeyChain roundTripCount];
+    XCTAssertEqualObjects(newDate, [BNCKeyChain retrieveDateForService:self.serviceName key:keyA error:&error]);
+    XCTAssertEqual(roundTrips, [BNCKeyChain roundTripCount]);
+
+    // removal invalidates it
+    [BNCKeyChain removeValuesForService:self.serviceName key:keyA];
+    XCTAssertNil([BNCKeyChain retrieveDateForService:self.serviceName key:keyA error:&error]);
+    XCTAssertEqualObjects(dateB, [BNCKeyChain retrieveDateForService:self.serviceName key:keyB error:&error]);
+
+    // cleanup
+    error = [BNCKeyChain removeValuesForService:self.serviceName key:keyB];
+    XCTAssertNil(error);
+}
+
+- (void)testSingleReadsAreCachedWhileBatchReadIsDeferred {
+    NSError *error;
+    NSString *key = @"testKey";
+    NSDate *date = [NSDate date];
+
+    [BNCKeyChain storeDate:date forService:self.serviceName key:key cloudAccessGroup:nil];
+    [BNCKeyChain clearCache];
+    @synchronized ([BNCKeyChain class]) {
+        [BNCKeyChain deferBatchReadForService:self.serviceName];
+    }
+
+    // one single item read, then served from memory
+    NSUInteger roundTrips = [BNCKeyChain roundTripCount];
+    XCTAssertEqualObjects(date, [BNCKeyChain retrieveDateForService:self.serviceName key:key error:&error]);
+    XCTAssertEqualObjects(date, [BNCKeyChain retrieveDateForService:self.serviceName key:key error:&error]);
+    XCTAssertEqual(roundTrips + 1, [BNCKeyChain roundTripCount]);
+
+    // writes update it
+    NSDate *newDate = [NSDate dateWithTimeIntervalSinceNow:1];
+    [BNCKeyChain storeDate:newDate forService:self.serviceName key:key cloudAccessGroup:nil];
+    roundTrips = [BNCKeyChain roundTripCount];
+    XCTAssertEqualObjects(newDate, [BNCKeyChain retrieveDateForService:self.serviceName key:key error:&error]);
+    XCTAssertEqual(roundTrips, [BNCKeyChain roundTripCount]);
+
+    // cleanup
+    error = [BNCKeyChain removeValuesForService:self.serviceName key:key];
+    XCTAssertNil(error);
+    XCTAssertNil([BNCKeyChain retrieveDateForService:self.serviceName key:key error:&error]);
+    [BNCKeyChain clearCache];
+}
+
 @end
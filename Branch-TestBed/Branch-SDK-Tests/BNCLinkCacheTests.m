@@ -0,0 +1,135 @@
+//
+//  BNCLinkCacheTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCLinkCache.h"
+
+@interface BNCLinkCacheTests : XCTestCase
+@property (nonatomic, strong) NSURL *storageURL;
+@end
+
+@implementation BNCLinkCacheTests
+
+- (void)setUp {
+    NSString *name = [NSString stringWithFormat:@"BNCLinkCacheTests-%@", [NSUUID UUID].UUIDString];
+    self.storageURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.storageURL error:nil];
+}
+
+- (BNCLinkData *)linkDataWithChannel:(NSString *)channel {
+    BNCLinkData *linkData = [BNCLinkData new];
+    [linkData setupChannel:channel];
+    [linkData setupParams:@{ @"key": @"value" }];
+    return linkData;
+}
+
+- (void)testSetAndGet {
+    BNCLinkCache *cache = [BNCLinkCache new];
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+
+    XCTAssertEqualObjects(@"https://bnc.lt/a", [cache objectForKey:[self linkDataWithChannel:@"a"]]);
+    XCTAssertNil([cache objectForKey:[self linkDataWithChannel:@"b"]]);
+    XCTAssertEqual(1, cache.hitCount);
+    XCTAssertEqual(1, cache.missCount);
+    XCTAssertEqualWithAccuracy(0.5, cache.hitRate, 0.001);
+}
+
+- (void)testCountLimitEvictsLeastRecentlyUsed {
+    BNCLinkCache *cache = [BNCLinkCache new];
+    cache.countLimit = 2;
+
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+    [cache setObject:@"https://bnc.lt/b" forKey:[self linkDataWithChannel:@"b"]];
+
+    // touch a, so b is the least recently used
+    XCTAssertNotNil([cache objectForKey:[self linkDataWithChannel:@"a"]]);
+    [cache setObject:@"https://bnc.lt/c" forKey:[self linkDataWithChannel:@"c"]];
+
+    XCTAssertEqual(2, cache.count);
+    XCTAssertNotNil([cache objectForKey:[self linkDataWithChannel:@"a"]]);
+    XCTAssertNil([cache objectForKey:[self linkDataWithChannel:@"b"]]);
+    XCTAssertNotNil([cache objectForKey:[self linkDataWithChannel:@"c"]]);
+}
+
+- (void)testByteLimit {
+    BNCLinkCache *cache = [BNCLinkCache new];
+    cache.totalBytesLimit = 128;
+
+    // each entry costs its URL and its link data JSON, 87 bytes
+    [cache setObject:@"https://bnc.lt/aaaaaaaaaaaaaaaaaaaa" forKey:[self linkDataWithChannel:@"a"]];
+    [cache setObject:@"https://bnc.lt/bbbbbbbbbbbbbbbbbbbb" forKey:[self linkDataWithChannel:@"b"]];
+
+    XCTAssertEqual(1, cache.count);
+    XCTAssertTrue(cache.totalBytes <= 128);
+    XCTAssertNotNil([cache objectForKey:[self linkDataWithChannel:@"b"]]);
+}
+
+- (void)testExpiredEntriesAreMisses {
+    BNCLinkCache *cache = [BNCLinkCache new];
+    cache.timeToLive = -1;
+
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+    XCTAssertNil([cache objectForKey:[self linkDataWithChannel:@"a"]]);
+    XCTAssertEqual(0, cache.count);
+}
+
+- (void)testPersistsAcrossInstances {
+    BNCLinkCache *cache = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+    [cache updateContextWithBranchKey:@"key_live_foo" userUrl:@"https://bnc.lt/user"];
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+    [cache synchronize];
+
+    BNCLinkCache *reloaded = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+    [reloaded updateContextWithBranchKey:@"key_live_foo" userUrl:@"https://bnc.lt/user"];
+    XCTAssertEqualObjects(@"https://bnc.lt/a", [reloaded objectForKey:[self linkDataWithChannel:@"a"]]);
+}
+
+- (void)testPersistedEntriesKeyedByLinkData {
+    BNCLinkCache *cache = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+    [cache setObject:@"https://bnc.lt/b" forKey:[self linkDataWithChannel:@"b"]];
+    [cache synchronize];
+
+    // the file holds the link data itself, not a per process hash
+    NSDictionary *file = [NSDictionary dictionaryWithContentsOfURL:self.storageURL];
+    NSArray *records = file[@"e"];
+    XCTAssertEqual(2, records.count);
+    XCTAssertEqualObjects([[self linkDataWithChannel:@"a"] canonicalJSONString], records.firstObject[0]);
+
+    BNCLinkCache *reloaded = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+    XCTAssertEqualObjects(@"https://bnc.lt/b", [reloaded objectForKey:[self linkDataWithChannel:@"b"]]);
+    XCTAssertEqualObjects(@"https://bnc.lt/a", [reloaded objectForKey:[self linkDataWithChannel:@"a"]]);
+    XCTAssertNil([reloaded objectForKey:[self linkDataWithChannel:@"c"]]);
+}
+
+- (void)testPersistedEntriesDroppedForNewBranchKey {
+    BNCLinkCache *cache = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+    [cache updateContextWithBranchKey:@"key_live_foo" userUrl:nil];
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+    [cache synchronize];
+
+    BNCLinkCache *reloaded = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+    [reloaded updateContextWithBranchKey:@"key_live_bar" userUrl:nil];
+    XCTAssertNil([reloaded objectForKey:[self linkDataWithChannel:@"a"]]);
+}
+
+- (void)testUserUrlChangeClearsCache {
+    BNCLinkCache *cache = [BNCLinkCache new];
+    [cache updateContextWithBranchKey:@"key_live_foo" userUrl:@"https://bnc.lt/one"];
+    [cache setObject:@"https://bnc.lt/a" forKey:[self linkDataWithChannel:@"a"]];
+
+    [cache updateContextWithBranchKey:@"key_live_foo" userUrl:@"https://bnc.lt/one"];
+    XCTAssertEqual(1, cache.count);
+
+    [cache updateContextWithBranchKey:@"key_live_foo" userUrl:@"https://bnc.lt/two"];
+    XCTAssertEqual(0, cache.count);
+}
+
+@end
@@ -100,4 +100,25 @@
     XCTAssertNotEqual([a hash], [b hash]);
 }
 
+// the digest keys persisted caches, so it must not depend on the process or on insertion order
+- (void)testDigestIsStable {
+    BNCLinkData *a = [[BNCLinkData alloc] init];
+    [a setupChannel:@"a"];
+    [a setupParams:@{ @"key": @"value" }];
+
+    BNCLinkData *b = [[BNCLinkData alloc] init];
+    [b setupParams:@{ @"key": @"value" }];
+    [b setupChannel:@"a"];
+
+    XCTAssertEqualObjects(@"{\"channel\":\"a\",\"data\":{\"key\":\"value\"},\"source\":\"ios\"}", [a canonicalJSONString]);
+    XCTAssertEqualObjects(@"03d63efa129167480e6fdb52642bf61734347789f943a6745dfbb766d964c288", [a digest]);
+    XCTAssertEqualObjects([a digest], [b digest]);
+}
+
+- (void)testDigestWithoutJSON {
+    BNCLinkData *a = [[BNCLinkData alloc] init];
+    [a setupParams:@{ @"date": [NSDate date] }];
+    XCTAssertNil([a digest]);
+}
+
 @end
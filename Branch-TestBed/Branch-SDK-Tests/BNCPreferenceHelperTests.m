@@ -17,6 +17,9 @@
 // expose private methods for testing
 - (NSMutableDictionary *)deserializePrefDictFromData:(NSData *)data;
 - (NSData *)serializePrefDict:(NSMutableDictionary *)dict;
+- (void)setUseStorage:(BOOL)useStorage;
+- (NSUInteger)persistCount;
+- (NSUInteger)bytesWritten;
 
 @end
 
@@ -436,5 +439,183 @@
                    @"Third party APIs timeout should support small values");
 }
 
+// Roughly the preference writes made by one open response
+- (void)writeOpenResponsePrefs:(BNCPreferenceHelper *)prefs {
+    prefs.randomizedDeviceToken = @"device-token";
+    prefs.userUrl = @"https://bnc.lt/user";
+    prefs.userIdentity = nil;
+    prefs.sessionID = [NSUUID UUID].UUIDString;
+    prefs.previousAppBuildDate = [NSDate date];
+    prefs.sessionParams = @"{\"+clicked_branch_link\":false}";
+    prefs.linkClickIdentifier = nil;
+    prefs.spotlightIdentifier = nil;
+    prefs.universalLinkUrl = nil;
+    prefs.externalIntentURI = nil;
+    prefs.referringURL = nil;
+    prefs.initialReferrer = nil;
+    prefs.dropURLOpen = NO;
+    prefs.uxType = nil;
+    prefs.randomizedBundleToken = @"bundle-token";
+}
+
+- (void)testWritesAreCoalesced {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+
+    [self writeOpenResponsePrefs:prefs];
+    XCTAssertEqual(0, prefs.persistCount);
+
+    [prefs synchronize];
+    XCTAssertEqual(1, prefs.persistCount);
+    XCTAssertGreaterThan(prefs.bytesWritten, 0);
+
+    // nothing changed, nothing to write
+    [prefs synchronize];
+    XCTAssertEqual(1, prefs.persistCount);
+}
+
+- (void)testBatchUpdatesAreFlushedTogether {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+
+    NSString *sessionID = [NSUUID UUID].UUIDString;
+    [prefs performBatchUpdates:^{
+        [self writeOpenResponsePrefs:prefs];
+        [prefs performBatchUpdates:^{
+            prefs.sessionID = sessionID;
+        }];
+        XCTAssertEqual(0, prefs.persistCount);
+    }];
+    XCTAssertEqual(1, prefs.persistCount);
+    XCTAssertEqualObjects(sessionID, prefs.sessionID);
+
+    // nothing left for the scheduled flush
+    [prefs synchronize];
+    XCTAssertEqual(1, prefs.persistCount);
+}
+
+- (void)testWritesAreFlushedAfterPersistWindow {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+    prefs.sessionID = [NSUUID UUID].UUIDString;
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"flushed"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.0 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        XCTAssertEqual(1, prefs.persistCount);
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void)testOpenResponsePersistencePerformance {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+
+    [self measureBlock:^{
+        [self writeOpenResponsePrefs:prefs];
+        [prefs synchronize];
+    }];
+}
+
+- (void)testReadsSeeLatestWrite {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    prefs.sessionParams = @"{\"a\":1}";
+    XCTAssertEqualObjects(@"{\"a\":1}", prefs.sessionParams);
+    prefs.sessionParams = nil;
+    XCTAssertNil(prefs.sessionParams);
+
+    XCTAssertNil(prefs.instrumentationParameters);
+    [prefs addInstrumentationDictionaryKey:@"key" value:@"value"];
+    XCTAssertEqualObjects(@{ @"key": @"value" }, prefs.instrumentationParameters);
+    [prefs clearInstrumentationDictionary];
+    XCTAssertNil(prefs.instrumentationParameters);
+}
+
+- (void)testRoundTripTimeSummaries {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs addRoundTripTime:120 forEndpoint:@"/v1/open"];
+    [prefs addRoundTripTime:40 forEndpoint:@"/v2/event/standard"];
+    [prefs addRoundTripTime:60 forEndpoint:@"/v2/event/standard"];
+
+    NSDictionary *parameters = [prefs takeInstrumentationParameters];
+    XCTAssertEqualObjects(@"120", parameters[@"/v1/open-brtt"]);
+    XCTAssertEqualObjects(@"60", parameters[@"/v2/event/standard-brtt"]);
+    NSDictionary *summary = parameters[@"/v2/event/standard-brtt-summary"];
+    XCTAssertEqualObjects(@2, summary[@"count"]);
+    XCTAssertEqualObjects(@40, summary[@"min"]);
+    XCTAssertEqualObjects(@60, summary[@"max"]);
+
+    // each round trip is sent once
+    XCTAssertNil([prefs takeInstrumentationParameters]);
+}
+
+- (void)testConcurrentReadsDuringWrites {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    NSArray<NSString *> *values = @[ @"{\"a\":1}", @"{\"b\":2}" ];
+    prefs.sessionParams = values[0];
+
+    dispatch_queue_t writer = dispatch_queue_create("io.branch.test.writer", DISPATCH_QUEUE_SERIAL);
+    dispatch_async(writer, ^{
+        for (int i = 0; i < 1000; i++) {
+            prefs.sessionParams = values[i % 2];
+            prefs.trackingDisabled = NO;
+        }
+    });
+
+    // readers always see a whole value
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t reader) {
+        for (int i = 0; i < 5000; i++) {
+            XCTAssertTrue([values containsObject:prefs.sessionParams]);
+            XCTAssertFalse(prefs.trackingDisabled);
+        }
+    });
+    dispatch_sync(writer, ^{});
+}
+
+- (void)testPreloadedPreferences {
+    BNCPreferenceHelper *writer = [BNCPreferenceHelper new];
+    [writer setUseStorage:YES];
+    NSString *sessionID = [NSUUID UUID].UUIDString;
+    writer.sessionID = sessionID;
+    [writer synchronize];
+
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+    [prefs preloadPersistenceDict];
+    XCTAssertEqualObjects(sessionID, prefs.sessionID);
+    XCTAssertGreaterThanOrEqual(prefs.loadBlockedTime, 0);
+
+    // a second preload after the load is a no-op
+    [prefs preloadPersistenceDict];
+    XCTAssertEqualObjects(sessionID, prefs.sessionID);
+}
+
+- (void)testReadContentionPerformance {
+    BNCPreferenceHelper *prefs = [BNCPreferenceHelper new];
+    [prefs setUseStorage:YES];
+    [self writeOpenResponsePrefs:prefs];
+
+    // event logging reads these per request while the open response is written
+    [self measureBlock:^{
+        dispatch_group_t group = dispatch_group_create();
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            for (int i = 0; i < 20; i++) {
+                [self writeOpenResponsePrefs:prefs];
+                [prefs addInstrumentationDictionaryKey:@"/v2/event/standard-qt" value:@"12"];
+            }
+            [prefs flush];
+        });
+        dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t reader) {
+            for (int i = 0; i < 10000; i++) {
+                (void)prefs.trackingDisabled;
+                (void)prefs.sessionParams;
+                (void)prefs.randomizedBundleToken;
+                (void)prefs.instrumentationParameters;
+            }
+        });
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    }];
+    [prefs synchronize];
+}
 
 @end
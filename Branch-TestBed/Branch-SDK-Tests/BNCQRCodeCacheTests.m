@@ -0,0 +1,184 @@
+//
+//  BNCQRCodeCacheTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCQRCodeCache.h"
+#import "BranchConstants.h"
+
+@interface BNCQRCodeCacheTests : XCTestCase
+@property (nonatomic, strong) NSURL *directoryURL;
+@end
+
+@implementation BNCQRCodeCacheTests
+
+- (void)setUp {
+    NSString *name = [NSString stringWithFormat:@"BNCQRCodeCacheTests-%@", [NSUUID UUID].UUIDString];
+    self.directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name] isDirectory:YES];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+}
+
+- (NSDictionary *)paramsWithChannel:(NSString *)channel {
+    return @{
+        BRANCH_REQUEST_KEY_URL_CHANNEL: channel,
+        BRANCH_REQUEST_KEY_REQUEST_CREATION_TIME_STAMP: @([NSDate date].timeIntervalSince1970 * 1000),
+        BRANCH_REQUEST_KEY_REQUEST_UUID: [NSUUID UUID].UUIDString,
+        @"qr_code_settings": @{ @"width": @300, @"margin": @1 },
+        @"data": @{ @"$canonical_identifier": @"item/12345", @"$creation_timestamp": @([NSDate date].timeIntervalSince1970) }
+    };
+}
+
+- (NSData *)imageOfLength:(NSUInteger)length {
+    return [NSMutableData dataWithLength:length];
+}
+
+- (void)testKeyIgnoresVolatileFields {
+    NSString *key = [BNCQRCodeCache cacheKeyForParams:[self paramsWithChannel:@"a"]];
+    XCTAssertNotNil(key);
+    XCTAssertEqualObjects(key, [BNCQRCodeCache cacheKeyForParams:[self paramsWithChannel:@"a"]]);
+    XCTAssertNotEqualObjects(key, [BNCQRCodeCache cacheKeyForParams:[self paramsWithChannel:@"b"]]);
+}
+
+- (void)testHoldsMultipleEntries {
+    BNCQRCodeCache *cache = [BNCQRCodeCache new];
+    NSData *a = [@"a" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *b = [@"b" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache addQRCodeToCache:a withParams:[self paramsWithChannel:@"a"]];
+    [cache addQRCodeToCache:b withParams:[self paramsWithChannel:@"b"]];
+
+    XCTAssertEqual(2, cache.count);
+    XCTAssertEqualObjects(a, [cache checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+    XCTAssertEqualObjects(b, [cache checkQRCodeCache:[self paramsWithChannel:@"b"]]);
+}
+
+- (void)testByteLimitEvictsLeastRecentlyUsed {
+    BNCQRCodeCache *cache = [BNCQRCodeCache new];
+    cache.memoryBytesLimit = 2048;
+
+    [cache addQRCodeToCache:[self imageOfLength:1000] withParams:[self paramsWithChannel:@"a"]];
+    [cache addQRCodeToCache:[self imageOfLength:1000] withParams:[self paramsWithChannel:@"b"]];
+
+    // touch a, so b is the least recently used
+    XCTAssertNotNil([cache checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+    [cache addQRCodeToCache:[self imageOfLength:1000] withParams:[self paramsWithChannel:@"c"]];
+
+    XCTAssertEqual(2, cache.count);
+    XCTAssertTrue(cache.memoryBytes <= 2048);
+    XCTAssertNotNil([cache checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+    XCTAssertNil([cache checkQRCodeCache:[self paramsWithChannel:@"b"]]);
+}
+
+- (void)testDiskTierSurvivesNewInstance {
+    BNCQRCodeCache *cache = [[BNCQRCodeCache alloc] initWithDirectoryURL:self.directoryURL];
+    NSData *a = [@"a" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache addQRCodeToCache:a withParams:[self paramsWithChannel:@"a"]];
+    [cache synchronize];
+
+    BNCQRCodeCache *reloaded = [[BNCQRCodeCache alloc] initWithDirectoryURL:self.directoryURL];
+    XCTAssertEqual(0, reloaded.count);
+    XCTAssertEqualObjects(a, [reloaded checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+    XCTAssertEqual(1, reloaded.count);
+}
+
+- (void)testExpiredEntriesAreMisses {
+    BNCQRCodeCache *cache = [[BNCQRCodeCache alloc] initWithDirectoryURL:self.directoryURL];
+    NSData *a = [@"a" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache addQRCodeToCache:a withParams:[self paramsWithChannel:@"a"]];
+    [cache synchronize];
+
+    // a new instance only has the disk tier, which expires by file creation date
+    BNCQRCodeCache *reloaded = [[BNCQRCodeCache alloc] initWithDirectoryURL:self.directoryURL];
+    reloaded.timeToLive = -1;
+    XCTAssertNil([reloaded checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+    [reloaded synchronize];
+
+    reloaded.timeToLive = 60;
+    XCTAssertNil([reloaded checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+
+    cache.timeToLive = -1;
+    [cache addQRCodeToCache:a withParams:[self paramsWithChannel:@"b"]];
+    XCTAssertNil([cache checkQRCodeCache:[self paramsWithChannel:@"b"]]);
+}
+
+- (void)testClearRemovesDiskTier {
+    BNCQRCodeCache *cache = [[BNCQRCodeCache alloc] initWithDirectoryURL:self.directoryURL];
+    [cache addQRCodeToCache:[@"a" dataUsingEncoding:NSUTF8StringEncoding] withParams:[self paramsWithChannel:@"a"]];
+    [cache synchronize];
+
+    [cache clear];
+    [cache synchronize];
+    BNCQRCodeCache *reloaded = [[BNCQRCodeCache alloc] initWithDirectoryURL:self.directoryURL];
+    XCTAssertNil([reloaded checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+}
+
+- (void)testConcurrentMissesShareOneFetch {
+    BNCQRCodeCache *cache = [BNCQRCodeCache new];
+    NSData *a = [@"a" dataUsingEncoding:NSUTF8StringEncoding];
+
+    __block BNCQRCodeCacheFetchCompletion pendingFetch = nil;
+    __block NSInteger completions = 0;
+    for (int i = 0; i < 3; i++) {
+        [cache qrCodeForParams:[self paramsWithChannel:@"a"] fetch:^(BNCQRCodeCacheFetchCompletion done) {
+            pendingFetch = done;
+        } completion:^(NSData *qrCode, NSError *error) {
+            XCTAssertEqualObjects(a, qrCode);
+            completions++;
+        }];
+    }
+    XCTAssertEqual(1, cache.fetchCount);
+    XCTAssertEqual(0, completions);
+
+    pendingFetch(a, nil, YES);
+    XCTAssertEqual(3, completions);
+
+    // now served from the cache
+    [cache qrCodeForParams:[self paramsWithChannel:@"a"] fetch:^(BNCQRCodeCacheFetchCompletion done) {
+        XCTFail(@"Unexpected fetch");
+    } completion:^(NSData *qrCode, NSError *error) {
+        completions++;
+    }];
+    XCTAssertEqual(4, completions);
+    XCTAssertEqual(1, cache.fetchCount);
+}
+
+- (void)testFailedFetchIsNotCached {
+    BNCQRCodeCache *cache = [BNCQRCodeCache new];
+    NSError *failure = [NSError errorWithDomain:@"test" code:1 userInfo:nil];
+
+    [cache qrCodeForParams:[self paramsWithChannel:@"a"] fetch:^(BNCQRCodeCacheFetchCompletion done) {
+        done(nil, failure, YES);
+    } completion:^(NSData *qrCode, NSError *error) {
+        XCTAssertNil(qrCode);
+        XCTAssertEqualObjects(failure, error);
+    }];
+    XCTAssertEqual(0, cache.count);
+    XCTAssertNil([cache checkQRCodeCache:[self paramsWithChannel:@"a"]]);
+}
+
+- (void)testUncacheableFetchIsDelivered {
+    BNCQRCodeCache *cache = [BNCQRCodeCache new];
+    NSData *a = [@"a" dataUsingEncoding:NSUTF8StringEncoding];
+
+    __block NSInteger completions = 0;
+    for (int i = 0; i < 2; i++) {
+        [cache qrCodeForParams:[self paramsWithChannel:@"a"] fetch:^(BNCQRCodeCacheFetchCompletion done) {
+            done(a, nil, NO);
+        } completion:^(NSData *qrCode, NSError *error) {
+            XCTAssertEqualObjects(a, qrCode);
+            completions++;
+        }];
+    }
+
+    // the second request fetched again
+    XCTAssertEqual(2, completions);
+    XCTAssertEqual(2, cache.fetchCount);
+    XCTAssertEqual(0, cache.count);
+}
+
+@end
@@ -0,0 +1,396 @@
+//
+//  BNCQREncoderHarness.c
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+// Host test and benchmark for BNCQREncoder. Not part of any Xcode target, build it with any C compiler:
+//
+//   cc -O2 -I Sources/BranchSDK/Private -o qrharness Sources/BranchSDK/BNCQREncoder.c Branch-TestBed/Branch-SDK-Tests/BNCQREncoderHarness.c
+//   ./qrharness --bench
+//
+// Every symbol is read back the way a scanner would: format and version information are checked
+// against their BCH codes, the data is unmasked and deinterleaved, each block's error correction is
+// recomputed and the byte mode payload must equal the input. Pass --bench to time encodes as well.
+
+#include "BNCQREncoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int failures = 0;
+
+#define CHECK(condition, ...) do { \
+    if (!(condition)) { \
+        failures++; \
+        fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+    } \
+} while (0)
+
+// MARK: - Reference tables, ISO/IEC 18004 table 9
+
+static const int eccCodewordsPerBlock[4][41] = {
+    {-1,  7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28, 28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26, 26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28},
+    {-1, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30, 28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28, 30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+};
+
+static const int numBlocks[4][41] = {
+    {-1, 1, 1, 1, 1, 1, 2, 2, 2, 2,  4,  4,  4,  4,  4,  6,  6,  6,  6,  7,  8,  8,  9,  9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25},
+    {-1, 1, 1, 1, 2, 2, 4, 4, 4, 5,  5,  5,  8,  9,  9, 10, 10, 11, 13, 14, 16, 17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49},
+    {-1, 1, 1, 2, 2, 4, 4, 6, 6, 8,  8,  8, 10, 12, 16, 12, 17, 16, 18, 21, 20, 23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68},
+    {-1, 1, 1, 2, 4, 4, 4, 5, 6, 8,  8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25, 25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81},
+};
+
+// Format information level indicator, indexed by BNCQRErrorCorrection
+static const int formatLevelBits[4] = { 1, 0, 3, 2 };
+
+// MARK: - Function modules
+
+static int alignmentPositions(int version, int *positions) {
+    if (version == 1) return 0;
+    int count = version / 7 + 2;
+    int step = (version * 8 + count * 3 + 5) / (count * 4 - 4) * 2;
+    positions[0] = 6;
+    for (int i = count - 1, position = 17 + version * 4 - 7; i >= 1; i--, position -= step) {
+        positions[i] = position;
+    }
+    return count;
+}
+
+static void markRect(uint8_t *map, int size, int x, int y, int width, int height) {
+    for (int dy = 0; dy < height; dy++) {
+        for (int dx = 0; dx < width; dx++) {
+            int mx = x + dx, my = y + dy;
+            if (mx >= 0 && mx < size && my >= 0 && my < size) map[my * size + mx] = 1;
+        }
+    }
+}
+
+// Modules that do not carry data: finders with separators, timing, alignment, format and version areas
+static uint8_t *functionMap(int version, int size) {
+    uint8_t *map = calloc((size_t)(size * size), 1);
+    markRect(map, size, 0, 0, 9, 9);
+    markRect(map, size, size - 8, 0, 8, 9);
+    markRect(map, size, 0, size - 8, 9, 8);
+    markRect(map, size, 6, 0, 1, size);
+    markRect(map, size, 0, 6, size, 1);
+
+    int positions[7];
+    int count = alignmentPositions(version, positions);
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+            if ((i == 0 && j == 0) || (i == 0 && j == count - 1) || (i == count - 1 && j == 0)) continue;
+            markRect(map, size, positions[i] - 2, positions[j] - 2, 5, 5);
+        }
+    }
+    if (version >= 7) {
+        markRect(map, size, size - 11, 0, 3, 6);
+        markRect(map, size, 0, size - 11, 6, 3);
+    }
+    return map;
+}
+
+static bool maskBit(int mask, int x, int y) {
+    switch (mask) {
+        case 0: return (x + y) % 2 == 0;
+        case 1: return y % 2 == 0;
+        case 2: return x % 3 == 0;
+        case 3: return (x + y) % 3 == 0;
+        case 4: return (x / 3 + y / 2) % 2 == 0;
+        case 5: return x * y % 2 + x * y % 3 == 0;
+        case 6: return (x * y % 2 + x * y % 3) % 2 == 0;
+        default: return ((x + y) % 2 + x * y % 3) % 2 == 0;
+    }
+}
+
+// MARK: - Reed-Solomon
+
+static uint8_t gfMultiply(uint8_t a, uint8_t b) {
+    int result = 0;
+    for (int i = 7; i >= 0; i--) {
+        result = (result << 1) ^ ((result >> 7) * 0x11D);
+        result ^= ((b >> i) & 1) * a;
+    }
+    return (uint8_t)result;
+}
+
+static void reedSolomonRemainder(const uint8_t *data, int length, int degree, uint8_t *remainder) {
+    uint8_t divisor[30] = {0};
+    if (degree < 1 || degree > 30) return;
+    divisor[degree - 1] = 1;
+    uint8_t root = 1;
+    for (int i = 0; i < degree; i++) {
+        for (int j = 0; j < degree; j++) {
+            divisor[j] = gfMultiply(divisor[j], root);
+            if (j + 1 < degree) divisor[j] ^= divisor[j + 1];
+        }
+        root = gfMultiply(root, 0x02);
+    }
+    memset(remainder, 0, (size_t)degree);
+    for (int i = 0; i < length; i++) {
+        uint8_t factor = data[i] ^ remainder[0];
+        memmove(remainder, remainder + 1, (size_t)(degree - 1));
+        remainder[degree - 1] = 0;
+        for (int j = 0; j < degree; j++) remainder[j] ^= gfMultiply(divisor[j], factor);
+    }
+}
+
+// MARK: - Reading a symbol back
+
+static int readFormatBits(const BNCQRCode *code, bool first) {
+    int bits = 0, size = code->size;
+    if (first) {
+        for (int i = 0; i <= 5; i++) bits |= BNCQRCodeGetModule(code, 8, i) << i;
+        bits |= BNCQRCodeGetModule(code, 8, 7) << 6;
+        bits |= BNCQRCodeGetModule(code, 8, 8) << 7;
+        bits |= BNCQRCodeGetModule(code, 7, 8) << 8;
+        for (int i = 9; i < 15; i++) bits |= BNCQRCodeGetModule(code, 14 - i, 8) << i;
+    } else {
+        for (int i = 0; i < 8; i++) bits |= BNCQRCodeGetModule(code, size - 1 - i, 8) << i;
+        for (int i = 8; i < 15; i++) bits |= BNCQRCodeGetModule(code, 8, size - 15 + i) << i;
+    }
+    return bits;
+}
+
+static int bchRemainder(int data, int dataBits, int generator, int generatorDegree) {
+    int value = data << generatorDegree;
+    for (int i = dataBits + generatorDegree - 1; i >= generatorDegree; i--) {
+        if ((value >> i) & 1) value ^= generator << (i - generatorDegree);
+    }
+    return value;
+}
+
+static void checkFormatAndVersion(const BNCQRCode *code, const char *label) {
+    int first = readFormatBits(code, true);
+    int second = readFormatBits(code, false);
+    CHECK(first == second, "%s: format copies differ %x %x", label, first, second);
+
+    int format = first ^ 0x5412;
+    int data = format >> 10;
+    CHECK((format & 0x3FF) == bchRemainder(data, 5, 0x537, 10), "%s: bad format BCH %x", label, first);
+    CHECK(data >> 3 == formatLevelBits[code->errorCorrection], "%s: format level %d", label, data >> 3);
+    CHECK((data & 7) == code->mask, "%s: format mask %d, expected %d", label, data & 7, code->mask);
+
+    if (code->version < 7) return;
+    int below = 0, right = 0;
+    for (int i = 0; i < 18; i++) {
+        int a = code->size - 11 + i % 3, b = i / 3;
+        below |= BNCQRCodeGetModule(code, b, a) << i;
+        right |= BNCQRCodeGetModule(code, a, b) << i;
+    }
+    CHECK(below == right, "%s: version copies differ", label);
+    CHECK(below >> 12 == code->version, "%s: version info %d", label, below >> 12);
+    CHECK((below & 0xFFF) == bchRemainder(code->version, 6, 0x1F25, 12), "%s: bad version BCH", label);
+}
+
+static void checkFinders(const BNCQRCode *code, const char *label) {
+    int corners[3][2] = { {0, 0}, {code->size - 7, 0}, {0, code->size - 7} };
+    for (int i = 0; i < 3; i++) {
+        for (int dy = -1; dy <= 7; dy++) {
+            for (int dx = -1; dx <= 7; dx++) {
+                int ring = abs(dx - 3) > abs(dy - 3) ? abs(dx - 3) : abs(dy - 3);
+                bool expected = ring != 2 && ring != 4;
+                CHECK(BNCQRCodeGetModule(code, corners[i][0] + dx, corners[i][1] + dy) == expected,
+                      "%s: finder %d at %d,%d", label, i, dx, dy);
+            }
+        }
+    }
+    for (int i = 8; i < code->size - 8; i++) {
+        CHECK(BNCQRCodeGetModule(code, i, 6) == (i % 2 == 0), "%s: timing row at %d", label, i);
+        CHECK(BNCQRCodeGetModule(code, 6, i) == (i % 2 == 0), "%s: timing column at %d", label, i);
+    }
+    CHECK(BNCQRCodeGetModule(code, 8, code->size - 8), "%s: dark module", label);
+}
+
+// Reads the codewords in placement order, checks each block and returns the data codewords in order
+static int readDataCodewords(const BNCQRCode *code, uint8_t *output, const char *label) {
+    int size = code->size, version = code->version, level = code->errorCorrection;
+    uint8_t *map = functionMap(version, size);
+    int rawModules = 0;
+    for (int i = 0; i < size * size; i++) rawModules += !map[i];
+    int rawCodewords = rawModules / 8;
+
+    uint8_t *raw = calloc((size_t)rawCodewords, 1);
+    int bit = 0;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) right = 5;
+        for (int vertical = 0; vertical < size; vertical++) {
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                bool upward = ((right + 1) & 2) == 0;
+                int y = upward ? size - 1 - vertical : vertical;
+                if (map[y * size + x] || bit >= rawCodewords * 8) continue;
+                bool dark = BNCQRCodeGetModule(code, x, y) ^ maskBit(code->mask, x, y);
+                raw[bit >> 3] |= dark << (7 - (bit & 7));
+                bit++;
+            }
+        }
+    }
+
+    int blocks = numBlocks[level][version];
+    int ecc = eccCodewordsPerBlock[level][version];
+    int shortBlocks = blocks - rawCodewords % blocks;
+    int shortLength = rawCodewords / blocks;
+    int dataTotal = 0;
+    uint8_t block[256], remainder[30];
+    for (int b = 0; b < blocks; b++) {
+        int dataLength = shortLength - ecc + (b >= shortBlocks);
+        int index = 0;
+        for (int i = 0; i < dataLength; i++) {
+            // short blocks lack the last data codeword, so later rows skip them
+            int position = i < shortLength - ecc ? i * blocks + b : i * blocks + b - shortBlocks;
+            block[index++] = raw[position];
+        }
+        int dataCodewords = (shortLength - ecc) * blocks + (blocks - shortBlocks);
+        for (int i = 0; i < ecc; i++) {
+            block[index++] = raw[dataCodewords + i * blocks + b];
+        }
+        reedSolomonRemainder(block, dataLength, ecc, remainder);
+        CHECK(memcmp(remainder, block + dataLength, (size_t)ecc) == 0, "%s: block %d error correction", label, b);
+
+        // deinterleaved data is not contiguous per block in the output, rebuild it in block order
+        memcpy(output + dataTotal, block, (size_t)dataLength);
+        dataTotal += dataLength;
+    }
+    free(raw);
+    free(map);
+    return dataTotal;
+}
+
+static int readBits(const uint8_t *codewords, int *position, int count) {
+    int value = 0;
+    for (int i = 0; i < count; i++, (*position)++) {
+        value = (value << 1) | ((codewords[*position >> 3] >> (7 - (*position & 7))) & 1);
+    }
+    return value;
+}
+
+static void checkPayload(const BNCQRCode *code, const uint8_t *data, size_t length, const char *label) {
+    uint8_t codewords[4096];
+    int count = readDataCodewords(code, codewords, label);
+
+    int countBits = code->version < 10 ? 8 : 16;
+    int position = 0;
+    CHECK(readBits(codewords, &position, 4) == 4, "%s: not byte mode", label);
+    int decodedLength = readBits(codewords, &position, countBits);
+    CHECK((size_t)decodedLength == length, "%s: length %d, expected %zu", label, decodedLength, length);
+    for (int i = 0; i < decodedLength && (size_t)i < length && position + 8 <= count * 8; i++) {
+        int byte = readBits(codewords, &position, 8);
+        if (byte != data[i]) {
+            CHECK(false, "%s: byte %d is %02x, expected %02x", label, i, byte, data[i]);
+            break;
+        }
+    }
+    if (position + 4 <= count * 8) CHECK(readBits(codewords, &position, 4) == 0, "%s: missing terminator", label);
+    position = (position + 7) & ~7;
+    for (int i = 0; position < count * 8; i++) {
+        int pad = readBits(codewords, &position, 8);
+        CHECK(pad == (i % 2 == 0 ? 0xEC : 0x11), "%s: pad codeword %d is %02x", label, i, pad);
+        if (pad != (i % 2 == 0 ? 0xEC : 0x11)) break;
+    }
+}
+
+static void checkCode(const uint8_t *data, size_t length, BNCQRErrorCorrection level, int mask) {
+    char label[64];
+    snprintf(label, sizeof(label), "length %zu level %d mask %d", length, level, mask);
+    BNCQRCode *code = BNCQRCodeCreate(data, length, level, mask);
+    CHECK(code != NULL, "%s: not encoded", label);
+    if (!code) return;
+
+    CHECK(code->size == 17 + 4 * code->version, "%s: size %d", label, code->size);
+    CHECK(code->errorCorrection >= level, "%s: level lowered", label);
+    CHECK(BNCQRCodeByteCapacity(code->version, code->errorCorrection) >= length, "%s: over capacity", label);
+    CHECK(code->version == 1 || BNCQRCodeByteCapacity(code->version - 1, level) < length, "%s: version %d too large", label, code->version);
+    if (code->errorCorrection < BNCQRErrorCorrectionHigh) {
+        CHECK(BNCQRCodeByteCapacity(code->version, code->errorCorrection + 1) < length, "%s: level not raised", label);
+    }
+    if (mask != BNCQRMaskAuto) CHECK(code->mask == mask, "%s: forced mask ignored", label);
+
+    checkFinders(code, label);
+    checkFormatAndVersion(code, label);
+    checkPayload(code, data, length, label);
+    BNCQRCodeRelease(code);
+}
+
+// MARK: - Tests
+
+static void testCapacities(void) {
+    CHECK(BNCQRCodeByteCapacity(1, BNCQRErrorCorrectionLow) == 17, "v1 L");
+    CHECK(BNCQRCodeByteCapacity(1, BNCQRErrorCorrectionHigh) == 7, "v1 H");
+    CHECK(BNCQRCodeByteCapacity(10, BNCQRErrorCorrectionMedium) == 213, "v10 M");
+    CHECK(BNCQRCodeByteCapacity(40, BNCQRErrorCorrectionLow) == 2953, "v40 L");
+    CHECK(BNCQRCodeByteCapacity(40, BNCQRErrorCorrectionHigh) == 1273, "v40 H");
+    CHECK(BNCQRCodeByteCapacity(0, BNCQRErrorCorrectionLow) == 0, "v0");
+    CHECK(BNCQRCodeByteCapacity(41, BNCQRErrorCorrectionLow) == 0, "v41");
+
+    uint8_t data[2954];
+    memset(data, 'a', sizeof(data));
+    CHECK(BNCQRCodeCreate(data, sizeof(data), BNCQRErrorCorrectionLow, BNCQRMaskAuto) == NULL, "too long");
+}
+
+static void testRoundTrips(void) {
+    const char *url = "https://example.app.link/aBcDeFgHiJk?channel=qr&feature=share";
+    for (int mask = 0; mask < 8; mask++) {
+        checkCode((const uint8_t *)url, strlen(url), BNCQRErrorCorrectionMedium, mask);
+    }
+
+    // every version at every level, at the boundary of each capacity
+    uint8_t data[2953];
+    srand(18004);
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)rand();
+    for (int level = BNCQRErrorCorrectionLow; level <= BNCQRErrorCorrectionHigh; level++) {
+        for (int version = BNCQRVersionMin; version <= BNCQRVersionMax; version++) {
+            size_t capacity = BNCQRCodeByteCapacity(version, level);
+            checkCode(data, capacity, level, BNCQRMaskAuto);
+            if (version < BNCQRVersionMax) checkCode(data, capacity + 1, level, version % 8);
+        }
+    }
+    checkCode(data, 0, BNCQRErrorCorrectionLow, BNCQRMaskAuto);
+}
+
+// MARK: - Benchmark
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static void benchmark(const char *label, size_t length, BNCQRErrorCorrection level) {
+    uint8_t *data = malloc(length);
+    for (size_t i = 0; i < length; i++) data[i] = (uint8_t)('a' + i % 26);
+
+    int iterations = 0;
+    double start = now(), elapsed = 0;
+    while (elapsed < 0.5) {
+        BNCQRCodeRelease(BNCQRCodeCreate(data, length, level, BNCQRMaskAuto));
+        iterations++;
+        elapsed = now() - start;
+    }
+    printf("%-28s %8.3f ms per encode\n", label, elapsed * 1000 / iterations);
+    free(data);
+}
+
+int main(int argc, char **argv) {
+    testCapacities();
+    testRoundTrips();
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        benchmark("short link, H", 64, BNCQRErrorCorrectionHigh);
+        benchmark("long link, M", 600, BNCQRErrorCorrectionMedium);
+        benchmark("version 40, L", 2953, BNCQRErrorCorrectionLow);
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+//
+//  BNCQREncoderTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCQREncoder.h"
+#import "BNCQRCodeGenerator.h"
+
+@interface BNCQREncoderTests : XCTestCase
+@end
+
+@implementation BNCQREncoderTests
+
+- (BNCQRCode *)createCodeForString:(NSString *)string errorCorrection:(BNCQRErrorCorrection)errorCorrection mask:(int)mask {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    return BNCQRCodeCreate(data.bytes, data.length, errorCorrection, mask);
+}
+
+- (NSData *)payloadOfLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    memset(data.mutableBytes, 'a', length);
+    return data;
+}
+
+- (void)testByteCapacity {
+    // ISO/IEC 18004 byte mode capacities
+    XCTAssertEqual(17, BNCQRCodeByteCapacity(1, BNCQRErrorCorrectionLow));
+    XCTAssertEqual(14, BNCQRCodeByteCapacity(1, BNCQRErrorCorrectionMedium));
+    XCTAssertEqual(11, BNCQRCodeByteCapacity(1, BNCQRErrorCorrectionQuartile));
+    XCTAssertEqual(7, BNCQRCodeByteCapacity(1, BNCQRErrorCorrectionHigh));
+    XCTAssertEqual(213, BNCQRCodeByteCapacity(10, BNCQRErrorCorrectionMedium));
+    XCTAssertEqual(382, BNCQRCodeByteCapacity(20, BNCQRErrorCorrectionHigh));
+    XCTAssertEqual(2953, BNCQRCodeByteCapacity(40, BNCQRErrorCorrectionLow));
+    XCTAssertEqual(1273, BNCQRCodeByteCapacity(40, BNCQRErrorCorrectionHigh));
+    XCTAssertEqual(0, BNCQRCodeByteCapacity(41, BNCQRErrorCorrectionLow));
+}
+
+- (void)testSmallestVersionIsUsed {
+    NSData *data = [self payloadOfLength:14];
+    BNCQRCode *code = BNCQRCodeCreate(data.bytes, data.length, BNCQRErrorCorrectionMedium, BNCQRMaskAuto);
+    XCTAssertEqual(1, code->version);
+    XCTAssertEqual(21, code->size);
+    BNCQRCodeRelease(code);
+
+    data = [self payloadOfLength:15];
+    code = BNCQRCodeCreate(data.bytes, data.length, BNCQRErrorCorrectionMedium, BNCQRMaskAuto);
+    XCTAssertEqual(2, code->version);
+    XCTAssertEqual(25, code->size);
+    BNCQRCodeRelease(code);
+}
+
+- (void)testErrorCorrectionIsRaisedWhenItFits {
+    NSData *data = [self payloadOfLength:7];
+    BNCQRCode *code = BNCQRCodeCreate(data.bytes, data.length, BNCQRErrorCorrectionLow, BNCQRMaskAuto);
+    XCTAssertEqual(1, code->version);
+    XCTAssertEqual(BNCQRErrorCorrectionHigh, code->errorCorrection);
+    BNCQRCodeRelease(code);
+}
+
+- (void)testPayloadTooLong {
+    NSData *data = [self payloadOfLength:2954];
+    XCTAssertTrue(BNCQRCodeCreate(data.bytes, data.length, BNCQRErrorCorrectionLow, BNCQRMaskAuto) == NULL);
+}
+
+- (void)testFunctionPatterns {
+    BNCQRCode *code = [self createCodeForString:@"https://bnc.lt/test" errorCorrection:BNCQRErrorCorrectionMedium mask:BNCQRMaskAuto];
+    XCTAssertTrue(code != NULL);
+
+    // finder patterns in three corners: dark ring, light ring, dark center
+    int corners[3][2] = { {0, 0}, {code->size - 7, 0}, {0, code->size - 7} };
+    for (int i = 0; i < 3; i++) {
+        int x = corners[i][0], y = corners[i][1];
+        XCTAssertTrue(BNCQRCodeGetModule(code, x, y));
+        XCTAssertTrue(BNCQRCodeGetModule(code, x + 6, y + 6));
+        XCTAssertFalse(BNCQRCodeGetModule(code, x + 1, y + 1));
+        XCTAssertTrue(BNCQRCodeGetModule(code, x + 3, y + 3));
+    }
+
+    // timing patterns and the dark module
+    for (int i = 8; i < code->size - 8; i++) {
+        XCTAssertEqual(i % 2 == 0, BNCQRCodeGetModule(code, i, 6));
+        XCTAssertEqual(i % 2 == 0, BNCQRCodeGetModule(code, 6, i));
+    }
+    XCTAssertTrue(BNCQRCodeGetModule(code, 8, code->size - 8));
+    BNCQRCodeRelease(code);
+}
+
+- (void)testFormatBits {
+    // Medium error correction with mask 0 is 101010000010010, read from the copy split between the other two finders
+    BNCQRCode *code = [self createCodeForString:@"01234567890123" errorCorrection:BNCQRErrorCorrectionMedium mask:0];
+    XCTAssertEqual(BNCQRErrorCorrectionMedium, code->errorCorrection);
+    XCTAssertEqual(0, code->mask);
+
+    int bits = 0;
+    for (int i = 0; i < 8; i++) {
+        bits |= BNCQRCodeGetModule(code, code->size - 1 - i, 8) << i;
+    }
+    for (int i = 8; i < 15; i++) {
+        bits |= BNCQRCodeGetModule(code, 8, code->size - 15 + i) << i;
+    }
+    XCTAssertEqual(0b101010000010010, bits);
+    BNCQRCodeRelease(code);
+}
+
+- (void)testMaskIsDeterministic {
+    BNCQRCode *a = [self createCodeForString:@"https://bnc.lt/test" errorCorrection:BNCQRErrorCorrectionMedium mask:BNCQRMaskAuto];
+    BNCQRCode *b = [self createCodeForString:@"https://bnc.lt/test" errorCorrection:BNCQRErrorCorrectionMedium mask:a->mask];
+    XCTAssertEqual(a->size, b->size);
+    XCTAssertEqual(0, memcmp(a->modules, b->modules, (size_t)(a->size * a->size)));
+    BNCQRCodeRelease(a);
+    BNCQRCodeRelease(b);
+}
+
+- (void)testGeneratorImageSize {
+    BNCQRCodeGenerator *generator = [BNCQRCodeGenerator new];
+    generator.width = 512;
+    generator.margin = 10;
+    generator.codeColor = [UIColor blueColor];
+
+    NSData *data = [generator imageDataForString:@"https://bnc.lt/test"];
+    UIImage *image = [UIImage imageWithData:data];
+    XCTAssertNotNil(image);
+    XCTAssertEqual(512, image.size.width * image.scale);
+    XCTAssertEqual(512, image.size.height * image.scale);
+}
+
+- (void)testGeneratorFallsBackForPatternColors {
+    BNCQRCodeGenerator *generator = [BNCQRCodeGenerator new];
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(2, 2)];
+    UIImage *pattern = [renderer imageWithActions:^(UIGraphicsImageRendererContext * _Nonnull context) {
+        [[UIColor redColor] setFill];
+        [context fillRect:CGRectMake(0, 0, 1, 1)];
+    }];
+    generator.backgroundColor = [UIColor colorWithPatternImage:pattern];
+
+    XCTAssertFalse([generator supportsStyle]);
+    XCTAssertNil([generator imageDataForString:@"https://bnc.lt/test"]);
+}
+
+- (void)testEncodePerformance {
+    NSData *data = [@"https://example.app.link/aBcDeFgHiJk?channel=qr&feature=share" dataUsingEncoding:NSUTF8StringEncoding];
+    [self measureBlock:^{
+        for (int i = 0; i < 100; i++) {
+            BNCQRCodeRelease(BNCQRCodeCreate(data.bytes, data.length, BNCQRErrorCorrectionHigh, BNCQRMaskAuto));
+        }
+    }];
+}
+
+@end
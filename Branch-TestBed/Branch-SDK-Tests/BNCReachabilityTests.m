@@ -8,6 +8,7 @@
 
 #import <XCTest/XCTest.h>
 #import "BNCReachability.h"
+#import "BNCNetworkInterface.h"
 
 @interface BNCReachabilityTests : XCTestCase
 @property (nonatomic, strong, readwrite) BNCReachability *reachability;
@@ -29,6 +30,28 @@
     XCTAssert([@"wifi" isEqualToString:status]);
 }
 
+- (void)testCachedLocalIPAddress {
+    XCTAssertEqualObjects([BNCNetworkInterface localIPAddress], [self.reachability localIPAddress]);
+}
+
+// Cost of the lookups request building used to make, compare with testCachedLookupPerformance
+- (void)testUncachedLookupPerformance {
+    [self measureBlock:^{
+        for (int i = 0; i < 1000; i++) {
+            (void)[BNCNetworkInterface localIPAddress];
+        }
+    }];
+}
+
+- (void)testCachedLookupPerformance {
+    [self measureBlock:^{
+        for (int i = 0; i < 1000; i++) {
+            (void)[self.reachability localIPAddress];
+            (void)[self.reachability reachabilityStatus];
+        }
+    }];
+}
+
 // Only works on a device with cell
 //- (void)testDevice_Cell {
 //    NSString *status = [self.reachability reachabilityStatus];
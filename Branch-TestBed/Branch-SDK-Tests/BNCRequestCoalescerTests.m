@@ -0,0 +1,139 @@
+//
+//  BNCRequestCoalescerTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCRequestCoalescer.h"
+
+@interface BNCRequestCoalescerTests : XCTestCase
+@end
+
+@implementation BNCRequestCoalescerTests
+
+- (void)testIdenticalRequestsShareOneCall {
+    BNCRequestCoalescer *coalescer = [BNCRequestCoalescer new];
+    __block NSUInteger workCount = 0;
+    __block BNCRequestCoalescerCompletion pendingFinish = nil;
+    NSMutableArray *results = [NSMutableArray new];
+
+    for (int i = 0; i < 3; i++) {
+        [coalescer performForKey:@"link" work:^(BNCRequestCoalescerCompletion finish) {
+            workCount++;
+            pendingFinish = finish;
+        } completion:^(id result, NSError *error) {
+            [results addObject:result];
+        }];
+    }
+    XCTAssertEqual(1, workCount);
+    XCTAssertEqual(1, coalescer.inFlightCount);
+    XCTAssertEqual(2, coalescer.coalescedCount);
+
+    pendingFinish(@"https://bnc.lt/a", nil);
+    NSArray *expected = @[ @"https://bnc.lt/a", @"https://bnc.lt/a", @"https://bnc.lt/a" ];
+    XCTAssertEqualObjects(expected, results);
+    XCTAssertEqual(0, coalescer.inFlightCount);
+
+    // a finished flight is not reused
+    [coalescer performForKey:@"link" work:^(BNCRequestCoalescerCompletion finish) {
+        workCount++;
+        finish(nil, nil);
+    } completion:nil];
+    XCTAssertEqual(2, workCount);
+}
+
+- (void)testDifferentKeysAreNotCoalesced {
+    BNCRequestCoalescer *coalescer = [BNCRequestCoalescer new];
+    __block NSUInteger workCount = 0;
+    [coalescer performForKey:@"a" work:^(BNCRequestCoalescerCompletion finish) { workCount++; } completion:nil];
+    [coalescer performForKey:@"b" work:^(BNCRequestCoalescerCompletion finish) { workCount++; } completion:nil];
+    XCTAssertEqual(2, workCount);
+    XCTAssertEqual(2, coalescer.inFlightCount);
+    XCTAssertEqual(0, coalescer.coalescedCount);
+}
+
+- (void)testErrorIsDeliveredToEveryCaller {
+    BNCRequestCoalescer *coalescer = [BNCRequestCoalescer new];
+    __block BNCRequestCoalescerCompletion pendingFinish = nil;
+    __block NSUInteger errorCount = 0;
+    for (int i = 0; i < 2; i++) {
+        [coalescer performForKey:@"link" work:^(BNCRequestCoalescerCompletion finish) {
+            pendingFinish = finish;
+        } completion:^(id result, NSError *error) {
+            if (error) errorCount++;
+        }];
+    }
+    pendingFinish(nil, [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]);
+    XCTAssertEqual(2, errorCount);
+}
+
+- (void)testSynchronousCallersWaitForTheFirst {
+    BNCRequestCoalescer *coalescer = [BNCRequestCoalescer new];
+    __block NSUInteger workCount = 0;
+    dispatch_semaphore_t started = dispatch_semaphore_create(0);
+    dispatch_semaphore_t release = dispatch_semaphore_create(0);
+
+    XCTestExpectation *first = [self expectationWithDescription:@"first"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        id result = [coalescer performSynchronouslyForKey:@"link" work:^id {
+            @synchronized (self) { workCount++; }
+            dispatch_semaphore_signal(started);
+            dispatch_semaphore_wait(release, DISPATCH_TIME_FOREVER);
+            return @"https://bnc.lt/a";
+        }];
+        XCTAssertEqualObjects(@"https://bnc.lt/a", result);
+        [first fulfill];
+    });
+    dispatch_semaphore_wait(started, DISPATCH_TIME_FOREVER);
+
+    XCTestExpectation *second = [self expectationWithDescription:@"second"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        id result = [coalescer performSynchronouslyForKey:@"link" work:^id {
+            @synchronized (self) { workCount++; }
+            return @"https://bnc.lt/b";
+        }];
+        XCTAssertEqualObjects(@"https://bnc.lt/a", result);
+        [second fulfill];
+    });
+
+    // let the second caller attach before the first one finishes
+    while (coalescer.coalescedCount == 0) {
+        [NSThread sleepForTimeInterval:0.001];
+    }
+    dispatch_semaphore_signal(release);
+
+    [self waitForExpectations:@[first, second] timeout:5.0];
+    XCTAssertEqual(1, workCount);
+}
+
+- (void)testFailAllEndsEveryFlight {
+    BNCRequestCoalescer *coalescer = [BNCRequestCoalescer new];
+    __block BNCRequestCoalescerCompletion abandonedFinish = nil;
+    __block NSUInteger errorCount = 0;
+    for (NSString *key in @[ @"a", @"a", @"b" ]) {
+        [coalescer performForKey:key work:^(BNCRequestCoalescerCompletion finish) {
+            if (!abandonedFinish) abandonedFinish = finish;
+        } completion:^(id result, NSError *error) {
+            XCTAssertNil(result);
+            if (error) errorCount++;
+        }];
+    }
+
+    [coalescer failAllWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    XCTAssertEqual(3, errorCount);
+    XCTAssertEqual(0, coalescer.inFlightCount);
+
+    // the next request for the key runs, and the abandoned work finishing late changes nothing
+    __block NSUInteger workCount = 0;
+    [coalescer performForKey:@"a" work:^(BNCRequestCoalescerCompletion finish) {
+        workCount++;
+    } completion:nil];
+    abandonedFinish(@"https://bnc.lt/late", nil);
+    XCTAssertEqual(1, workCount);
+    XCTAssertEqual(1, coalescer.inFlightCount);
+    XCTAssertEqual(3, errorCount);
+}
+
+@end
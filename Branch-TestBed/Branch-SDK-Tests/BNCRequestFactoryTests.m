@@ -231,4 +231,15 @@
     XCTAssertTrue([self.requestUUID isEqualToString:[json objectForKey:BRANCH_REQUEST_KEY_REQUEST_UUID]]);
 }
 
+// The v2 user_data dictionary is built for every event
+- (void)testEventRequestPerformance {
+    BNCRequestFactory *factory = [[BNCRequestFactory alloc] initWithBranchKey:@"key_abcd" UUID:self.requestUUID TimeStamp:self.requestCreationTimeStamp];
+    [self measureBlock:^{
+        for (int i = 0; i < 1000; i++) {
+            NSMutableDictionary *event = [NSMutableDictionary dictionaryWithObject:@"PURCHASE" forKey:@"name"];
+            (void)[factory dataForEventWithEventDictionary:event];
+        }
+    }];
+}
+
 @end
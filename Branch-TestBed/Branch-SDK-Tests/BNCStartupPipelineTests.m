@@ -0,0 +1,96 @@
+//
+//  BNCStartupPipelineTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCStartupPipeline.h"
+
+@interface BNCStartupPipelineTests : XCTestCase
+@end
+
+@implementation BNCStartupPipelineTests
+
+- (void)testIndependentStagesRunConcurrently {
+    BNCStartupPipeline *pipeline = [BNCStartupPipeline new];
+    dispatch_semaphore_t first = dispatch_semaphore_create(0);
+    dispatch_semaphore_t second = dispatch_semaphore_create(0);
+
+    // each stage only completes once the other has started
+    __block BOOL firstSawSecond = NO;
+    __block BOOL secondSawFirst = NO;
+    [pipeline addStage:@"first" dependencies:nil work:^(dispatch_block_t complete) {
+        dispatch_semaphore_signal(first);
+        firstSawSecond = (dispatch_semaphore_wait(second, dispatch_time(DISPATCH_TIME_NOW, 2 * NSEC_PER_SEC)) == 0);
+        complete();
+    }];
+    [pipeline addStage:@"second" dependencies:nil work:^(dispatch_block_t complete) {
+        dispatch_semaphore_signal(second);
+        secondSawFirst = (dispatch_semaphore_wait(first, dispatch_time(DISPATCH_TIME_NOW, 2 * NSEC_PER_SEC)) == 0);
+        complete();
+    }];
+    [pipeline start];
+
+    XCTAssertTrue([pipeline waitForStages:@[ @"first", @"second" ] timeout:5.0]);
+    XCTAssertTrue(firstSawSecond);
+    XCTAssertTrue(secondSawFirst);
+}
+
+- (void)testDependenciesCompleteFirst {
+    BNCStartupPipeline *pipeline = [BNCStartupPipeline new];
+    NSMutableArray<NSString *> *order = [NSMutableArray new];
+
+    [pipeline addStage:@"load" dependencies:nil work:^(dispatch_block_t complete) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+            @synchronized (order) { [order addObject:@"load"]; }
+            complete();
+        });
+    }];
+    [pipeline addStage:@"parse" dependencies:@[ @"load" ] work:^(dispatch_block_t complete) {
+        @synchronized (order) { [order addObject:@"parse"]; }
+        complete();
+    }];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"notified"];
+    [pipeline notifyWhenStagesComplete:@[ @"parse", @"unknown" ] queue:dispatch_get_main_queue() block:^{
+        XCTAssertEqualObjects((@[ @"load", @"parse" ]), order);
+        [expectation fulfill];
+    }];
+    XCTAssertFalse([pipeline isStageComplete:@"parse"]);
+    XCTAssertTrue([pipeline isStageComplete:@"unknown"]);
+
+    [pipeline start];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertTrue([pipeline isStageComplete:@"load"]);
+}
+
+- (void)testStageAddedAfterStartRuns {
+    BNCStartupPipeline *pipeline = [BNCStartupPipeline new];
+    [pipeline start];
+    [pipeline addStage:@"late" dependencies:nil work:^(dispatch_block_t complete) {
+        complete();
+        complete();
+    }];
+    XCTAssertTrue([pipeline waitForStages:@[ @"late" ] timeout:5.0]);
+}
+
+- (void)testStageTimings {
+    BNCStartupPipeline *pipeline = [BNCStartupPipeline new];
+    [pipeline addStage:@"slow" dependencies:nil work:^(dispatch_block_t complete) {
+        [NSThread sleepForTimeInterval:0.05];
+        complete();
+    }];
+    [pipeline addStage:@"fast" dependencies:@[ @"slow" ] work:^(dispatch_block_t complete) {
+        complete();
+    }];
+    [pipeline start];
+    XCTAssertTrue([pipeline waitForStages:@[ @"fast" ] timeout:5.0]);
+
+    XCTAssertGreaterThanOrEqual(pipeline.stageTimings[@"slow"].doubleValue, 40.0);
+    XCTAssertLessThan(pipeline.stageTimings[@"fast"].doubleValue, pipeline.stageTimings[@"slow"].doubleValue);
+    XCTAssertGreaterThanOrEqual(pipeline.stageCompletionTimes[@"fast"].doubleValue, pipeline.stageCompletionTimes[@"slow"].doubleValue);
+}
+
+@end
@@ -0,0 +1,108 @@
+//
+//  BNCThirdPartySignalsTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCThirdPartySignals.h"
+#import "BNCPreferenceHelper.h"
+
+// Third party APIs with a fixed latency
+@interface BNCTestThirdPartySignals : BNCThirdPartySignals
+@property (atomic, assign) NSTimeInterval latency;
+@property (atomic, assign) NSInteger tokenLoads;
+@end
+
+@implementation BNCTestThirdPartySignals
+
+- (void)loadODMInfoWithCompletion:(void (^)(void))completion {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.latency * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), completion);
+}
+
+- (NSString *)loadAppleAttributionToken {
+    self.tokenLoads++;
+    [NSThread sleepForTimeInterval:self.latency];
+    return @"attribution-token";
+}
+
+@end
+
+@interface BNCThirdPartySignalsTests : XCTestCase
+@property (nonatomic, strong) BNCPreferenceHelper *preferenceHelper;
+@end
+
+@implementation BNCThirdPartySignalsTests
+
+- (void)setUp {
+    self.preferenceHelper = [BNCPreferenceHelper new];
+    self.preferenceHelper.thirdPartyAPIsWaitTime = 0.5;
+}
+
+- (void)testReadySignalsDoNotWait {
+    BNCTestThirdPartySignals *signals = [[BNCTestThirdPartySignals alloc] initWithPreferenceHelper:self.preferenceHelper];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"gathered"];
+    [signals gatherSignalsWithCompletion:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    NSDate *start = [NSDate date];
+    [signals waitForSignalsUntilDeadline];
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 0.1);
+    XCTAssertEqualObjects(@"attribution-token", signals.appleAttributionToken);
+
+    // a valid token is not loaded again
+    [signals gatherSignalsWithCompletion:nil];
+    XCTAssertEqual(1, signals.tokenLoads);
+}
+
+- (void)testDeadlineStartsWithGathering {
+    BNCTestThirdPartySignals *signals = [[BNCTestThirdPartySignals alloc] initWithPreferenceHelper:self.preferenceHelper];
+    signals.latency = 2.0;
+    [signals gatherSignalsWithCompletion:nil];
+    [NSThread sleepForTimeInterval:0.6];
+
+    // past the deadline, the request is built with what is ready
+    NSDate *start = [NSDate date];
+    [signals waitForSignalsUntilDeadline];
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 0.1);
+    XCTAssertNil(signals.appleAttributionToken);
+}
+
+- (void)testWaitWithoutGatheringIsBounded {
+    BNCTestThirdPartySignals *signals = [[BNCTestThirdPartySignals alloc] initWithPreferenceHelper:self.preferenceHelper];
+    signals.latency = 2.0;
+
+    NSDate *start = [NSDate date];
+    [signals waitForSignalsUntilDeadline];
+    NSTimeInterval waited = -[start timeIntervalSinceNow];
+    XCTAssertGreaterThanOrEqual(waited, 0.4);
+    XCTAssertLessThan(waited, 1.5);
+}
+
+- (void)testAttributionTokenExpires {
+    BNCTestThirdPartySignals *signals = [[BNCTestThirdPartySignals alloc] initWithPreferenceHelper:self.preferenceHelper];
+    [signals waitForSignalsUntilDeadline];
+    XCTAssertNotNil(signals.appleAttributionToken);
+
+    signals.attributionTokenValidityWindow = 0;
+    XCTAssertNil(signals.appleAttributionToken);
+
+    // an expired token is loaded again
+    [signals waitForSignalsUntilDeadline];
+    XCTAssertEqual(2, signals.tokenLoads);
+}
+
+- (void)testODMInfoValidityWindow {
+    BNCThirdPartySignals *signals = [[BNCThirdPartySignals alloc] initWithPreferenceHelper:self.preferenceHelper];
+    self.preferenceHelper.odmInfo = @"odm-info";
+    self.preferenceHelper.odmInfoInitDate = [NSDate date];
+    XCTAssertEqualObjects(@"odm-info", signals.odmInfo);
+
+    self.preferenceHelper.odmInfoInitDate = [NSDate dateWithTimeIntervalSinceNow:-(self.preferenceHelper.odmInfoValidityWindow + 1)];
+    XCTAssertNil(signals.odmInfo);
+}
+
+@end
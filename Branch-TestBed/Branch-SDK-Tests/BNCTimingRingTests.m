@@ -0,0 +1,146 @@
+//
+//  BNCTimingRingTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCTimingRing.h"
+
+static void BNCTimingRingTestsCollect(const BNCTimingSummary *summary, void *context) {
+    NSMutableArray *summaries = (__bridge NSMutableArray *)context;
+    [summaries addObject:[NSValue valueWithBytes:summary objCType:@encode(BNCTimingSummary)]];
+}
+
+@interface BNCTimingRingTests : XCTestCase
+@property (nonatomic, assign) BNCTimingRing *ring;
+@end
+
+@implementation BNCTimingRingTests
+
+- (void)setUp {
+    self.ring = BNCTimingRingCreate(100);
+}
+
+- (void)tearDown {
+    BNCTimingRingRelease(self.ring);
+}
+
+- (NSArray<NSValue *> *)summarizeConsuming:(BOOL)consume dropped:(uint64_t *)dropped {
+    NSMutableArray *summaries = [NSMutableArray new];
+    BNCTimingRingSummarize(self.ring, consume, BNCTimingRingTestsCollect, (__bridge void *)summaries, dropped);
+    return summaries;
+}
+
+- (BNCTimingSummary)summaryAtIndex:(NSUInteger)index of:(NSArray<NSValue *> *)summaries {
+    BNCTimingSummary summary;
+    [summaries[index] getValue:&summary];
+    return summary;
+}
+
+- (void)testPercentiles {
+    uint32_t open = BNCTimingRingEndpointID("/v1/open", 8);
+    for (uint32_t i = 1; i <= 100; i++) {
+        BNCTimingRingRecord(self.ring, open, 101 - i);
+    }
+
+    NSArray *summaries = [self summarizeConsuming:NO dropped:NULL];
+    XCTAssertEqual(1, summaries.count);
+    BNCTimingSummary summary = [self summaryAtIndex:0 of:summaries];
+    XCTAssertEqual(open, summary.endpoint);
+    XCTAssertEqual(100, summary.count);
+    XCTAssertEqual(1, summary.min);
+    XCTAssertEqual(50, summary.p50);
+    XCTAssertEqual(90, summary.p90);
+    XCTAssertEqual(99, summary.p99);
+    XCTAssertEqual(100, summary.max);
+    XCTAssertEqual(1, summary.last);
+}
+
+- (void)testSummaryPerEndpoint {
+    BNCTimingRingRecord(self.ring, BNCTimingRingEndpointID("/v1/open", 8), 120);
+    BNCTimingRingRecord(self.ring, BNCTimingRingEndpointID("/v2/event", 9), 40);
+    BNCTimingRingRecord(self.ring, BNCTimingRingEndpointID("/v2/event", 9), 60);
+
+    NSArray *summaries = [self summarizeConsuming:YES dropped:NULL];
+    XCTAssertEqual(2, summaries.count);
+    uint32_t counts = [self summaryAtIndex:0 of:summaries].count + [self summaryAtIndex:1 of:summaries].count;
+    XCTAssertEqual(3, counts);
+}
+
+- (void)testConsumedRecordsAreNotSummarizedAgain {
+    uint32_t open = BNCTimingRingEndpointID("/v1/open", 8);
+    BNCTimingRingRecord(self.ring, open, 10);
+    XCTAssertEqual(1, BNCTimingRingPendingCount(self.ring));
+
+    XCTAssertEqual(1, [self summarizeConsuming:NO dropped:NULL].count);
+    XCTAssertEqual(1, [self summarizeConsuming:YES dropped:NULL].count);
+    XCTAssertEqual(0, [self summarizeConsuming:YES dropped:NULL].count);
+    XCTAssertEqual(0, BNCTimingRingPendingCount(self.ring));
+
+    BNCTimingRingRecord(self.ring, open, 10);
+    BNCTimingRingReset(self.ring);
+    XCTAssertEqual(0, BNCTimingRingPendingCount(self.ring));
+}
+
+- (void)testOverwrittenRecordsAreCounted {
+    // capacity rounds up to 128
+    uint32_t open = BNCTimingRingEndpointID("/v1/open", 8);
+    for (uint32_t i = 0; i < 300; i++) {
+        BNCTimingRingRecord(self.ring, open, i);
+    }
+
+    uint64_t dropped = 0;
+    NSArray *summaries = [self summarizeConsuming:YES dropped:&dropped];
+    BNCTimingSummary summary = [self summaryAtIndex:0 of:summaries];
+    XCTAssertEqual(128, summary.count);
+    XCTAssertEqual(172, dropped);
+    XCTAssertEqual(172, summary.min);
+    XCTAssertEqual(299, summary.last);
+}
+
+- (void)testConcurrentWritersAndConsumers {
+    __block uint64_t summarized = 0;
+    __block uint64_t dropped = 0;
+    BNCTimingRing *ring = self.ring;
+
+    dispatch_apply(6, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        if (worker < 4) {
+            for (uint32_t i = 0; i < 20000; i++) {
+                BNCTimingRingRecord(ring, (uint32_t)worker, i);
+            }
+        } else {
+            for (int i = 0; i < 200; i++) {
+                uint64_t lost = 0;
+                size_t count = BNCTimingRingSummarize(ring, true, NULL, NULL, &lost);
+                @synchronized (self) {
+                    summarized += count;
+                    dropped += lost;
+                }
+            }
+        }
+    });
+
+    uint64_t lost = 0;
+    summarized += BNCTimingRingSummarize(ring, true, NULL, NULL, &lost);
+    dropped += lost;
+
+    // every record is either summarized once or counted as dropped
+    XCTAssertEqual(80000, summarized + dropped);
+}
+
+- (void)testRecordPerformance {
+    uint32_t open = BNCTimingRingEndpointID("/v1/open", 8);
+    BNCTimingRing *ring = self.ring;
+    [self measureBlock:^{
+        dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+            for (uint32_t i = 0; i < 10000; i++) {
+                BNCTimingRingRecord(ring, open, i);
+            }
+        });
+        BNCTimingRingSummarize(ring, true, NULL, NULL, NULL);
+    }];
+}
+
+@end
@@ -0,0 +1,123 @@
+//
+//  BNCTraceTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCTrace.h"
+
+@interface BNCTraceTests : XCTestCase
+@end
+
+@implementation BNCTraceTests
+
+- (void)tearDown {
+    BNCTraceStop();
+}
+
+- (NSArray<NSValue *> *)recordedEvents {
+    BNCTraceEvent events[64];
+    size_t count = BNCTraceCopyEvents(events, 64, NULL);
+    NSMutableArray<NSValue *> *array = [NSMutableArray new];
+    for (size_t i = 0; i < count; i++) {
+        [array addObject:[NSValue valueWithBytes:&events[i] objCType:@encode(BNCTraceEvent)]];
+    }
+    return array;
+}
+
+- (void)testDisabledRecordsNothing {
+    XCTAssertTrue(BNCTraceStart(16));
+    BNCTraceStop();
+    BNC_TRACE_BEGIN("ignored");
+    BNC_TRACE_END("ignored");
+    XCTAssertEqual(0, [self recordedEvents].count);
+}
+
+- (void)testSpansNest {
+    XCTAssertTrue(BNCTraceStart(16));
+    uint64_t identifier = BNCTraceNextIdentifier();
+    BNC_TRACE_ASYNC_BEGIN("async", identifier);
+    BNC_TRACE_BEGIN("outer");
+    BNC_TRACE_BEGIN("inner");
+    BNC_TRACE_END("inner");
+    BNC_TRACE_END("outer");
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"async end"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        BNC_TRACE_ASYNC_END("async", identifier);
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    BNCTraceStop();
+
+    // sync spans close in reverse order on one thread, within their parent
+    NSMutableArray<NSValue *> *stack = [NSMutableArray new];
+    uint64_t thread = 0;
+    uint64_t asyncBegin = 0, asyncEnd = 0;
+    for (NSValue *value in [self recordedEvents]) {
+        BNCTraceEvent event;
+        [value getValue:&event];
+        if (event.phase == BNCTracePhaseBegin) {
+            if (stack.count) XCTAssertEqual(thread, event.thread);
+            thread = event.thread;
+            [stack addObject:value];
+        } else if (event.phase == BNCTracePhaseEnd) {
+            BNCTraceEvent begin;
+            [stack.lastObject getValue:&begin];
+            [stack removeLastObject];
+            XCTAssertEqual(0, strcmp(begin.name, event.name));
+            XCTAssertEqual(begin.thread, event.thread);
+            XCTAssertLessThanOrEqual(begin.timestamp, event.timestamp);
+        } else if (event.phase == BNCTracePhaseAsyncBegin) {
+            XCTAssertEqual(identifier, event.identifier);
+            asyncBegin = event.timestamp;
+        } else if (event.phase == BNCTracePhaseAsyncEnd) {
+            XCTAssertEqual(identifier, event.identifier);
+            asyncEnd = event.timestamp;
+        }
+    }
+    XCTAssertEqual(0, stack.count);
+    XCTAssertGreaterThan(asyncBegin, 0);
+    XCTAssertLessThanOrEqual(asyncBegin, asyncEnd);
+}
+
+- (void)testFullBufferDropsEvents {
+    // the buffer is kept from the first start, so overflow whatever it holds
+    XCTAssertTrue(BNCTraceStart(16));
+    size_t recorded = 4 * BNCTraceDefaultCapacity;
+    for (size_t i = 0; i < recorded; i++) {
+        BNC_TRACE_INSTANT("instant");
+    }
+    BNCTraceStop();
+
+    BNCTraceEvent *events = calloc(recorded, sizeof(BNCTraceEvent));
+    uint64_t dropped = 0;
+    size_t count = BNCTraceCopyEvents(events, recorded, &dropped);
+    free(events);
+    XCTAssertGreaterThanOrEqual(count, 16);
+    XCTAssertGreaterThan(dropped, 0);
+    XCTAssertEqual(recorded, count + dropped);
+}
+
+- (void)testExportIsChromeTraceJSON {
+    XCTAssertTrue(BNCTraceStart(16));
+    BNC_TRACE_BEGIN("quoted \"name\"");
+    BNC_TRACE_END("quoted \"name\"");
+    BNCTraceStop();
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"BNCTraceTests.json"];
+    XCTAssertEqual(0, BNCTraceWriteJSON(path.fileSystemRepresentation));
+
+    NSData *data = [NSData dataWithContentsOfFile:path];
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    NSArray *events = trace[@"traceEvents"];
+    XCTAssertEqual(2, events.count);
+    XCTAssertEqualObjects(@"quoted \"name\"", events.firstObject[@"name"]);
+    XCTAssertEqualObjects(@"B", events.firstObject[@"ph"]);
+    XCTAssertEqualObjects(@"E", events.lastObject[@"ph"]);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+@end
@@ -10,6 +10,15 @@
 
 #import <XCTest/XCTest.h>
 #import "BNCURLFilter.h"
+#import "BNCURLPatternMatcher.h"
+#import "BNCPreferenceHelper.h"
+#import "BNCURLProtocolStub.h"
+
+@interface BNCURLFilter (Test)
+@property (strong, nonatomic) NSURL *cacheURL;
+@property (strong, nonatomic, readonly) NSArray<NSString *> *patternList;
++ (dispatch_queue_t)cacheQueue;
+@end
 
 @interface BNCURLFilterTests : XCTestCase
 @end
@@ -144,6 +153,85 @@
     XCTAssertTrue([filter shouldIgnoreURL:[NSURL URLWithString:@"branch123://"]]);
 }
 
+- (BNCURLFilter *)filterWithCacheURL:(NSURL *)cacheURL patternList:(NSArray<NSString *> *)patternList {
+    BNCURLFilter *filter = [BNCURLFilter new];
+    filter.cacheURL = cacheURL;
+    [filter useCustomPatternList:patternList];
+
+    // let the saved analysis load
+    dispatch_sync([BNCURLFilter cacheQueue], ^{ });
+    return filter;
+}
+
+- (void)testSavedPatternsReused {
+    NSURL *cacheURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    NSArray *patterns = @[@"^branch\\d+:"];
+
+    BNCURLFilter *filter = [self filterWithCacheURL:cacheURL patternList:patterns];
+    XCTAssertTrue([filter shouldIgnoreURL:[NSURL URLWithString:@"branch123://"]]);
+    dispatch_sync([BNCURLFilter cacheQueue], ^{ });
+
+    // swap in the analysis of another list, a filter that reuses the saved analysis matches that list
+    NSMutableDictionary *cache = [[NSDictionary dictionaryWithContentsOfURL:cacheURL] mutableCopy];
+    NSMutableDictionary *entry = [cache[@"custom"] mutableCopy];
+    XCTAssertNotNil(entry);
+    entry[@"matcher"] = [[[BNCURLPatternMatcher alloc] initWithPatterns:@[@"^fb\\d+:"]] dictionaryRepresentation];
+    cache[@"custom"] = entry;
+    XCTAssertTrue([cache writeToURL:cacheURL error:nil]);
+
+    BNCURLFilter *cachedFilter = [self filterWithCacheURL:cacheURL patternList:patterns];
+    XCTAssertTrue([cachedFilter shouldIgnoreURL:[NSURL URLWithString:@"fb123://"]]);
+
+    // a different list is analyzed again
+    BNCURLFilter *otherFilter = [self filterWithCacheURL:cacheURL patternList:@[@"^branch\\d+:", @"^other:"]];
+    XCTAssertFalse([otherFilter shouldIgnoreURL:[NSURL URLWithString:@"fb123://"]]);
+    XCTAssertTrue([otherFilter shouldIgnoreURL:[NSURL URLWithString:@"other://"]]);
+
+    dispatch_sync([BNCURLFilter cacheQueue], ^{ });
+    [[NSFileManager defaultManager] removeItemAtURL:cacheURL error:nil];
+}
+
+- (void)updateFilter:(BNCURLFilter *)filter {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"update finished"];
+    [filter updatePatternListFromServerWithCompletion:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5.0];
+}
+
+- (void)testUnusableListIsValidated {
+    BNCPreferenceHelper *preferenceHelper = [BNCPreferenceHelper sharedInstance];
+    NSString *savedTag = preferenceHelper.savedURLPatternListETag;
+    preferenceHelper.savedURLPatternListETag = nil;
+    [BNCURLProtocolStub start];
+
+    // a list this SDK can't parse, its tag is kept
+    NSData *body = [@"{\"uri_skip_list\":\"unsupported\",\"version\":0}" dataUsingEncoding:NSUTF8StringEncoding];
+    [BNCURLProtocolStub stubURLContaining:@"uriskiplist_v0.json" statusCode:200 headers:@{ @"ETag": @"\"v0-a\"" } body:body];
+    BNCURLFilter *filter = [BNCURLFilter new];
+    [self updateFilter:filter];
+    XCTAssertEqualObjects(@"\"v0-a\"", preferenceHelper.savedURLPatternListETag);
+    XCTAssertNil([BNCURLProtocolStub requests].firstObject.allHTTPHeaderFields[@"If-None-Match"]);
+
+    // the next request sends it, and the 304 leaves the list as it was
+    [BNCURLProtocolStub stubURLContaining:@"uriskiplist_v0.json" statusCode:304 headers:nil body:nil];
+    BNCURLFilter *nextFilter = [BNCURLFilter new];
+    NSArray *patternList = nextFilter.patternList;
+    [self updateFilter:nextFilter];
+    XCTAssertEqual(2, [BNCURLProtocolStub requests].count);
+    XCTAssertEqualObjects(@"\"v0-a\"", [BNCURLProtocolStub requests].lastObject.allHTTPHeaderFields[@"If-None-Match"]);
+    XCTAssertEqualObjects(patternList, nextFilter.patternList);
+    XCTAssertEqualObjects(@"\"v0-a\"", preferenceHelper.savedURLPatternListETag);
+
+    // once the version is gone the tag is dropped
+    [BNCURLProtocolStub stubURLContaining:@"uriskiplist_v0.json" statusCode:404 headers:@{ @"ETag": @"\"missing\"" } body:nil];
+    [self updateFilter:[BNCURLFilter new]];
+    XCTAssertNil(preferenceHelper.savedURLPatternListETag);
+
+    [BNCURLProtocolStub stop];
+    preferenceHelper.savedURLPatternListETag = savedTag;
+}
+
 // This is an end to end test and relies on a server call
 - (void)testUpdatePatternListFromServer {
     BNCURLFilter *filter = [BNCURLFilter new];
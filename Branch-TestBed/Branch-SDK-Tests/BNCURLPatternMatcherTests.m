@@ -0,0 +1,202 @@
+//
+//  BNCURLPatternMatcherTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BNCURLPatternMatcher.h"
+#import "BNCURLFilter.h"
+
+@interface BNCURLFilter (Test)
+@property (strong, nonatomic, readonly) NSArray<NSString *> *patternList;
+@end
+
+@interface BNCURLPatternMatcherTests : XCTestCase
+@end
+
+@implementation BNCURLPatternMatcherTests
+
+// Typical inbound URLs, mostly ones the default list does not ignore
+- (NSArray<NSString *> *)urlCorpus {
+    return @[
+        @"https://bnctestbed.app.link/cCeVhLHoqS",
+        @"https://bnctestbed.app.link/cCeVhLHoqS?%24fallback_url=https%3A%2F%2Fbranch.io",
+        @"https://bnctestbed-alternate.app.link/ZLBYEuLjw6",
+        @"https://bnctestbed.test-app.link/cCeVhLHoqS?_branch_match_id=1234567890",
+        @"https://www.example.com/products/1234?utm_source=email&utm_campaign=spring",
+        @"https://www.example.com/account/password/reset?token=abc",
+        @"http://example.com/oauth/callback?code=4%2F0AX4XfWh",
+        @"https://myapp.app.link/auth_token=fred",
+        @"https://myapp.app.link/OAUTH_TOKEN=fred",
+        @"HTTPS://myapp.app.link/access_token=fred",
+        @"branchtest://open?link_click_id=123456789012345678",
+        @"branchtest://product/42",
+        @"myscheme:path/to/resource?oauth=747474",
+        @"myscheme:oauth=747474",
+        @"MyScheme://Access/token",
+        @"shsh:oauth/login",
+        @"fb123456:login/464646",
+        @"fb12345://",
+        @"fb12345://campaign_ids",
+        @"fb1234567890://authorize/#access_token=abc&expires_in=5183999",
+        @"li12345://authorize?code=abc",
+        @"pdk123456://authorize?access_token=abc",
+        @"twitterkit-abcdef://callback?oauth_token=abc",
+        @"com.googleusercontent.apps.123456789-abcdefg:/oauth2callback?code=abc",
+        @"com.googleusercontent.apps.123456789-abcdefg://oauth2callback",
+        @"com.example.app://deeplink/path?query=1",
+        @"https://example.com/caf%C3%A9/menu",
+        @"https://example.com/café/menu",
+        @"mailto:someone@example.com",
+        @"tel:+15555555555",
+        @"http:oauth",
+        @"https",
+        @"x",
+    ];
+}
+
+// Patterns that stretch the analysis, each URL must give the same answer as the plain loop
+- (NSArray<NSString *> *)trickyPatterns {
+    return @[
+        @"oauth",                             // unanchored
+        @"^branchtest|^myscheme:.*token",     // top level alternation
+        @"^(?i)MYSCHEME:.*access",            // case insensitive prefix
+        @"^(?i)(HTTP|Https):.*reset",         // case insensitive schemes
+        @"^fb1?23",                           // optional literal
+        @"^tw*itter",                         // repeated literal
+        @"^li+12",                            // one or more
+        @"^com\\.example\\.app:\\/\\/deep",   // escaped punctuation
+        @"^(branchtest|myscheme):",           // required schemes
+        @"^((http|https):\\/\\/)?example",    // optional scheme group
+        @"^(?!(http|https):)tel:",            // excluded schemes then a prefix
+        @"^[a-z]+:\\/\\/product",             // class
+        @"^https://www\\.example\\.com/products",
+        @"^(?x) h t t p s",                   // free spacing
+        @"^x$",
+        @"^(unclosed",                        // invalid, skipped
+    ];
+}
+
+// The first matching pattern in list order, the way BNCURLFilter used to check
+- (nullable NSString *)naivePatternMatchingString:(NSString *)string regexes:(NSArray<NSRegularExpression *> *)regexes {
+    NSRange range = NSMakeRange(0, string.length);
+    for (NSRegularExpression *regex in regexes) {
+        if ([regex numberOfMatchesInString:string options:0 range:range] > 0) return regex.pattern;
+    }
+    return nil;
+}
+
+- (NSArray<NSRegularExpression *> *)regexesForPatterns:(NSArray<NSString *> *)patterns {
+    NSMutableArray<NSRegularExpression *> *regexes = [NSMutableArray new];
+    for (NSString *pattern in patterns) {
+        NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern options: NSRegularExpressionAnchorsMatchLines | NSRegularExpressionUseUnicodeWordBoundaries error:nil];
+        if (regex) [regexes addObject:regex];
+    }
+    return regexes;
+}
+
+- (void)assertMatcherEquivalentForPatterns:(NSArray<NSString *> *)patterns {
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:patterns];
+    NSArray<NSRegularExpression *> *regexes = [self regexesForPatterns:patterns];
+    XCTAssertEqual(matcher.patterns.count, regexes.count);
+
+    NSMutableArray<NSString *> *strings = [[self urlCorpus] mutableCopy];
+    [strings addObject:@"https://example.com/\nmyscheme:token"];
+    [strings addObject:@"note\rfb123:"];
+    for (NSString *string in strings) {
+        NSString *expected = [self naivePatternMatchingString:string regexes:regexes];
+        NSString *actual = [matcher patternMatchingString:string];
+        XCTAssertEqualObjects(expected, actual, @"%@", string);
+    }
+}
+
+- (void)testDefaultPatternsMatchLikeLoop {
+    [self assertMatcherEquivalentForPatterns:[BNCURLFilter new].patternList];
+}
+
+- (void)testTrickyPatternsMatchLikeLoop {
+    [self assertMatcherEquivalentForPatterns:[self trickyPatterns]];
+}
+
+- (void)testCombinedPatternsMatchLikeLoop {
+    NSArray *patterns = [[self trickyPatterns] arrayByAddingObjectsFromArray:[BNCURLFilter new].patternList];
+    [self assertMatcherEquivalentForPatterns:patterns];
+}
+
+- (void)testInvalidPatternSkipped {
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:@[ @"^(unclosed", @"^fb\\d+:" ]];
+    XCTAssertEqualObjects(matcher.patterns, @[ @"^fb\\d+:" ]);
+    XCTAssertEqualObjects([matcher patternMatchingString:@"fb123://"], @"^fb\\d+:");
+}
+
+- (void)testEmptyString {
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:@[ @".*" ]];
+    XCTAssertNil([matcher patternMatchingString:@""]);
+}
+
+- (void)testDictionaryRepresentation {
+    NSArray *patterns = [[self trickyPatterns] arrayByAddingObjectsFromArray:[BNCURLFilter new].patternList];
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:patterns];
+
+    // survives a round trip through a property list
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:[matcher dictionaryRepresentation] format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+    NSDictionary *dictionary = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    BNCURLPatternMatcher *restored = [[BNCURLPatternMatcher alloc] initWithDictionary:dictionary];
+    XCTAssertNotNil(restored);
+    XCTAssertEqualObjects(restored.patterns, matcher.patterns);
+
+    for (NSString *string in [self urlCorpus]) {
+        XCTAssertEqualObjects([restored patternMatchingString:string], [matcher patternMatchingString:string], @"%@", string);
+        XCTAssertEqual([restored candidateCountForString:string], [matcher candidateCountForString:string], @"%@", string);
+    }
+}
+
+- (void)testDictionaryFromOtherFormat {
+    NSMutableDictionary *dictionary = [[[[BNCURLPatternMatcher alloc] initWithPatterns:@[ @"^fb\\d+:" ]] dictionaryRepresentation] mutableCopy];
+    dictionary[@"format"] = @(0);
+    XCTAssertNil([[BNCURLPatternMatcher alloc] initWithDictionary:dictionary]);
+    XCTAssertNil([[BNCURLPatternMatcher alloc] initWithDictionary:@{ @"format": @(1), @"rules": @[ @"^fb" ] }]);
+}
+
+- (void)testCandidatesFiltered {
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:[BNCURLFilter new].patternList];
+
+    // an https link only runs the http(s) pattern, a custom scheme only runs the non http(s) pattern
+    XCTAssertEqual([matcher candidateCountForString:@"https://bnctestbed.app.link/cCeVhLHoqS"], 1);
+    XCTAssertEqual([matcher candidateCountForString:@"branchtest://open"], 1);
+    XCTAssertEqual([matcher candidateCountForString:@"fb12345://"], 2);
+
+    // lines after the first could match ^, so everything runs
+    XCTAssertEqual([matcher candidateCountForString:@"https://example.com/\nfb123:"], matcher.patterns.count);
+}
+
+#pragma mark - Performance
+
+// Compare with testMatcherPerformance
+- (void)testLoopPerformance {
+    NSArray<NSRegularExpression *> *regexes = [self regexesForPatterns:[BNCURLFilter new].patternList];
+    NSArray<NSString *> *corpus = [self urlCorpus];
+    [self measureBlock:^{
+        for (int i = 0; i < 100; i++) {
+            for (NSString *string in corpus) {
+                (void)[self naivePatternMatchingString:string regexes:regexes];
+            }
+        }
+    }];
+}
+
+- (void)testMatcherPerformance {
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:[BNCURLFilter new].patternList];
+    NSArray<NSString *> *corpus = [self urlCorpus];
+    [self measureBlock:^{
+        for (int i = 0; i < 100; i++) {
+            for (NSString *string in corpus) {
+                (void)[matcher patternMatchingString:string];
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,29 @@
+//
+//  BNCURLProtocolStub.h
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// test utility that answers matching requests with canned responses, so tests run the real networking code.
+// Registered globally, so it applies to sessions created with the default configuration after `start`.
+@interface BNCURLProtocolStub : NSURLProtocol
+
++ (void)start;
++ (void)stop;
+
+// Answers requests whose URL contains `fragment`. The most recent matching stub wins.
++ (void)stubURLContaining:(NSString *)fragment statusCode:(NSInteger)statusCode headers:(nullable NSDictionary<NSString *, NSString *> *)headers body:(nullable NSData *)body;
++ (void)stubURLContaining:(NSString *)fragment JSONObject:(id)object;
++ (void)stubURLContaining:(NSString *)fragment error:(NSError *)error;
+
+// Requests that matched a stub, in order, with HTTPBody filled in from the body stream.
++ (NSArray<NSURLRequest *> *)requests;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,136 @@
+//
+//  BNCURLProtocolStub.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCURLProtocolStub.h"
+
+@interface BNCURLStub : NSObject
+@property (nonatomic, copy) NSString *fragment;
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, copy, nullable) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, copy, nullable) NSData *body;
+@property (nonatomic, strong, nullable) NSError *error;
+@end
+
+@implementation BNCURLStub
+@end
+
+static NSMutableArray<BNCURLStub *> *bnc_stubs = nil;
+static NSMutableArray<NSURLRequest *> *bnc_requests = nil;
+
+@implementation BNCURLProtocolStub
+
++ (void)start {
+    @synchronized (self) {
+        bnc_stubs = [NSMutableArray new];
+        bnc_requests = [NSMutableArray new];
+    }
+    [NSURLProtocol registerClass:self];
+}
+
++ (void)stop {
+    [NSURLProtocol unregisterClass:self];
+    @synchronized (self) {
+        bnc_stubs = nil;
+        bnc_requests = nil;
+    }
+}
+
++ (void)addStub:(BNCURLStub *)stub {
+    @synchronized (self) {
+        [bnc_stubs addObject:stub];
+    }
+}
+
++ (void)stubURLContaining:(NSString *)fragment statusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> *)headers body:(NSData *)body {
+    BNCURLStub *stub = [BNCURLStub new];
+    stub.fragment = fragment;
+    stub.statusCode = statusCode;
+    stub.headers = headers;
+    stub.body = body;
+    [self addStub:stub];
+}
+
++ (void)stubURLContaining:(NSString *)fragment JSONObject:(id)object {
+    NSData *body = [NSJSONSerialization dataWithJSONObject:object options:0 error:nil];
+    [self stubURLContaining:fragment statusCode:200 headers:@{ @"Content-Type": @"application/json" } body:body];
+}
+
++ (void)stubURLContaining:(NSString *)fragment error:(NSError *)error {
+    BNCURLStub *stub = [BNCURLStub new];
+    stub.fragment = fragment;
+    stub.error = error;
+    [self addStub:stub];
+}
+
++ (NSArray<NSURLRequest *> *)requests {
+    @synchronized (self) {
+        return [bnc_requests copy] ?: @[];
+    }
+}
+
++ (nullable BNCURLStub *)stubForRequest:(NSURLRequest *)request {
+    NSString *url = request.URL.absoluteString;
+    @synchronized (self) {
+        for (BNCURLStub *stub in bnc_stubs.reverseObjectEnumerator) {
+            if ([url containsString:stub.fragment]) return stub;
+        }
+    }
+    return nil;
+}
+
+// Session tasks move the body into a stream before the protocol sees the request
++ (NSData *)bodyOfRequest:(NSURLRequest *)request {
+    if (request.HTTPBody || !request.HTTPBodyStream) return request.HTTPBody;
+
+    NSMutableData *body = [NSMutableData new];
+    NSInputStream *stream = request.HTTPBodyStream;
+    uint8_t buffer[4096];
+    [stream open];
+    while ([stream hasBytesAvailable]) {
+        NSInteger length = [stream read:buffer maxLength:sizeof(buffer)];
+        if (length <= 0) break;
+        [body appendBytes:buffer length:(NSUInteger)length];
+    }
+    [stream close];
+    return body;
+}
+
+#pragma mark - NSURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return [self stubForRequest:request] != nil;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    BNCURLStub *stub = [BNCURLProtocolStub stubForRequest:self.request];
+
+    NSMutableURLRequest *recorded = [self.request mutableCopy];
+    recorded.HTTPBody = [BNCURLProtocolStub bodyOfRequest:self.request];
+    @synchronized (BNCURLProtocolStub.class) {
+        [bnc_requests addObject:recorded];
+    }
+
+    if (!stub || stub.error) {
+        [self.client URLProtocol:self didFailWithError:stub.error ?: [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorResourceUnavailable userInfo:nil]];
+        return;
+    }
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:stub.statusCode HTTPVersion:@"HTTP/1.1" headerFields:stub.headers];
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    if (stub.body) {
+        [self.client URLProtocol:self didLoadData:stub.body];
+    }
+    [self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+}
+
+@end
@@ -7,6 +7,7 @@
 //
 
 #import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
 #import "BNCPreferenceHelper.h"
 #import "BNCDeviceSystem.h"
 #import "BNCUserAgentCollector.h"
@@ -108,4 +109,35 @@
     }];
 }
 
+- (void)testSynthesizedUserAgent {
+    BNCUserAgentCollector *collector = [BNCUserAgentCollector new];
+    NSString *userAgent = [collector synthesizedUserAgent];
+    NSString *version = [[UIDevice currentDevice].systemVersion stringByReplacingOccurrencesOfString:@"." withString:@"_"];
+    XCTAssertTrue([userAgent hasPrefix:@"Mozilla/5.0 ("]);
+    XCTAssertTrue([userAgent containsString:version]);
+    XCTAssertTrue([userAgent hasSuffix:@"AppleWebKit/605.1.15 (KHTML, like Gecko) Mobile/15E148"]);
+}
+
+- (void)testLoadUserAgent_Deferred {
+    BNCUserAgentCollector *collector = [BNCUserAgentCollector new];
+    collector.deferCollection = YES;
+
+    // completes without waiting for WebKit
+    __block NSString *loaded = nil;
+    [collector loadUserAgentWithCompletion:^(NSString * _Nullable userAgent) {
+        loaded = userAgent;
+    }];
+    XCTAssertEqualObjects([collector synthesizedUserAgent], loaded);
+
+    // the real one is collected and saved once the main thread is idle
+    NSString *systemBuildVersion = [BNCDeviceSystem new].systemBuildVersion;
+    NSPredicate *collected = [NSPredicate predicateWithBlock:^BOOL(id object, NSDictionary *bindings) {
+        return [[BNCPreferenceHelper sharedInstance].lastSystemBuildVersion isEqualToString:systemBuildVersion];
+    }];
+    [self expectationForPredicate:collected evaluatedWithObject:collector handler:nil];
+    [self waitForExpectationsWithTimeout:4.0 handler:nil];
+    XCTAssertTrue([collector.userAgent containsString:@"AppleWebKit"]);
+    XCTAssertEqualObjects([BNCPreferenceHelper sharedInstance].browserUserAgentString, collector.userAgent);
+}
+
 @end
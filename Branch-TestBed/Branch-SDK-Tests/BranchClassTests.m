@@ -12,12 +12,27 @@
 #import "BNCPasteboard.h"
 #import "BNCAppGroupsData.h"
 #import "BNCPartnerParameters.h"
+#import "BranchOpenRequest.h"
+#import "NSError+Branch.h"
+#import "BNCRequestCoalescer.h"
 
 @interface BNCPreferenceHelper(Test)
 // Expose internal private method to clear EEA data
 - (void)writeObjectToDefaults:(NSString *)key value:(NSObject *)value;
 @end
 
+@interface Branch(Test)
++ (BOOL)automaticOpenTrackingDisabled;
+@property (strong, atomic) NSDate *lastOpenDate;
+@property (assign, nonatomic) NSInteger networkCount;
+@property (nonatomic, strong, readwrite) dispatch_queue_t isolationQueue;
+@property (strong, nonatomic) BNCRequestCoalescer *shortUrlSyncRequests;
+@property (nonatomic, copy, nullable) void (^sceneSessionInitWithCallback)(BNCInitSessionResponse * _Nullable initResponse, NSError * _Nullable error);
+- (BOOL)canWarmResume;
+- (void)warmResume;
+- (void)warmResumeOpenDidFinishWithError:(NSError *)error servedParams:(NSDictionary *)servedParams;
+@end
+
 @interface BranchClassTests : XCTestCase
 @property (nonatomic, strong) Branch *branch;
 @property (nonatomic, strong, readwrite) BNCPreferenceHelper *prefHelper;
@@ -46,6 +61,89 @@
     XCTAssertTrue([BNCPreferenceHelper sharedInstance].disableAdNetworkCallouts, @"AdNetwork callouts should be disabled");
 }
 
+- (void)testWarmResumeNeedsRecentOpenWithoutNewLink {
+    NSString *savedToken = self.prefHelper.randomizedBundleToken;
+    NSString *savedSessionParams = self.prefHelper.sessionParams;
+    NSDate *savedDate = self.branch.lastOpenDate;
+    self.prefHelper.randomizedBundleToken = @"bundle-token";
+    self.prefHelper.sessionParams = @"{\"+clicked_branch_link\":false,\"+is_first_session\":false}";
+    self.prefHelper.universalLinkUrl = nil;
+    self.branch.lastOpenDate = [NSDate date];
+
+    XCTAssertFalse([self.branch canWarmResume], @"Warm resume should be off by default");
+
+    [self.branch setWarmResumeInterval:60];
+    XCTAssertTrue([self.branch canWarmResume]);
+
+    self.prefHelper.universalLinkUrl = @"https://example.app.link/abc";
+    XCTAssertFalse([self.branch canWarmResume], @"A waiting link needs a full open");
+    self.prefHelper.universalLinkUrl = nil;
+
+    self.prefHelper.sessionParams = @"{\"+clicked_branch_link\":true,\"+is_first_session\":false,\"~channel\":\"email\"}";
+    XCTAssertFalse([self.branch canWarmResume], @"A session from a link is not replayed");
+
+    self.prefHelper.sessionParams = @"{\"+clicked_branch_link\":false,\"+is_first_session\":false}";
+    self.branch.lastOpenDate = [NSDate dateWithTimeIntervalSinceNow:-120];
+    XCTAssertFalse([self.branch canWarmResume], @"An old open needs a full open");
+
+    [self.branch setWarmResumeInterval:0];
+    self.branch.lastOpenDate = savedDate;
+    self.prefHelper.sessionParams = savedSessionParams;
+    self.prefHelper.randomizedBundleToken = savedToken;
+}
+
+- (void)testWarmResumeCallsBackThroughSuccessPath {
+    NSString *savedToken = self.prefHelper.randomizedBundleToken;
+    NSString *savedSessionParams = self.prefHelper.sessionParams;
+    NSDate *savedDate = self.branch.lastOpenDate;
+    id savedStatus = [self.branch valueForKey:@"initializationStatus"];
+    self.prefHelper.randomizedBundleToken = @"bundle-token";
+    self.prefHelper.sessionParams = @"{\"+clicked_branch_link\":false,\"+is_first_session\":false}";
+    self.branch.lastOpenDate = [NSDate date];
+    [self.branch setWarmResumeInterval:60];
+
+    // hold the background open in the queue as if another request were on the network
+    self.branch.networkCount = 1;
+
+    __block NSDictionary *received = nil;
+    XCTestExpectation *callback = [self expectationWithDescription:@"init callback"];
+    self.branch.sceneSessionInitWithCallback = ^(BNCInitSessionResponse * _Nullable initResponse, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        received = initResponse.params;
+        [callback fulfill];
+    };
+    [self expectationForNotification:BranchWillStartSessionNotification object:self.branch handler:nil];
+    [self expectationForNotification:BranchDidStartSessionNotification object:self.branch handler:^BOOL(NSNotification *notification) {
+        // not a link, so no link content
+        return notification.userInfo[BranchUniversalObjectKey] == nil && notification.userInfo[BranchErrorKey] == nil;
+    }];
+
+    dispatch_sync(self.branch.isolationQueue, ^{
+        XCTAssertTrue([self.branch canWarmResume]);
+        [self.branch warmResume];
+    });
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqualObjects(received[@"+clicked_branch_link"], @NO);
+
+    // synchronous readers still wait for the background open
+    XCTestExpectation *locked = [self expectationWithDescription:@"lock held"];
+    [self.branch getLatestReferringParamsWithTimeout:0.1 completion:^(NSDictionary * _Nullable params, NSError * _Nullable error) {
+        XCTAssertEqual(BNCOpenResponseTimeoutError, error.code);
+        [locked fulfill];
+    }];
+    [self waitForExpectations:@[locked] timeout:2.0];
+
+    [self.branch clearNetworkQueue];
+    self.branch.networkCount = 0;
+    [BranchOpenRequest releaseOpenResponseLock];
+    self.branch.sceneSessionInitWithCallback = nil;
+    [self.branch setWarmResumeInterval:0];
+    [self.branch setValue:savedStatus forKey:@"initializationStatus"];
+    self.branch.lastOpenDate = savedDate;
+    self.prefHelper.sessionParams = savedSessionParams;
+    self.prefHelper.randomizedBundleToken = savedToken;
+}
+
 - (void)testSetNetworkTimeout {
     [self.branch setNetworkTimeout:5.0];
     XCTAssertEqual([BNCPreferenceHelper sharedInstance].timeout, 5.0, @"Network timeout should be set to 5.0");
@@ -189,6 +287,41 @@
 //    XCTAssertEqualObjects([result objectForKey:@"+clicked_branch_link"], @true);
 //}
 
+- (void)testGetLatestReferringParamsWithTimeout_OpenResponds {
+    NSString *sessionParamsString = @"{\"+clicked_branch_link\":true,\"+is_first_session\":false}";
+    [[BNCPreferenceHelper sharedInstance] setSessionParams:sessionParamsString];
+    [BranchOpenRequest setWaitNeededForOpenResponseLock];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"resolved"];
+    [self.branch getLatestReferringParamsWithTimeout:5.0 completion:^(NSDictionary * _Nullable params, NSError * _Nullable error) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertNil(error);
+        XCTAssertEqualObjects([params objectForKey:@"+clicked_branch_link"], @true);
+        [expectation fulfill];
+    }];
+    [BranchOpenRequest releaseOpenResponseLock];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+- (void)testGetLatestReferringParamsWithTimeout_Deadline {
+    [BranchOpenRequest setWaitNeededForOpenResponseLock];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"timed out"];
+    [self.branch getLatestReferringParamsWithTimeout:0.1 completion:^(NSDictionary * _Nullable params, NSError * _Nullable error) {
+        XCTAssertNil(params);
+        XCTAssertEqual(BNCOpenResponseTimeoutError, error.code);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    // the main thread is not parked past the deadline
+    NSString *sessionParamsString = @"{\"+clicked_branch_link\":true,\"+is_first_session\":false}";
+    [[BNCPreferenceHelper sharedInstance] setSessionParams:sessionParamsString];
+    NSDictionary *result = [self.branch getLatestReferringParamsSynchronousWithTimeout:0.1];
+    XCTAssertEqualObjects([result objectForKey:@"+clicked_branch_link"], @true);
+    [BranchOpenRequest releaseOpenResponseLock];
+}
+
 - (void)testGetLatestReferringBranchUniversalObject_ClickedBranchLink {
     NSString *sessionParamsString = @"{\"+clicked_branch_link\":1,\"+is_first_session\":false,\"$og_title\":\"My Latest Content\"}";
     [[BNCPreferenceHelper sharedInstance] setSessionParams:sessionParamsString];
@@ -456,4 +589,187 @@
                   @"One of the anonID values should be set");
 }
 
+// The configuration every request checks, read from several threads as the request queue does
+- (void)readRequestConfiguration {
+    dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        for (int i = 0; i < 25000; i++) {
+            (void)Branch.trackingDisabled;
+            (void)Branch.branchKey;
+            (void)Branch.useTestBranchKey;
+            (void)[Branch automaticOpenTrackingDisabled];
+        }
+    });
+}
+
+- (void)testRequestConfigurationReadPerformance {
+    [self measureBlock:^{
+        [self readRequestConfiguration];
+    }];
+}
+
+// Baseline with the class lock each read used to take
+- (void)testLockedRequestConfigurationReadPerformance {
+    [self measureBlock:^{
+        dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+            for (int i = 0; i < 25000; i++) {
+                @synchronized ([Branch class]) { (void)Branch.trackingDisabled; }
+                @synchronized ([Branch class]) { (void)Branch.branchKey; }
+                @synchronized ([Branch class]) { (void)Branch.useTestBranchKey; }
+                @synchronized ([Branch class]) { (void)[Branch automaticOpenTrackingDisabled]; }
+            }
+        });
+    }];
+}
+
+- (void)testRequestConfigurationIsConsistentAcrossThreads {
+    NSString *branchKey = Branch.branchKey;
+    dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        for (int i = 0; i < 1000; i++) {
+            XCTAssertEqualObjects(branchKey, Branch.branchKey);
+            XCTAssertFalse(Branch.trackingDisabled);
+        }
+    });
+}
+
+- (void)testWarmResumeCallsBackAgainForLinkSession {
+    NSString *savedSessionParams = self.prefHelper.sessionParams;
+    NSDate *savedDate = self.branch.lastOpenDate;
+    id savedStatus = [self.branch valueForKey:@"initializationStatus"];
+    NSDictionary *served = @{ @"+clicked_branch_link": @NO, @"+is_first_session": @NO };
+
+    // the open returned the same session, nothing more to deliver
+    self.prefHelper.sessionParams = @"{\"+clicked_branch_link\":false,\"+is_first_session\":false}";
+    self.branch.sceneSessionInitWithCallback = ^(BNCInitSessionResponse * _Nullable initResponse, NSError * _Nullable error) {
+        XCTFail(@"No second callback expected");
+    };
+    [self.branch warmResumeOpenDidFinishWithError:nil servedParams:served];
+    XCTestExpectation *drained = [self expectationWithDescription:@"main queue"];
+    dispatch_async(dispatch_get_main_queue(), ^{ [drained fulfill]; });
+    [self waitForExpectations:@[drained] timeout:2.0];
+
+    // the open found a deferred link
+    self.prefHelper.sessionParams = @"{\"+clicked_branch_link\":true,\"+is_first_session\":false,\"~channel\":\"email\"}";
+    __block NSDictionary *received = nil;
+    XCTestExpectation *callback = [self expectationWithDescription:@"second callback"];
+    self.branch.sceneSessionInitWithCallback = ^(BNCInitSessionResponse * _Nullable initResponse, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        received = initResponse.params;
+        [callback fulfill];
+    };
+    [self.branch warmResumeOpenDidFinishWithError:nil servedParams:served];
+    [self waitForExpectations:@[callback] timeout:2.0];
+    XCTAssertEqualObjects(received[@"~channel"], @"email");
+
+    // a failed open ends the session without calling back again
+    self.branch.sceneSessionInitWithCallback = ^(BNCInitSessionResponse * _Nullable initResponse, NSError * _Nullable error) {
+        XCTFail(@"No callback expected on failure");
+    };
+    [self expectationForNotification:BranchDidStartSessionNotification object:self.branch handler:^BOOL(NSNotification *notification) {
+        return notification.userInfo[BranchErrorKey] != nil;
+    }];
+    [self.branch warmResumeOpenDidFinishWithError:[NSError branchErrorWithCode:BNCServerProblemError] servedParams:served];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqualObjects(@(0), [self.branch valueForKey:@"initializationStatus"]);
+
+    self.branch.sceneSessionInitWithCallback = nil;
+    [self.branch setValue:savedStatus forKey:@"initializationStatus"];
+    self.branch.lastOpenDate = savedDate;
+    self.prefHelper.sessionParams = savedSessionParams;
+}
+
+- (void)testClearingQueueEndsLinkRequestsInFlight {
+    NSString *savedToken = self.prefHelper.randomizedBundleToken;
+    id savedStatus = [self.branch valueForKey:@"initializationStatus"];
+    [self.branch setValue:@(2) forKey:@"initializationStatus"]; // initialized, so no open is queued
+    NSDictionary *params = @{ @"key": [NSUUID UUID].UUIDString };
+
+    // hold the queue as if another request were on the network
+    self.branch.networkCount = 1;
+    XCTestExpectation *first = [self expectationWithDescription:@"first"];
+    [self.branch getShortUrlWithParams:params andCallback:^(NSString * _Nullable url, NSError * _Nullable error) {
+        XCTAssertEqual(BNCGeneralError, error.code);
+        [first fulfill];
+    }];
+    dispatch_sync(self.branch.isolationQueue, ^{});
+    [self.branch clearNetworkQueue];
+    [self waitForExpectations:@[first] timeout:5.0];
+
+    // an identical request is sent on its own instead of waiting on the dropped one, it fails fast without a session
+    self.prefHelper.randomizedBundleToken = nil;
+    XCTestExpectation *second = [self expectationWithDescription:@"second"];
+    [self.branch getShortUrlWithParams:params andCallback:^(NSString * _Nullable url, NSError * _Nullable error) {
+        XCTAssertEqual(BNCInitError, error.code);
+        [second fulfill];
+    }];
+    [self waitForExpectations:@[second] timeout:5.0];
+
+    self.prefHelper.randomizedBundleToken = savedToken;
+    [self.branch setValue:savedStatus forKey:@"initializationStatus"];
+}
+
+
+- (void)testClearingQueueKeepsSynchronousLinkRequests {
+    // synchronous link requests never enter the queue, so a clear leaves them running
+    NSString *key = [NSUUID UUID].UUIDString;
+    dispatch_semaphore_t started = dispatch_semaphore_create(0);
+    dispatch_semaphore_t release = dispatch_semaphore_create(0);
+    __block id firstResult = nil;
+    __block id secondResult = nil;
+
+    XCTestExpectation *first = [self expectationWithDescription:@"first"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        firstResult = [self.branch.shortUrlSyncRequests performSynchronouslyForKey:key work:^id {
+            dispatch_semaphore_signal(started);
+            dispatch_semaphore_wait(release, DISPATCH_TIME_FOREVER);
+            return @"https://bnc.lt/first";
+        }];
+        [first fulfill];
+    });
+    dispatch_semaphore_wait(started, DISPATCH_TIME_FOREVER);
+
+    [self.branch clearNetworkQueue];
+
+    XCTestExpectation *second = [self expectationWithDescription:@"second"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        secondResult = [self.branch.shortUrlSyncRequests performSynchronouslyForKey:key work:^id {
+            return @"https://bnc.lt/second";
+        }];
+        [second fulfill];
+    });
+
+    // let the second caller attach to the flight before it ends
+    [NSThread sleepForTimeInterval:0.2];
+    dispatch_semaphore_signal(release);
+    [self waitForExpectations:@[first, second] timeout:5.0];
+
+    XCTAssertEqualObjects(@"https://bnc.lt/first", firstResult);
+    XCTAssertEqualObjects(@"https://bnc.lt/first", secondResult);
+}
+
+
+- (void)testTimedOutParamsRequestReleasesCompletion {
+    [BranchOpenRequest setWaitNeededForOpenResponseLock];
+
+    __weak NSObject *weakCaptured = nil;
+    XCTestExpectation *timedOut = [self expectationWithDescription:@"timed out"];
+    @autoreleasepool {
+        NSObject *captured = [NSObject new];
+        weakCaptured = captured;
+        [self.branch getLatestReferringParamsWithTimeout:0.1 completion:^(NSDictionary * _Nullable params, NSError * _Nullable error) {
+            XCTAssertEqual(BNCOpenResponseTimeoutError, error.code);
+            XCTAssertNotNil(captured);
+            [timedOut fulfill];
+        }];
+    }
+    [self waitForExpectations:@[timedOut] timeout:2.0];
+
+    // the block left on the lock no longer holds the completion
+    XCTestExpectation *drained = [self expectationWithDescription:@"main queue"];
+    dispatch_async(dispatch_get_main_queue(), ^{ [drained fulfill]; });
+    [self waitForExpectations:@[drained] timeout:2.0];
+    XCTAssertNil(weakCaptured);
+
+    [BranchOpenRequest releaseOpenResponseLock];
+}
+
 @end
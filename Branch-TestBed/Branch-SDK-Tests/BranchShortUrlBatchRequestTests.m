@@ -0,0 +1,220 @@
+//
+//  BranchShortUrlBatchRequestTests.m
+//  Branch-SDK-Tests
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "BranchShortUrlBatchRequest.h"
+#import "BNCServerInterface.h"
+#import "BNCPreferenceHelper.h"
+#import "BranchConstants.h"
+#import "NSError+Branch.h"
+#import "BNCURLProtocolStub.h"
+
+@interface BranchShortUrlBatchRequestTests : XCTestCase
+@property (nonatomic, strong) BNCLinkCache *linkCache;
+@property (nonatomic, strong) NSURL *storageURL;
+@property (nonatomic, strong) BNCServerInterface *serverInterface;
+@property (nonatomic, copy) NSString *userUrl;
+@end
+
+@implementation BranchShortUrlBatchRequestTests
+
+- (void)setUp {
+    NSString *name = [NSString stringWithFormat:@"BranchShortUrlBatchRequestTests-%@", [NSUUID UUID].UUIDString];
+    self.storageURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+    self.linkCache = [[BNCLinkCache alloc] initWithStorageURL:self.storageURL];
+
+    // long link fallbacks are built on the user url
+    self.userUrl = [BNCPreferenceHelper sharedInstance].userUrl;
+    [BNCPreferenceHelper sharedInstance].userUrl = @"https://bnc.lt/user";
+
+    [BNCURLProtocolStub start];
+    self.serverInterface = [BNCServerInterface new];
+    self.serverInterface.preferenceHelper = [BNCPreferenceHelper sharedInstance];
+}
+
+- (void)tearDown {
+    [BNCURLProtocolStub stop];
+    [BNCPreferenceHelper sharedInstance].userUrl = self.userUrl;
+    [[NSFileManager defaultManager] removeItemAtURL:self.storageURL error:nil];
+}
+
+- (BranchShortUrlRequest *)requestWithChannel:(NSString *)channel {
+    BNCLinkData *linkData = [BNCLinkData new];
+    [linkData setupChannel:channel];
+    return [[BranchShortUrlRequest alloc] initWithTags:nil alias:nil type:BranchLinkTypeUnlimitedUse matchDuration:0 channel:channel feature:nil stage:nil campaign:nil params:@{} linkData:linkData linkCache:self.linkCache callback:nil];
+}
+
+- (void)runRequest:(BranchShortUrlBatchRequest *)request {
+    [request makeRequest:self.serverInterface key:@"key_live_foo" callback:^(BNCServerResponse *response, NSError *error) {
+        [request processResponse:response error:error];
+    }];
+}
+
+- (NSDictionary *)postedLinks {
+    NSURLRequest *post = [BNCURLProtocolStub requests].firstObject;
+    XCTAssertEqualObjects(@"POST", post.HTTPMethod);
+    XCTAssertTrue([post.URL.path hasSuffix:@"/v1/url/bulk/key_live_foo"]);
+    return [NSJSONSerialization JSONObjectWithData:post.HTTPBody options:0 error:nil];
+}
+
+- (void)testAllCachedLinksNeedNoRequest {
+    BranchShortUrlRequest *a = [self requestWithChannel:@"a"];
+    BranchShortUrlRequest *b = [self requestWithChannel:@"b"];
+    [self.linkCache setObject:@"https://bnc.lt/cached-a" forKey:a.linkData];
+    [self.linkCache setObject:@"https://bnc.lt/cached-b" forKey:b.linkData];
+
+    __block NSArray *urls = nil;
+    BranchShortUrlBatchRequest *request = [[BranchShortUrlBatchRequest alloc] initWithRequests:@[a, b] linkCache:self.linkCache callback:^(NSArray *result, NSError *error) {
+        urls = result;
+        XCTAssertNil(error);
+    }];
+    XCTAssertEqual(0, request.missCount);
+
+    [request processResponse:nil error:nil];
+    NSArray *expected = @[ @"https://bnc.lt/cached-a", @"https://bnc.lt/cached-b" ];
+    XCTAssertEqualObjects(expected, urls);
+}
+
+- (void)testMissesAreSentInOneRequest {
+    BranchShortUrlRequest *cached = [self requestWithChannel:@"cached"];
+    [self.linkCache setObject:@"https://bnc.lt/from-cache" forKey:cached.linkData];
+    NSArray *requests = @[ [self requestWithChannel:@"a"], cached, [self requestWithChannel:@"b"] ];
+
+    [BNCURLProtocolStub stubURLContaining:@"/v1/url/bulk/" JSONObject:@[
+        @{ BRANCH_RESPONSE_KEY_URL: @"https://bnc.lt/a" },
+        @{ BRANCH_RESPONSE_KEY_URL: @"https://bnc.lt/b" },
+    ]];
+
+    __block NSArray *urls = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    BranchShortUrlBatchRequest *request = [[BranchShortUrlBatchRequest alloc] initWithRequests:requests linkCache:self.linkCache callback:^(NSArray *result, NSError *error) {
+        urls = result;
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    XCTAssertEqual(2, request.missCount);
+
+    [self runRequest:request];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqual(1, [BNCURLProtocolStub requests].count);
+    NSArray *links = (NSArray *)[self postedLinks];
+    XCTAssertEqual(2, links.count);
+    XCTAssertEqualObjects(@"a", links.firstObject[BRANCH_REQUEST_KEY_URL_CHANNEL]);
+    XCTAssertEqualObjects(@"b", links.lastObject[BRANCH_REQUEST_KEY_URL_CHANNEL]);
+    NSArray *expected = @[ @"https://bnc.lt/a", @"https://bnc.lt/from-cache", @"https://bnc.lt/b" ];
+    XCTAssertEqualObjects(expected, urls);
+
+    // new links are cached for later requests
+    XCTAssertEqualObjects(@"https://bnc.lt/a", [self.linkCache objectForKey:[requests[0] linkData]]);
+    XCTAssertEqualObjects(@"https://bnc.lt/b", [self.linkCache objectForKey:[requests[2] linkData]]);
+}
+
+- (void)testDuplicatesAreCreatedOnce {
+    __block NSUInteger callbackCount = 0;
+    BranchShortUrlRequest *first = [self requestWithChannel:@"a"];
+    BranchShortUrlRequest *second = [self requestWithChannel:@"a"];
+    second.callback = ^(NSString *url, NSError *error) {
+        callbackCount++;
+        XCTAssertEqualObjects(@"https://bnc.lt/a", url);
+    };
+
+    [BNCURLProtocolStub stubURLContaining:@"/v1/url/bulk/" JSONObject:@[ @{ BRANCH_RESPONSE_KEY_URL: @"https://bnc.lt/a" } ]];
+
+    __block NSArray *urls = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    BranchShortUrlBatchRequest *request = [[BranchShortUrlBatchRequest alloc] initWithRequests:@[first, second] linkCache:self.linkCache callback:^(NSArray *result, NSError *error) {
+        urls = result;
+        [expectation fulfill];
+    }];
+    XCTAssertEqual(1, request.missCount);
+
+    [self runRequest:request];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqual(1, ((NSArray *)[self postedLinks]).count);
+    XCTAssertEqual(1, callbackCount);
+    NSArray *expected = @[ @"https://bnc.lt/a", @"https://bnc.lt/a" ];
+    XCTAssertEqualObjects(expected, urls);
+}
+
+- (void)testFailureFallsBackToLongLinks {
+    NSData *body = [@"{\"error\":{\"code\":400,\"message\":\"Bad request\"}}" dataUsingEncoding:NSUTF8StringEncoding];
+    [BNCURLProtocolStub stubURLContaining:@"/v1/url/bulk/" statusCode:400 headers:nil body:body];
+
+    __block NSArray *urls = nil;
+    __block NSError *batchError = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    NSArray *requests = @[ [self requestWithChannel:@"a"], [self requestWithChannel:@"b"] ];
+    BranchShortUrlBatchRequest *request = [[BranchShortUrlBatchRequest alloc] initWithRequests:requests linkCache:self.linkCache callback:^(NSArray *result, NSError *error) {
+        urls = result;
+        batchError = error;
+        [expectation fulfill];
+    }];
+
+    [self runRequest:request];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertNotNil(batchError);
+    XCTAssertEqualObjects(@"Bad request", batchError.localizedDescription);
+    XCTAssertEqual(2, urls.count);
+    XCTAssertTrue([urls[0] hasPrefix:@"https://bnc.lt/user?channel=a&"]);
+    XCTAssertTrue([urls[1] hasPrefix:@"https://bnc.lt/user?channel=b&"]);
+    XCTAssertNil([self.linkCache objectForKey:[requests[0] linkData]]);
+    XCTAssertNil([self.linkCache objectForKey:[requests[1] linkData]]);
+}
+
+- (void)testMismatchedResponseFallsBackToLongLinks {
+    [BNCURLProtocolStub stubURLContaining:@"/v1/url/bulk/" JSONObject:@[ @{ BRANCH_RESPONSE_KEY_URL: @"https://bnc.lt/a" } ]];
+
+    __block NSArray *urls = nil;
+    __block NSError *batchError = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    NSArray *requests = @[ [self requestWithChannel:@"a"], [self requestWithChannel:@"b"] ];
+    BranchShortUrlBatchRequest *request = [[BranchShortUrlBatchRequest alloc] initWithRequests:requests linkCache:self.linkCache callback:^(NSArray *result, NSError *error) {
+        urls = result;
+        batchError = error;
+        [expectation fulfill];
+    }];
+
+    [self runRequest:request];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqual(BNCBadRequestError, batchError.code);
+    XCTAssertEqual(2, urls.count);
+    XCTAssertTrue([urls[0] hasPrefix:@"https://bnc.lt/user?channel=a&"]);
+    XCTAssertTrue([urls[1] hasPrefix:@"https://bnc.lt/user?channel=b&"]);
+}
+
+
+- (void)testLinkDataWithDatesIsEncoded {
+    NSDate *expiry = [NSDate dateWithTimeIntervalSince1970:1800000000];
+    BNCLinkData *linkData = [BNCLinkData new];
+    [linkData setupChannel:@"a"];
+    [linkData setupParams:@{ @"$expiry": expiry, @"$fallback_url": [NSURL URLWithString:@"https://example.com"] }];
+    BranchShortUrlRequest *link = [[BranchShortUrlRequest alloc] initWithTags:nil alias:nil type:BranchLinkTypeUnlimitedUse matchDuration:0 channel:@"a" feature:nil stage:nil campaign:nil params:linkData.params linkData:linkData linkCache:self.linkCache callback:nil];
+
+    [BNCURLProtocolStub stubURLContaining:@"/v1/url/bulk/" JSONObject:@[ @{ BRANCH_RESPONSE_KEY_URL: @"https://bnc.lt/a" } ]];
+
+    __block NSArray *urls = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"batch"];
+    BranchShortUrlBatchRequest *request = [[BranchShortUrlBatchRequest alloc] initWithRequests:@[link] linkCache:self.linkCache callback:^(NSArray *result, NSError *error) {
+        urls = result;
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+
+    [self runRequest:request];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqualObjects(@[ @"https://bnc.lt/a" ], urls);
+    NSDictionary *data = ((NSArray *)[self postedLinks]).firstObject[BRANCH_REQUEST_KEY_URL_DATA];
+    XCTAssertEqualObjects(expiry, [[NSISO8601DateFormatter new] dateFromString:data[@"$expiry"]]);
+    XCTAssertEqualObjects(@"https://example.com", data[@"$fallback_url"]);
+}
+
+@end
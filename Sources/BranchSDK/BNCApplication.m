@@ -11,11 +11,22 @@
 #import "BNCApplication.h"
 #import "BranchLogger.h"
 #import "BNCKeyChain.h"
+#import "BNCPreferenceHelper.h"
 
 static NSString*const kBranchKeychainService          = @"BranchKeychainService";
 static NSString*const kBranchKeychainFirstBuildKey    = @"BranchKeychainFirstBuild";
 static NSString*const kBranchKeychainFirstInstalldKey = @"BranchKeychainFirstInstall";
 
+// Dates that only change with the app version, saved so launches skip the file system and keychain probes
+static NSString * const BNCApplicationSnapshotFileName = @"BNCApplicationSnapshot";
+static NSString * const BNCApplicationSnapshotVersionKey = @"v";
+static NSString * const BNCApplicationSnapshotAppKey = @"app";
+static NSString * const BNCApplicationSnapshotBuildDateKey = @"build";
+static NSString * const BNCApplicationSnapshotFirstBuildDateKey = @"first_build";
+static NSString * const BNCApplicationSnapshotInstallDateKey = @"install";
+static NSString * const BNCApplicationSnapshotTeamIDKey = @"team";
+static NSInteger const BNCApplicationSnapshotVersion = 1;
+
 #pragma mark - BNCApplication
 
 @implementation BNCApplication
@@ -41,6 +52,10 @@ static NSString*const kBranchKeychainFirstInstalldKey = @"BranchKeychainFirstIns
 }
 
 + (BNCApplication*) createCurrentApplication {
+    return [self createApplicationWithSnapshotURL:[self defaultSnapshotURL]];
+}
+
++ (BNCApplication *)createApplicationWithSnapshotURL:(NSURL *)snapshotURL {
     BNCApplication *application = [[BNCApplication alloc] init];
     if (!application) return application;
     NSDictionary *info = [NSBundle mainBundle].infoDictionary;
@@ -52,10 +67,13 @@ static NSString*const kBranchKeychainFirstInstalldKey = @"BranchKeychainFirstIns
     application->_displayVersionString = info[@"CFBundleShortVersionString"];
     application->_versionString = info[@"CFBundleVersion"];
 
+    NSString *snapshotKey = [self snapshotKey];
+    if ([application loadSnapshotFromURL:snapshotURL key:snapshotKey]) {
+        return application;
+    }
+
     application->_firstInstallBuildDate = [BNCApplication firstInstallBuildDate];
     application->_currentBuildDate = [BNCApplication currentBuildDate];
-
-    application->_firstInstallDate = [BNCApplication firstInstallDate];
     application->_currentInstallDate = [BNCApplication currentInstallDate];
 
     NSString*group =  [BNCKeyChain securityAccessGroup];
@@ -66,9 +84,89 @@ static NSString*const kBranchKeychainFirstInstalldKey = @"BranchKeychainFirstIns
         }
     }
 
+    [application saveSnapshotToURL:snapshotURL key:snapshotKey];
     return application;
 }
 
+#pragma mark - Snapshot
+
++ (NSURL *)defaultSnapshotURL {
+    return [BNCURLForBranchDirectory() URLByAppendingPathComponent:BNCApplicationSnapshotFileName isDirectory:NO];
+}
+
+// The bundle path changes with every install or update of the app, so a matching snapshot was taken by this build
++ (NSString *)snapshotKey {
+    NSDictionary *info = [NSBundle mainBundle].infoDictionary;
+    return [NSString stringWithFormat:@"%@|%@|%@",
+        info[@"CFBundleShortVersionString"] ?: @"",
+        info[@"CFBundleVersion"] ?: @"",
+        [NSBundle mainBundle].bundlePath ?: @""];
+}
+
+- (BOOL)loadSnapshotFromURL:(NSURL *)url key:(NSString *)key {
+    if (!url) return NO;
+    NSData *data = [NSData dataWithContentsOfURL:url];
+    if (!data) return NO;
+
+    NSDictionary *snapshot = nil;
+    @try {
+        snapshot = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    } @catch (NSException *exception) {
+        [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Exception reading application snapshot: %@.", exception] error:nil];
+    }
+    if (![snapshot isKindOfClass:NSDictionary.class] ||
+        ![snapshot[BNCApplicationSnapshotVersionKey] isEqual:@(BNCApplicationSnapshotVersion)] ||
+        ![snapshot[BNCApplicationSnapshotAppKey] isEqual:key]) {
+        return NO;
+    }
+
+    NSDate *buildDate = snapshot[BNCApplicationSnapshotBuildDateKey];
+    NSDate *firstBuildDate = snapshot[BNCApplicationSnapshotFirstBuildDateKey];
+    NSDate *installDate = snapshot[BNCApplicationSnapshotInstallDateKey];
+    NSString *teamID = snapshot[BNCApplicationSnapshotTeamIDKey];
+    if (![buildDate isKindOfClass:NSDate.class] ||
+        ![firstBuildDate isKindOfClass:NSDate.class] ||
+        ![installDate isKindOfClass:NSDate.class]) {
+        return NO;
+    }
+
+    _currentBuildDate = buildDate;
+    _firstInstallBuildDate = firstBuildDate;
+    _currentInstallDate = installDate;
+    _teamID = ([teamID isKindOfClass:NSString.class]) ? [teamID copy] : nil;
+    return YES;
+}
+
+- (void)saveSnapshotToURL:(NSURL *)url key:(NSString *)key {
+    if (!url || !_currentBuildDate || !_firstInstallBuildDate || !_currentInstallDate) return;
+
+    NSMutableDictionary *snapshot = [NSMutableDictionary new];
+    snapshot[BNCApplicationSnapshotVersionKey] = @(BNCApplicationSnapshotVersion);
+    snapshot[BNCApplicationSnapshotAppKey] = key;
+    snapshot[BNCApplicationSnapshotBuildDateKey] = _currentBuildDate;
+    snapshot[BNCApplicationSnapshotFirstBuildDateKey] = _firstInstallBuildDate;
+    snapshot[BNCApplicationSnapshotInstallDateKey] = _currentInstallDate;
+    snapshot[BNCApplicationSnapshotTeamIDKey] = _teamID;
+
+    NSError *error = nil;
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:snapshot format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+    if (!data || ![data writeToURL:url options:NSDataWritingAtomic error:&error]) {
+        [[BranchLogger shared] logWarning:@"Failed to save application snapshot" error:error];
+    }
+}
+
+#pragma mark - Dates
+
+// The keychain can be reset apart from the app, so this is read on first use rather than saved in the snapshot
+- (NSDate *)firstInstallDate {
+    @synchronized (self) {
+        if (!_firstInstallDate) {
+            _firstInstallDate = [BNCApplication firstInstallDateWithCurrentInstallDate:self.currentInstallDate];
+        }
+        return _firstInstallDate;
+    }
+}
+
 + (NSDate *)currentBuildDate {
     NSURL *appURL = nil;
     NSURL *bundleURL = [NSBundle mainBundle].bundleURL;
@@ -149,7 +247,7 @@ static NSString*const kBranchKeychainFirstInstalldKey = @"BranchKeychainFirstIns
     return [attributes fileCreationDate];
 }
 
-+ (NSDate *)firstInstallDate {
++ (NSDate *)firstInstallDateWithCurrentInstallDate:(NSDate *)currentInstallDate {
     // check keychain for stored install date, on iOS this is lost on app deletion.
     NSError *error = nil;
     NSDate* firstInstallDate = [BNCKeyChain retrieveDateForService:kBranchKeychainService key:kBranchKeychainFirstInstalldKey error:&error];
@@ -158,7 +256,7 @@ static NSString*const kBranchKeychainFirstInstalldKey = @"BranchKeychainFirstIns
     }
     
     // check filesytem for creation date
-    firstInstallDate = [self currentInstallDate];
+    firstInstallDate = currentInstallDate ?: [self currentInstallDate];
     
     // save filesystem time to keychain
     error = [BNCKeyChain storeDate:firstInstallDate forService:kBranchKeychainService key:kBranchKeychainFirstInstalldKey cloudAccessGroup:nil];
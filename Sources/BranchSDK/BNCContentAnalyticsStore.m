@@ -0,0 +1,353 @@
+//
+//  BNCContentAnalyticsStore.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCContentAnalyticsStore.h"
+#import "BNCPreferenceHelper.h"
+#import "BranchLogger.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static NSString * const BNCContentAnalyticsFileName = @"BNCContentAnalytics.log";
+static NSUInteger const BNCContentAnalyticsDefaultByteLimit = 256 * 1024;
+
+// Drained bytes are reclaimed once there are at least this many and more than the bytes still queued
+static uint64_t const BNCContentAnalyticsCompactionMinBytes = 16 * 1024;
+
+static NSString * const BNCContentAnalyticsSessionKey = @"s";
+static NSString * const BNCContentAnalyticsEventKey = @"e";
+
+// File: header, then one JSON object per line. Lines before header.start were drained.
+static const char BNCContentAnalyticsMagic[8] = { 'B', 'N', 'C', 'C', 'A', '0', '0', '1' };
+
+typedef struct {
+    char magic[8];
+    uint64_t start;
+} BNCContentAnalyticsHeader;
+
+static BOOL BNCContentAnalyticsWrite(int fd, const void *bytes, size_t length, uint64_t offset) {
+    const uint8_t *p = bytes;
+    while (length > 0) {
+        ssize_t written = pwrite(fd, p, length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return NO;
+        }
+        p += written;
+        offset += (uint64_t)written;
+        length -= (size_t)written;
+    }
+    return YES;
+}
+
+@interface BNCContentAnalyticsStore ()
+@property (nonatomic, copy) NSURL *url;
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, assign) int fd;
+@property (nonatomic, assign) uint64_t start;
+@property (nonatomic, assign) uint64_t end;
+@end
+
+@implementation BNCContentAnalyticsStore
+
++ (NSURL *)defaultURL {
+    return [BNCURLForBranchDirectory() URLByAppendingPathComponent:BNCContentAnalyticsFileName isDirectory:NO];
+}
+
++ (BNCContentAnalyticsStore *)storeWithURL:(NSURL *)url {
+    static NSMutableDictionary<NSString *, BNCContentAnalyticsStore *> *stores = nil;
+    static dispatch_once_t onceToken = 0;
+    dispatch_once(&onceToken, ^{
+        stores = [NSMutableDictionary new];
+    });
+
+    NSString *path = url.URLByStandardizingPath.path ?: @"";
+    @synchronized (stores) {
+        BNCContentAnalyticsStore *store = stores[path];
+        if (!store) {
+            store = [[BNCContentAnalyticsStore alloc] initWithURL:url];
+            stores[path] = store;
+        }
+        return store;
+    }
+}
+
+- (instancetype)initWithURL:(NSURL *)url {
+    self = [super init];
+    if (!self) return self;
+
+    _url = [url copy];
+    _queue = dispatch_queue_create("io.branch.sdk.contentanalytics", DISPATCH_QUEUE_SERIAL);
+    _fd = -1;
+    _byteLimit = BNCContentAnalyticsDefaultByteLimit;
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) close(_fd);
+}
+
+#pragma mark - File
+
+// The methods in this section run on the queue
+
+- (BOOL)openIfNeeded {
+    if (self.fd >= 0) return YES;
+
+    int fd = open(self.url.fileSystemRepresentation, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        NSError *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        [[BranchLogger shared] logWarning:@"Failed to open content analytics store." error:error];
+        return NO;
+    }
+    self.fd = fd;
+
+    BNCContentAnalyticsHeader header;
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+        memcmp(header.magic, BNCContentAnalyticsMagic, sizeof(header.magic)) != 0 ||
+        header.start < sizeof(header) || header.start > (uint64_t)info.st_size) {
+        return [self resetFile];
+    }
+
+    // an event torn by a crash has no newline and is dropped
+    self.start = header.start;
+    self.end = [self endOfLastLineBefore:(uint64_t)info.st_size];
+    if (self.end < (uint64_t)info.st_size) {
+        ftruncate(fd, (off_t)self.end);
+    }
+    return YES;
+}
+
+- (uint64_t)endOfLastLineBefore:(uint64_t)size {
+    char buffer[4096];
+    uint64_t offset = size;
+    while (offset > self.start) {
+        size_t length = (size_t)MIN((uint64_t)sizeof(buffer), offset - self.start);
+        if (pread(self.fd, buffer, length, (off_t)(offset - length)) != (ssize_t)length) break;
+        for (size_t i = length; i > 0; i--) {
+            if (buffer[i - 1] == '\n') return offset - length + i;
+        }
+        offset -= length;
+    }
+    return self.start;
+}
+
+- (BOOL)resetFile {
+    BNCContentAnalyticsHeader header = { .start = sizeof(BNCContentAnalyticsHeader) };
+    memcpy(header.magic, BNCContentAnalyticsMagic, sizeof(header.magic));
+    if (ftruncate(self.fd, 0) != 0 || !BNCContentAnalyticsWrite(self.fd, &header, sizeof(header), 0)) {
+        NSError *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        [[BranchLogger shared] logWarning:@"Failed to reset content analytics store." error:error];
+        close(self.fd);
+        self.fd = -1;
+        return NO;
+    }
+    self.start = header.start;
+    self.end = header.start;
+    return YES;
+}
+
+- (void)writeStart:(uint64_t)start {
+    self.start = start;
+    BNCContentAnalyticsWrite(self.fd, &start, sizeof(start), offsetof(BNCContentAnalyticsHeader, start));
+}
+
+- (NSData *)readEvents {
+    if (self.end <= self.start) return [NSData data];
+    NSMutableData *data = [NSMutableData dataWithLength:(NSUInteger)(self.end - self.start)];
+    if (pread(self.fd, data.mutableBytes, data.length, (off_t)self.start) != (ssize_t)data.length) {
+        [[BranchLogger shared] logWarning:@"Failed to read content analytics store." error:nil];
+        return [NSData data];
+    }
+    return data;
+}
+
+// Replaces the file with one holding only `events`, used to reclaim drained bytes and to trim.
+// The new file is flushed before the rename so a crash can't leave an empty store in place of the old one.
+- (void)rewriteWithEvents:(NSData *)events {
+    NSURL *temporaryURL = [self.url URLByAppendingPathExtension:@"tmp"];
+    int fd = open(temporaryURL.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+
+    BNCContentAnalyticsHeader header = { .start = sizeof(BNCContentAnalyticsHeader) };
+    memcpy(header.magic, BNCContentAnalyticsMagic, sizeof(header.magic));
+    if (fd < 0 ||
+        !BNCContentAnalyticsWrite(fd, &header, sizeof(header), 0) ||
+        !BNCContentAnalyticsWrite(fd, events.bytes, events.length, sizeof(header)) ||
+        fsync(fd) != 0 ||
+        rename(temporaryURL.fileSystemRepresentation, self.url.fileSystemRepresentation) != 0) {
+        NSError *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        [[BranchLogger shared] logWarning:@"Failed to rewrite content analytics store." error:error];
+        if (fd >= 0) close(fd);
+        unlink(temporaryURL.fileSystemRepresentation);
+        return;
+    }
+
+    close(self.fd);
+    self.fd = fd;
+    self.start = header.start;
+    self.end = header.start + events.length;
+}
+
+// Drops the oldest events so the file is at most half full after `length` more bytes
+- (void)trimForLength:(NSUInteger)length {
+    NSData *events = [self readEvents];
+    NSUInteger keep = self.byteLimit / 2 - MIN(length, self.byteLimit / 2);
+
+    const char *bytes = events.bytes;
+    NSUInteger cut = 0;
+    NSUInteger dropped = 0;
+    while (events.length - cut > keep) {
+        const char *newline = memchr(bytes + cut, '\n', events.length - cut);
+        cut = newline ? (NSUInteger)(newline - bytes) + 1 : events.length;
+        dropped++;
+    }
+    [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"Content analytics store is full, dropped %lu oldest events.", (unsigned long)dropped] error:nil];
+    [self rewriteWithEvents:[events subdataWithRange:NSMakeRange(cut, events.length - cut)]];
+}
+
+- (void)compactIfNeeded {
+    uint64_t drained = self.start - sizeof(BNCContentAnalyticsHeader);
+    if (drained >= BNCContentAnalyticsCompactionMinBytes && drained > self.end - self.start) {
+        [self rewriteWithEvents:[self readEvents]];
+    }
+}
+
+#pragma mark - Events
+
+- (void)appendEvent:(NSDictionary *)event sessionID:(NSString *)sessionID {
+    if (!event || !sessionID) return;
+
+    NSDictionary *record = @{ BNCContentAnalyticsSessionKey: sessionID, BNCContentAnalyticsEventKey: event };
+    if (![NSJSONSerialization isValidJSONObject:record]) {
+        [[BranchLogger shared] logWarning:@"Content analytics event is not valid JSON." error:nil];
+        return;
+    }
+    NSError *error = nil;
+    NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:record options:0 error:&error] mutableCopy];
+    if (!line) {
+        [[BranchLogger shared] logWarning:@"Failed to encode content analytics event." error:error];
+        return;
+    }
+    [line appendBytes:"\n" length:1];
+
+    dispatch_async(self.queue, ^{
+        if (line.length > self.byteLimit / 2) {
+            [[BranchLogger shared] logWarning:@"Content analytics event is too large to store." error:nil];
+            return;
+        }
+        if (![self openIfNeeded]) return;
+        if (self.end + line.length > self.byteLimit) {
+            [self trimForLength:line.length];
+        }
+        if (BNCContentAnalyticsWrite(self.fd, line.bytes, line.length, self.end)) {
+            self.end += line.length;
+        }
+    });
+}
+
+// Calls `block` with each decoded event in `events` and the offset just past its line
+- (void)enumerateEvents:(NSData *)events block:(void (^)(NSString *sessionID, NSDictionary *event, NSUInteger end, BOOL *stop))block {
+    const char *bytes = events.bytes;
+    NSUInteger offset = 0;
+    BOOL stop = NO;
+    while (offset < events.length && !stop) {
+        const char *newline = memchr(bytes + offset, '\n', events.length - offset);
+        NSUInteger end = newline ? (NSUInteger)(newline - bytes) + 1 : events.length;
+
+        NSData *line = [events subdataWithRange:NSMakeRange(offset, end - offset)];
+        NSDictionary *record = [NSJSONSerialization JSONObjectWithData:line options:0 error:nil];
+        if ([record isKindOfClass:NSDictionary.class] &&
+            [record[BNCContentAnalyticsSessionKey] isKindOfClass:NSString.class] &&
+            [record[BNCContentAnalyticsEventKey] isKindOfClass:NSDictionary.class]) {
+            block(record[BNCContentAnalyticsSessionKey], record[BNCContentAnalyticsEventKey], end, &stop);
+        }
+        offset = end;
+    }
+}
+
+- (NSMutableDictionary<NSString *, NSMutableArray *> *)eventsBySession {
+    NSMutableDictionary<NSString *, NSMutableArray *> *sessions = [NSMutableDictionary new];
+    dispatch_sync(self.queue, ^{
+        if (![self openIfNeeded]) return;
+        [self enumerateEvents:[self readEvents] block:^(NSString *sessionID, NSDictionary *event, NSUInteger end, BOOL *stop) {
+            NSMutableArray *events = sessions[sessionID];
+            if (!events) {
+                events = [NSMutableArray new];
+                sessions[sessionID] = events;
+            }
+            [events addObject:event];
+        }];
+    });
+    return sessions;
+}
+
+- (void)drainEventsWithBatchSize:(NSUInteger)batchSize handler:(BOOL (^)(NSDictionary<NSString *, NSArray *> *batch))handler {
+    if (batchSize == 0 || !handler) return;
+
+    dispatch_sync(self.queue, ^{
+        if (![self openIfNeeded]) return;
+        uint64_t start = self.start;
+        NSData *events = [self readEvents];
+
+        __block NSMutableDictionary<NSString *, NSMutableArray *> *batch = [NSMutableDictionary new];
+        __block NSUInteger count = 0;
+        __block BOOL kept = NO;
+        BOOL (^sendBatch)(NSUInteger) = ^BOOL (NSUInteger end) {
+            if (!handler(batch)) {
+                kept = YES;
+                return NO;
+            }
+            [self writeStart:start + end];
+            batch = [NSMutableDictionary new];
+            count = 0;
+            return YES;
+        };
+
+        [self enumerateEvents:events block:^(NSString *sessionID, NSDictionary *event, NSUInteger end, BOOL *stop) {
+            NSMutableArray *sessionEvents = batch[sessionID];
+            if (!sessionEvents) {
+                sessionEvents = [NSMutableArray new];
+                batch[sessionID] = sessionEvents;
+            }
+            [sessionEvents addObject:event];
+            if (++count == batchSize) {
+                *stop = !sendBatch(end);
+            }
+        }];
+        if (!kept && count > 0) {
+            sendBatch(events.length);
+        }
+        [self compactIfNeeded];
+    });
+}
+
+- (void)removeAllEvents {
+    dispatch_async(self.queue, ^{
+        if (![self openIfNeeded]) return;
+        [self resetFile];
+    });
+}
+
+- (void)synchronize {
+    dispatch_sync(self.queue, ^{});
+}
+
+- (NSUInteger)byteCount {
+    __block NSUInteger count = 0;
+    dispatch_sync(self.queue, ^{
+        if (![self openIfNeeded]) return;
+        count = (NSUInteger)(self.end - self.start);
+    });
+    return count;
+}
+
+@end
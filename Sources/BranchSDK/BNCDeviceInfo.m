@@ -10,9 +10,9 @@
 #import "BNCPreferenceHelper.h"
 #import "BNCSystemObserver.h"
 #import "BNCConfig.h"
-#import "BNCNetworkInterface.h"
 #import "BNCReachability.h"
 #import "BNCDeviceSystem.h"
+#import "NSMutableDictionary+Branch.h"
 
 #if !TARGET_OS_TV
 // tvOS does not support webkit
@@ -29,6 +29,7 @@
 
 @interface BNCDeviceInfo()
 @property (nonatomic, copy, readwrite) NSString *randomId;
+@property (nonatomic, copy, readwrite) NSDictionary *snapshot;
 @end
 
 @implementation BNCDeviceInfo
@@ -46,14 +47,87 @@
     self = [super init];
     if (self) {
         [self loadDeviceInfo];
+
+        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+        [notificationCenter addObserver:self selector:@selector(localeDidChange) name:NSCurrentLocaleDidChangeNotification object:nil];
+        [notificationCenter addObserver:self selector:@selector(invalidateSnapshot) name:UIApplicationDidBecomeActiveNotification object:nil];
+        [notificationCenter addObserver:self selector:@selector(invalidateSnapshot) name:BNCReachabilityDidChangeNotification object:nil];
     }
     return self;
 }
 
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 - (void)registerPluginName:(NSString *)name version:(NSString *)version {
     @synchronized (self) {
         self.pluginName = name;
         self.pluginVersion = version;
+        self.snapshot = nil;
+    }
+}
+
+#pragma mark - Snapshot
+
+- (void)localeDidChange {
+    @synchronized (self) {
+        self.locale = [NSLocale currentLocale].localeIdentifier;
+        self.country = [[NSLocale currentLocale] countryCode];
+        self.language = [[NSLocale currentLocale] languageCode];
+        self.snapshot = nil;
+    }
+}
+
+- (void)invalidateSnapshot {
+    @synchronized (self) {
+        self.snapshot = nil;
+    }
+}
+
+static BOOL BNCStringsEqual(NSString *a, NSString *b) {
+    return (a == b) || [a isEqualToString:b];
+}
+
+- (NSDictionary *)userDataSnapshot {
+    @synchronized (self) {
+        // the user agent is collected asynchronously and posts no notification, it is a property read to check
+        NSDictionary *snapshot = self.snapshot;
+        if (snapshot && BNCStringsEqual(snapshot[@"user_agent"], [self userAgentString])) {
+            return snapshot;
+        }
+
+        [self checkAdvertisingIdentifier];
+
+        NSMutableDictionary *dictionary = [NSMutableDictionary new];
+        [dictionary bnc_safeSetObject:self.advertiserId forKey:@"idfa"];
+        [dictionary bnc_safeSetObject:self.vendorId forKey:@"idfv"];
+        [dictionary bnc_safeSetObject:self.anonId forKey:@"anon_id"];
+        [dictionary bnc_safeSetObject:self.localIPAddress forKey:@"local_ip"];
+        [dictionary bnc_safeSetObject:self.optedInStatus forKey:@"opted_in_status"];
+        [dictionary bnc_safeSetObject:self.brandName forKey:@"brand"];
+        [dictionary bnc_safeSetObject:self.modelName forKey:@"model"];
+        [dictionary bnc_safeSetObject:self.osName forKey:@"os"];
+        [dictionary bnc_safeSetObject:self.osVersion forKey:@"os_version"];
+        [dictionary bnc_safeSetObject:self.osBuildVersion forKey:@"build"];
+        [dictionary bnc_safeSetObject:self.environment forKey:@"environment"];
+        [dictionary bnc_safeSetObject:self.cpuType forKey:@"cpu_type"];
+        [dictionary bnc_safeSetObject:self.screenScale forKey:@"screen_dpi"];
+        [dictionary bnc_safeSetObject:self.screenHeight forKey:@"screen_height"];
+        [dictionary bnc_safeSetObject:self.screenWidth forKey:@"screen_width"];
+        [dictionary bnc_safeSetObject:self.locale forKey:@"locale"];
+        [dictionary bnc_safeSetObject:self.country forKey:@"country"];
+        [dictionary bnc_safeSetObject:self.language forKey:@"language"];
+        [dictionary bnc_safeSetObject:[self connectionType] forKey:@"connection_type"];
+        [dictionary bnc_safeSetObject:[self userAgentString] forKey:@"user_agent"];
+        [dictionary bnc_safeSetObject:self.applicationVersion forKey:@"app_version"];
+        [dictionary bnc_safeSetObject:self.pluginName forKey:@"plugin_name"];
+        [dictionary bnc_safeSetObject:self.pluginVersion forKey:@"plugin_version"];
+        dictionary[@"sdk_version"] = BNC_SDK_VERSION;
+        dictionary[@"sdk"] = @"ios";
+
+        self.snapshot = dictionary;
+        return self.snapshot;
     }
 }
 
@@ -98,7 +172,7 @@
 }
 
 - (NSString *)localIPAddress {
-    return [BNCNetworkInterface localIPAddress];
+    return [[BNCReachability shared] localIPAddress];
 }
 
 - (NSString *)connectionType {
@@ -0,0 +1,641 @@
+//
+//  BNCKVStore.c
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#include "BNCKVStore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// MARK: - File format
+
+// File: header, then records up to header.used. The mapping beyond `used` is spare capacity.
+// Record: header, key bytes, value bytes, zero padding to 8 bytes.
+// Integers are in host byte order, the file never leaves the device.
+
+static const char BNCKVStoreMagic[8] = { 'B', 'N', 'C', 'K', 'V', '0', '0', '1' };
+
+typedef struct {
+    char magic[8];
+    uint64_t used;
+} BNCKVFileHeader;
+
+typedef struct {
+    uint32_t keyLength;
+    uint32_t valueLength;
+    uint8_t type;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t checksum;
+} BNCKVRecordHeader;
+
+enum {
+    BNCKVRecordFlagTombstone = 1,
+    BNCKVMinimumCapacity = 16 * 1024,
+    BNCKVMinimumIndexCapacity = 64
+};
+
+static size_t BNCKVRecordSize(size_t keyLength, size_t valueLength) {
+    return (sizeof(BNCKVRecordHeader) + keyLength + valueLength + 7) & ~(size_t)7;
+}
+
+// FNV-1a
+static uint32_t BNCKVChecksum32(uint32_t hash, const void *bytes, size_t length) {
+    const uint8_t *p = bytes;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint64_t BNCKVHash(const char *key, size_t keyLength) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < keyLength; i++) {
+        hash ^= (uint8_t)key[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint32_t BNCKVRecordChecksum(const BNCKVRecordHeader *header, const uint8_t *payload) {
+    BNCKVRecordHeader copy = *header;
+    copy.checksum = 0;
+    uint32_t hash = BNCKVChecksum32(2166136261u, &copy, sizeof(copy));
+    return BNCKVChecksum32(hash, payload, (size_t)header->keyLength + header->valueLength);
+}
+
+// MARK: - Store
+
+typedef struct {
+    uint64_t hash;
+    uint64_t offset;    // record offset, 0 is an empty slot
+} BNCKVIndexEntry;
+
+struct BNCKVStore {
+    char *path;
+    int fd;
+    uint8_t *map;
+    size_t capacity;
+    size_t used;
+
+    BNCKVIndexEntry *index;
+    size_t indexCapacity;  // power of two
+    size_t count;
+
+    size_t liveBytes;
+
+    bool batching;
+    size_t batchStart;
+
+    uint64_t generation;    // changes whenever the file is replaced or cleared
+};
+
+struct BNCKVCompaction {
+    char *tempPath;
+    int fd;
+    uint8_t *records;       // live records when the compaction began
+    size_t recordsLength;
+    size_t snapshotUsed;    // records appended after this are carried over by the finish
+    uint64_t generation;
+};
+
+static BNCKVFileHeader *BNCKVHeader(const BNCKVStore *store) {
+    return (BNCKVFileHeader *)store->map;
+}
+
+static const BNCKVRecordHeader *BNCKVRecordAt(const BNCKVStore *store, uint64_t offset) {
+    return (const BNCKVRecordHeader *)(store->map + offset);
+}
+
+static const char *BNCKVRecordKey(const BNCKVRecordHeader *record) {
+    return (const char *)(record + 1);
+}
+
+static size_t BNCKVRecordSizeAt(const BNCKVStore *store, uint64_t offset) {
+    const BNCKVRecordHeader *record = BNCKVRecordAt(store, offset);
+    return BNCKVRecordSize(record->keyLength, record->valueLength);
+}
+
+// MARK: - Index
+
+// Linear probing with backward shift deletion, so lookups never pass tombstones
+
+static size_t BNCKVIndexFind(const BNCKVStore *store, const char *key, size_t keyLength, uint64_t hash, bool *found) {
+    size_t mask = store->indexCapacity - 1;
+    size_t slot = (size_t)hash & mask;
+    while (store->index[slot].offset) {
+        const BNCKVIndexEntry *entry = &store->index[slot];
+        if (entry->hash == hash) {
+            const BNCKVRecordHeader *record = BNCKVRecordAt(store, entry->offset);
+            if (record->keyLength == keyLength && memcmp(BNCKVRecordKey(record), key, keyLength) == 0) {
+                *found = true;
+                return slot;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+    *found = false;
+    return slot;
+}
+
+static int BNCKVIndexResize(BNCKVStore *store, size_t capacity) {
+    BNCKVIndexEntry *index = calloc(capacity, sizeof(BNCKVIndexEntry));
+    if (!index) return ENOMEM;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < store->indexCapacity; i++) {
+        BNCKVIndexEntry entry = store->index[i];
+        if (!entry.offset) continue;
+        size_t slot = (size_t)entry.hash & mask;
+        while (index[slot].offset) {
+            slot = (slot + 1) & mask;
+        }
+        index[slot] = entry;
+    }
+    free(store->index);
+    store->index = index;
+    store->indexCapacity = capacity;
+    return 0;
+}
+
+static void BNCKVIndexRemoveSlot(BNCKVStore *store, size_t slot) {
+    size_t mask = store->indexCapacity - 1;
+    size_t hole = slot;
+    size_t next = (slot + 1) & mask;
+    while (store->index[next].offset) {
+        size_t home = (size_t)store->index[next].hash & mask;
+        // move the entry back if the hole lies between its home slot and where it is now
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            store->index[hole] = store->index[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    store->index[hole].offset = 0;
+    store->index[hole].hash = 0;
+    store->count--;
+}
+
+// Points the key at the record at `offset`, updating the live byte count.
+static int BNCKVIndexSet(BNCKVStore *store, uint64_t offset) {
+    if ((store->count + 1) * 10 >= store->indexCapacity * 7) {
+        int error = BNCKVIndexResize(store, store->indexCapacity * 2);
+        if (error) return error;
+    }
+
+    const BNCKVRecordHeader *record = BNCKVRecordAt(store, offset);
+    uint64_t hash = BNCKVHash(BNCKVRecordKey(record), record->keyLength);
+    bool found = false;
+    size_t slot = BNCKVIndexFind(store, BNCKVRecordKey(record), record->keyLength, hash, &found);
+    if (found) {
+        store->liveBytes -= BNCKVRecordSizeAt(store, store->index[slot].offset);
+    } else {
+        store->count++;
+    }
+    store->index[slot].hash = hash;
+    store->index[slot].offset = offset;
+    store->liveBytes += BNCKVRecordSize(record->keyLength, record->valueLength);
+    return 0;
+}
+
+static void BNCKVIndexRemove(BNCKVStore *store, const char *key, size_t keyLength) {
+    bool found = false;
+    size_t slot = BNCKVIndexFind(store, key, keyLength, BNCKVHash(key, keyLength), &found);
+    if (!found) return;
+    store->liveBytes -= BNCKVRecordSizeAt(store, store->index[slot].offset);
+    BNCKVIndexRemoveSlot(store, slot);
+}
+
+static void BNCKVIndexReset(BNCKVStore *store) {
+    if (!store->index) return;
+    memset(store->index, 0, store->indexCapacity * sizeof(BNCKVIndexEntry));
+    store->count = 0;
+    store->liveBytes = 0;
+}
+
+// MARK: - Mapping
+
+static size_t BNCKVRoundCapacity(size_t size) {
+    size_t capacity = BNCKVMinimumCapacity;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static void BNCKVUnmap(BNCKVStore *store) {
+    if (store->map) {
+        munmap(store->map, store->capacity);
+        store->map = NULL;
+    }
+}
+
+static int BNCKVMap(BNCKVStore *store, size_t capacity) {
+    BNCKVUnmap(store);
+    if (ftruncate(store->fd, (off_t)capacity) != 0) return errno;
+
+    void *map = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, store->fd, 0);
+    if (map == MAP_FAILED) return errno;
+    store->map = map;
+    store->capacity = capacity;
+    return 0;
+}
+
+static void BNCKVInitializeHeader(BNCKVStore *store) {
+    BNCKVFileHeader *header = BNCKVHeader(store);
+    memcpy(header->magic, BNCKVStoreMagic, sizeof(BNCKVStoreMagic));
+    header->used = sizeof(BNCKVFileHeader);
+    store->used = sizeof(BNCKVFileHeader);
+}
+
+// Rebuilds the index from the records, stopping at the first damaged one
+static int BNCKVLoad(BNCKVStore *store) {
+    BNCKVIndexReset(store);
+
+    BNCKVFileHeader *header = BNCKVHeader(store);
+    if (memcmp(header->magic, BNCKVStoreMagic, sizeof(BNCKVStoreMagic)) != 0 ||
+        header->used < sizeof(BNCKVFileHeader) || header->used > store->capacity) {
+        BNCKVInitializeHeader(store);
+        return 0;
+    }
+
+    uint64_t offset = sizeof(BNCKVFileHeader);
+    while (offset + sizeof(BNCKVRecordHeader) <= header->used) {
+        const BNCKVRecordHeader *record = BNCKVRecordAt(store, offset);
+        size_t size = BNCKVRecordSize(record->keyLength, record->valueLength);
+        if (offset + size > header->used || record->checksum != BNCKVRecordChecksum(record, (const uint8_t *)(record + 1))) {
+            break;
+        }
+
+        if (record->flags & BNCKVRecordFlagTombstone) {
+            BNCKVIndexRemove(store, BNCKVRecordKey(record), record->keyLength);
+        } else {
+            int error = BNCKVIndexSet(store, offset);
+            if (error) return error;
+        }
+        offset += size;
+    }
+    header->used = offset;
+    store->used = (size_t)offset;
+    return 0;
+}
+
+static int BNCKVOpenFile(BNCKVStore *store) {
+    BNCKVIndexReset(store);
+    store->used = 0;
+    store->fd = open(store->path, O_RDWR | O_CREAT, 0600);
+    if (store->fd < 0) return errno;
+
+    struct stat info;
+    if (fstat(store->fd, &info) != 0) return errno;
+
+    size_t size = (size_t)info.st_size;
+    int error = BNCKVMap(store, BNCKVRoundCapacity(size));
+    if (error) return error;
+    if (size < sizeof(BNCKVFileHeader)) {
+        BNCKVInitializeHeader(store);
+        return 0;
+    }
+    return BNCKVLoad(store);
+}
+
+static void BNCKVCloseFile(BNCKVStore *store) {
+    BNCKVUnmap(store);
+    if (store->fd >= 0) {
+        close(store->fd);
+        store->fd = -1;
+    }
+}
+
+// MARK: - Public
+
+BNCKVStore *BNCKVStoreOpen(const char *path, int *error) {
+    int result = 0;
+    BNCKVStore *store = calloc(1, sizeof(BNCKVStore));
+    if (!store) {
+        result = ENOMEM;
+        goto fail;
+    }
+    store->fd = -1;
+    store->path = strdup(path);
+    store->indexCapacity = BNCKVMinimumIndexCapacity;
+    store->index = calloc(store->indexCapacity, sizeof(BNCKVIndexEntry));
+    if (!store->path || !store->index) {
+        result = ENOMEM;
+        goto fail;
+    }
+
+    result = BNCKVOpenFile(store);
+    if (result) goto fail;
+    if (error) *error = 0;
+    return store;
+
+fail:
+    BNCKVStoreClose(store);
+    if (error) *error = result;
+    return NULL;
+}
+
+void BNCKVStoreClose(BNCKVStore *store) {
+    if (!store) return;
+    BNCKVCloseFile(store);
+    free(store->index);
+    free(store->path);
+    free(store);
+}
+
+static int BNCKVAppend(BNCKVStore *store, const char *key, size_t keyLength, uint8_t type, uint8_t flags, const void *value, size_t valueLength, uint64_t *offset) {
+    if (keyLength > UINT32_MAX || valueLength > UINT32_MAX) return EINVAL;
+
+    size_t size = BNCKVRecordSize(keyLength, valueLength);
+    if (store->used + size > store->capacity) {
+        int error = BNCKVMap(store, BNCKVRoundCapacity(store->used + size));
+        if (error) return error;
+    }
+
+    BNCKVRecordHeader *record = (BNCKVRecordHeader *)(store->map + store->used);
+    uint8_t *payload = (uint8_t *)(record + 1);
+    record->keyLength = (uint32_t)keyLength;
+    record->valueLength = (uint32_t)valueLength;
+    record->type = type;
+    record->flags = flags;
+    record->reserved = 0;
+    memcpy(payload, key, keyLength);
+    if (valueLength) memcpy(payload + keyLength, value, valueLength);
+    memset(payload + keyLength + valueLength, 0, size - sizeof(BNCKVRecordHeader) - keyLength - valueLength);
+    record->checksum = BNCKVRecordChecksum(record, payload);
+
+    // the record only counts once the header covers it, in a batch that is at the commit
+    *offset = store->used;
+    store->used += size;
+    if (!store->batching) BNCKVHeader(store)->used = store->used;
+    return 0;
+}
+
+int BNCKVStorePut(BNCKVStore *store, const char *key, size_t keyLength, uint8_t type, const void *value, size_t valueLength) {
+    if (!store || !store->map || !key || (valueLength && !value)) return EINVAL;
+
+    uint8_t currentType = 0;
+    const void *current = NULL;
+    size_t currentLength = 0;
+    if (BNCKVStoreGet(store, key, keyLength, &currentType, &current, &currentLength) &&
+        currentType == type && currentLength == valueLength && (valueLength == 0 || memcmp(current, value, valueLength) == 0)) {
+        return 0;
+    }
+
+    uint64_t offset = 0;
+    int error = BNCKVAppend(store, key, keyLength, type, 0, value, valueLength, &offset);
+    if (error) return error;
+    return BNCKVIndexSet(store, offset);
+}
+
+int BNCKVStoreDelete(BNCKVStore *store, const char *key, size_t keyLength) {
+    if (!store || !store->map || !key) return EINVAL;
+
+    bool found = false;
+    BNCKVIndexFind(store, key, keyLength, BNCKVHash(key, keyLength), &found);
+    if (!found) return 0;
+
+    uint64_t offset = 0;
+    int error = BNCKVAppend(store, key, keyLength, 0, BNCKVRecordFlagTombstone, NULL, 0, &offset);
+    if (error) return error;
+    BNCKVIndexRemove(store, key, keyLength);
+    return 0;
+}
+
+bool BNCKVStoreGet(const BNCKVStore *store, const char *key, size_t keyLength, uint8_t *type, const void **value, size_t *valueLength) {
+    if (!store || !store->map || !key) return false;
+
+    bool found = false;
+    size_t slot = BNCKVIndexFind(store, key, keyLength, BNCKVHash(key, keyLength), &found);
+    if (!found) return false;
+
+    const BNCKVRecordHeader *record = BNCKVRecordAt(store, store->index[slot].offset);
+    if (type) *type = record->type;
+    if (value) *value = (const uint8_t *)(record + 1) + record->keyLength;
+    if (valueLength) *valueLength = record->valueLength;
+    return true;
+}
+
+void BNCKVStoreEnumerate(const BNCKVStore *store, BNCKVStoreEnumerator enumerator, void *context) {
+    if (!store || !enumerator) return;
+    for (size_t i = 0; i < store->indexCapacity; i++) {
+        if (!store->index[i].offset) continue;
+        const BNCKVRecordHeader *record = BNCKVRecordAt(store, store->index[i].offset);
+        const char *key = BNCKVRecordKey(record);
+        enumerator(key, record->keyLength, record->type, key + record->keyLength, record->valueLength, context);
+    }
+}
+
+size_t BNCKVStoreCount(const BNCKVStore *store) {
+    return (store) ? store->count : 0;
+}
+
+size_t BNCKVStoreLiveBytes(const BNCKVStore *store) {
+    return (store) ? store->liveBytes : 0;
+}
+
+size_t BNCKVStoreGarbageBytes(const BNCKVStore *store) {
+    return (store) ? store->used - sizeof(BNCKVFileHeader) - store->liveBytes : 0;
+}
+
+bool BNCKVStoreNeedsCompaction(const BNCKVStore *store) {
+    size_t garbage = BNCKVStoreGarbageBytes(store);
+    return garbage >= BNCKVStoreCompactionMinGarbage && garbage > BNCKVStoreLiveBytes(store);
+}
+
+static int BNCKVWriteAll(int fd, const void *bytes, size_t length) {
+    const uint8_t *p = bytes;
+    while (length) {
+        ssize_t written = write(fd, p, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        p += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+void BNCKVCompactionFree(BNCKVCompaction *compaction) {
+    if (!compaction) return;
+    if (compaction->fd >= 0) {
+        close(compaction->fd);
+        unlink(compaction->tempPath);
+    }
+    free(compaction->tempPath);
+    free(compaction->records);
+    free(compaction);
+}
+
+BNCKVCompaction *BNCKVStoreCompactionBegin(BNCKVStore *store, int *error) {
+    int result = 0;
+    BNCKVCompaction *compaction = NULL;
+    if (!store || !store->map) {
+        result = EINVAL;
+        goto fail;
+    }
+    if (store->batching) {
+        result = EBUSY;
+        goto fail;
+    }
+
+    compaction = calloc(1, sizeof(BNCKVCompaction));
+    if (!compaction) {
+        result = ENOMEM;
+        goto fail;
+    }
+    compaction->fd = -1;
+    size_t pathLength = strlen(store->path);
+    compaction->tempPath = malloc(pathLength + sizeof(".compact"));
+    compaction->records = malloc(store->liveBytes ? store->liveBytes : 1);
+    if (!compaction->tempPath || !compaction->records) {
+        result = ENOMEM;
+        goto fail;
+    }
+    memcpy(compaction->tempPath, store->path, pathLength);
+    memcpy(compaction->tempPath + pathLength, ".compact", sizeof(".compact"));
+
+    for (size_t i = 0; i < store->indexCapacity; i++) {
+        uint64_t offset = store->index[i].offset;
+        if (!offset) continue;
+        size_t size = BNCKVRecordSizeAt(store, offset);
+        memcpy(compaction->records + compaction->recordsLength, store->map + offset, size);
+        compaction->recordsLength += size;
+    }
+    compaction->snapshotUsed = store->used;
+    compaction->generation = store->generation;
+    if (error) *error = 0;
+    return compaction;
+
+fail:
+    BNCKVCompactionFree(compaction);
+    if (error) *error = result;
+    return NULL;
+}
+
+int BNCKVCompactionWrite(BNCKVCompaction *compaction) {
+    if (!compaction || compaction->fd >= 0) return EINVAL;
+
+    compaction->fd = open(compaction->tempPath, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (compaction->fd < 0) return errno;
+
+    BNCKVFileHeader header;
+    memcpy(header.magic, BNCKVStoreMagic, sizeof(BNCKVStoreMagic));
+    header.used = sizeof(BNCKVFileHeader) + compaction->recordsLength;
+    int error = BNCKVWriteAll(compaction->fd, &header, sizeof(header));
+    if (!error) error = BNCKVWriteAll(compaction->fd, compaction->records, compaction->recordsLength);
+    if (!error && fsync(compaction->fd) != 0) error = errno;
+    return error;
+}
+
+int BNCKVStoreCompactionFinish(BNCKVStore *store, BNCKVCompaction *compaction) {
+    if (!store || !store->map || !compaction || compaction->fd < 0) return EINVAL;
+    if (store->batching) return EBUSY;
+    if (compaction->generation != store->generation || store->used < compaction->snapshotUsed) return ESTALE;
+
+    // carry over records appended since the snapshot, they replay in order on top of it
+    int error = 0;
+    size_t tailLength = store->used - compaction->snapshotUsed;
+    size_t used = sizeof(BNCKVFileHeader) + compaction->recordsLength + tailLength;
+    if (tailLength) {
+        BNCKVFileHeader header;
+        memcpy(header.magic, BNCKVStoreMagic, sizeof(BNCKVStoreMagic));
+        header.used = used;
+        error = BNCKVWriteAll(compaction->fd, store->map + compaction->snapshotUsed, tailLength);
+        if (!error && pwrite(compaction->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) error = (errno) ? errno : EIO;
+        if (!error && fsync(compaction->fd) != 0) error = errno;
+        if (error) return error;
+    }
+
+    // map and index the new file before it replaces the old one, so any failure leaves the store as it was
+    BNCKVStore fresh = {0};
+    fresh.path = store->path;
+    fresh.fd = compaction->fd;
+    fresh.indexCapacity = store->indexCapacity;
+    fresh.index = calloc(fresh.indexCapacity, sizeof(BNCKVIndexEntry));
+    if (!fresh.index) return ENOMEM;
+    error = BNCKVMap(&fresh, BNCKVRoundCapacity(used));
+    if (!error) error = BNCKVLoad(&fresh);
+    if (!error && rename(compaction->tempPath, store->path) != 0) error = errno;
+    if (error) {
+        BNCKVUnmap(&fresh);
+        free(fresh.index);
+        return error;
+    }
+
+    BNCKVCloseFile(store);
+    free(store->index);
+    store->fd = fresh.fd;
+    store->map = fresh.map;
+    store->capacity = fresh.capacity;
+    store->used = fresh.used;
+    store->index = fresh.index;
+    store->indexCapacity = fresh.indexCapacity;
+    store->count = fresh.count;
+    store->liveBytes = fresh.liveBytes;
+    store->generation++;
+
+    // the file now belongs to the store
+    compaction->fd = -1;
+    return 0;
+}
+
+int BNCKVStoreCompact(BNCKVStore *store) {
+    int error = 0;
+    BNCKVCompaction *compaction = BNCKVStoreCompactionBegin(store, &error);
+    if (!compaction) return error;
+    error = BNCKVCompactionWrite(compaction);
+    if (!error) error = BNCKVStoreCompactionFinish(store, compaction);
+    BNCKVCompactionFree(compaction);
+    return error;
+}
+
+int BNCKVStoreSync(BNCKVStore *store) {
+    if (!store || !store->map) return EINVAL;
+    if (msync(store->map, store->used, MS_SYNC) != 0) return errno;
+    return 0;
+}
+
+int BNCKVStoreClear(BNCKVStore *store) {
+    if (!store || !store->map) return EINVAL;
+    if (store->batching) return EBUSY;
+    BNCKVIndexReset(store);
+    BNCKVInitializeHeader(store);
+    store->generation++;
+    return BNCKVMap(store, BNCKVMinimumCapacity);
+}
+
+int BNCKVStoreBeginBatch(BNCKVStore *store) {
+    if (!store || !store->map) return EINVAL;
+    if (store->batching) return EBUSY;
+    store->batching = true;
+    store->batchStart = store->used;
+    return 0;
+}
+
+int BNCKVStoreCommitBatch(BNCKVStore *store) {
+    if (!store || !store->map || !store->batching) return EINVAL;
+    store->batching = false;
+    if (store->used == store->batchStart) return 0;
+
+    // The records reach the file before the header that publishes them. If the flush fails the header is still
+    // published so the process keeps its writes, a crash may then keep only a prefix of the batch.
+    int error = 0;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = store->batchStart & ~(page - 1);
+    if (msync(store->map + start, store->used - start, MS_SYNC) != 0) error = errno;
+    BNCKVHeader(store)->used = store->used;
+    return error;
+}
@@ -18,8 +18,61 @@
 // To translate security errors to text from the command line use: `security error -34018`
 #pragma mark - BNCKeyChain
 
+// Dates read from the keychain by service then key. A service is fetched with one SecItem call on first read
+// and kept up to date by writes through this class. NSNull marks an item that could not be decoded.
+// The cache is per process. Writes from another process sharing the access group, such as an App Clip or an
+// extension, or from iCloud keychain sync, are not seen until the cache is cleared or the app relaunches.
+static NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id> *> *bnc_keychainCache = nil;
+
+// Items read one at a time while the batch read of their service is backed off, by service then key
+static NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id> *> *bnc_keychainItemCache = nil;
+
+// When a failed batch read of a service may be tried again, by service
+static NSMutableDictionary<NSString *, NSDate *> *bnc_keychainBatchRetryDates = nil;
+static NSTimeInterval const BNCKeyChainBatchRetryInterval = 60.0;
+
+static NSUInteger bnc_keychainRoundTrips = 0;
+
 @implementation BNCKeyChain
 
++ (void)initialize {
+    if (self != [BNCKeyChain class]) return;
+    bnc_keychainCache = [NSMutableDictionary new];
+    bnc_keychainItemCache = [NSMutableDictionary new];
+    bnc_keychainBatchRetryDates = [NSMutableDictionary new];
+}
+
++ (NSUInteger)roundTripCount {
+    @synchronized (self) {
+        return bnc_keychainRoundTrips;
+    }
+}
+
++ (void)clearCache {
+    @synchronized (self) {
+        [bnc_keychainCache removeAllObjects];
+        [bnc_keychainItemCache removeAllObjects];
+        [bnc_keychainBatchRetryDates removeAllObjects];
+    }
+}
+
+// callers hold the lock
++ (void)deferBatchReadForService:(NSString *)service {
+    bnc_keychainBatchRetryDates[service] = [NSDate dateWithTimeIntervalSinceNow:BNCKeyChainBatchRetryInterval];
+}
+
+// callers hold the lock
++ (void)removeCachedService:(NSString *)service {
+    [bnc_keychainCache removeObjectForKey:service];
+    [bnc_keychainItemCache removeObjectForKey:service];
+}
+
+// callers hold the lock
++ (void)countRoundTrip {
+    bnc_keychainRoundTrips++;
+    [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"Keychain round trips %lu", (unsigned long)bnc_keychainRoundTrips] error:nil];
+}
+
 // Wraps OSStatus in an NSError
 // Security errors are defined in Security/SecBase.h
 + (NSError *) errorWithKey:(NSString *)key OSStatus:(OSStatus)status {
@@ -46,6 +99,97 @@
         return nil;
     }
 
+    @synchronized (self) {
+        OSStatus status = errSecSuccess;
+        NSDictionary<NSString *, id> *items = [self itemsForService:service status:&status];
+        id value = items[key];
+        if (!items) {
+            // the batch read failed or is backed off, read the one item and keep it until a batch read succeeds
+            value = bnc_keychainItemCache[service][key];
+            if (!value) {
+                NSError *localError = nil;
+                value = [self fetchDateForService:service key:key error:&localError];
+                if (localError.code == errSecDecode) value = [NSNull null];
+                if (!value) {
+                    if (error) *error = localError;
+                    return nil;
+                }
+                if (!bnc_keychainItemCache[service]) bnc_keychainItemCache[service] = [NSMutableDictionary new];
+                bnc_keychainItemCache[service][key] = value;
+            }
+        }
+
+        if (!value) {
+            NSError *localError = [self errorWithKey:key OSStatus:errSecItemNotFound];
+            [[BranchLogger shared] logVerbose:@"Key not found" error:localError];
+            if (error) *error = localError;
+            return nil;
+        }
+        if (value == [NSNull null]) {
+            if (error) *error = [self errorWithKey:key OSStatus:errSecDecode];
+            return nil;
+        }
+        return value;
+    }
+}
+
+// callers hold the lock
++ (NSDictionary<NSString *, id> *)itemsForService:(NSString *)service status:(OSStatus *)statusOut {
+    NSMutableDictionary<NSString *, id> *items = bnc_keychainCache[service];
+    if (items) return items;
+
+    NSDate *retryDate = bnc_keychainBatchRetryDates[service];
+    if (retryDate && [retryDate timeIntervalSinceNow] > 0) return nil;
+
+    NSDictionary* dictionary = @{
+        (__bridge id)kSecClass:                 (__bridge id)kSecClassGenericPassword,
+        (__bridge id)kSecAttrService:           service,
+        (__bridge id)kSecReturnAttributes:      (__bridge id)kCFBooleanTrue,
+        (__bridge id)kSecReturnData:            (__bridge id)kCFBooleanTrue,
+        (__bridge id)kSecMatchLimit:            (__bridge id)kSecMatchLimitAll,
+        (__bridge id)kSecAttrSynchronizable:    (__bridge id)kSecAttrSynchronizableAny
+    };
+    CFArrayRef result = NULL;
+    [self countRoundTrip];
+    OSStatus status = SecItemCopyMatching((__bridge CFDictionaryRef)dictionary, (CFTypeRef *)&result);
+    if (status != errSecSuccess && status != errSecItemNotFound) {
+        [[BranchLogger shared] logVerbose:@"Failed to read keychain items" error:[self errorWithKey:nil OSStatus:status]];
+        if (statusOut) *statusOut = status;
+        if (result) CFRelease(result);
+        [self deferBatchReadForService:service];
+        return nil;
+    }
+
+    items = [NSMutableDictionary new];
+    NSArray *results = (__bridge NSArray *)result;
+    if ([results isKindOfClass:NSArray.class]) {
+        for (NSDictionary *item in results) {
+            if (![item isKindOfClass:NSDictionary.class]) continue;
+            NSString *account = item[(__bridge id)kSecAttrAccount];
+            NSData *data = item[(__bridge id)kSecValueData];
+            if (![account isKindOfClass:NSString.class] || ![data isKindOfClass:NSData.class]) continue;
+            items[account] = [self dateFromData:data] ?: [NSNull null];
+        }
+    }
+    if (result) CFRelease(result);
+    bnc_keychainCache[service] = items;
+    [bnc_keychainItemCache removeObjectForKey:service];
+    [bnc_keychainBatchRetryDates removeObjectForKey:service];
+    return items;
+}
+
++ (NSDate *)dateFromData:(NSData *)data {
+    NSDate *value = nil;
+    @try {
+        value = [NSKeyedUnarchiver unarchivedObjectOfClass:[NSDate class] fromData:data error:NULL];
+    } @catch (NSException *exception) {
+        value = nil;
+    }
+    return value;
+}
+
+// callers hold the lock
++ (NSDate *)fetchDateForService:(NSString *)service key:(NSString *)key error:(NSError **)error {
     NSDictionary* dictionary = @{
         (__bridge id)kSecClass:                 (__bridge id)kSecClassGenericPassword,
         (__bridge id)kSecAttrService:           service,
@@ -55,6 +199,7 @@
         (__bridge id)kSecAttrSynchronizable:    (__bridge id)kSecAttrSynchronizableAny
     };
     CFDataRef valueData = NULL;
+    [self countRoundTrip];
     OSStatus status = SecItemCopyMatching((__bridge CFDictionaryRef)dictionary, (CFTypeRef *)&valueData);
     if (status != errSecSuccess) {
         NSError *localError = [self errorWithKey:key OSStatus:status];
@@ -64,15 +209,10 @@
         if (valueData) CFRelease(valueData);
         return nil;
     }
-    id value = nil;
+    NSDate *value = nil;
     if (valueData) {
-        @try {
-            value = [NSKeyedUnarchiver unarchivedObjectOfClass:[NSDate class] fromData:(__bridge NSData*)valueData error:NULL];
-        } @catch (NSException *exception) {
-            value = nil;
-            NSError *localError = [self errorWithKey:key OSStatus:errSecDecode];
-            if (error) *error = localError;
-        }
+        value = [self dateFromData:(__bridge NSData *)valueData];
+        if (!value && error) *error = [self errorWithKey:key OSStatus:errSecDecode];
         CFRelease(valueData);
     }
     return value;
@@ -104,6 +244,22 @@
         (__bridge id)kSecAttrAccount:           key,
         (__bridge id)kSecAttrSynchronizable:    (__bridge id)kSecAttrSynchronizableAny
     }];
+
+    @synchronized (self) {
+        NSError *error = [self replaceItem:dictionary data:valueData accessGroup:accessGroup key:key];
+        if (error) {
+            [self removeCachedService:service];
+        } else {
+            bnc_keychainCache[service][key] = date;
+            bnc_keychainItemCache[service][key] = date;
+        }
+        return error;
+    }
+}
+
+// callers hold the lock
++ (NSError *)replaceItem:(NSMutableDictionary *)dictionary data:(NSData *)valueData accessGroup:(NSString *)accessGroup key:(NSString *)key {
+    [self countRoundTrip];
     OSStatus status = SecItemDelete((__bridge CFDictionaryRef)dictionary);
     if (status != errSecSuccess && status != errSecItemNotFound) {
         NSError *error = [self errorWithKey:key OSStatus:status];
@@ -120,6 +276,7 @@
     } else {
         dictionary[(__bridge id)kSecAttrSynchronizable] = (__bridge id) kCFBooleanFalse;
     }
+    [self countRoundTrip];
     status = SecItemAdd((__bridge CFDictionaryRef)dictionary, NULL);
     if (status) {
         NSError *error = [self errorWithKey:key OSStatus:status];
@@ -137,7 +294,17 @@
     if (service) dictionary[(__bridge id)kSecAttrService] = service;
     if (key) dictionary[(__bridge id)kSecAttrAccount] = key;
 
-    OSStatus status = SecItemDelete((__bridge CFDictionaryRef)dictionary);
+    OSStatus status = errSecSuccess;
+    @synchronized (self) {
+        [self countRoundTrip];
+        status = SecItemDelete((__bridge CFDictionaryRef)dictionary);
+        if (service) {
+            [self removeCachedService:service];
+        } else {
+            [bnc_keychainCache removeAllObjects];
+            [bnc_keychainItemCache removeAllObjects];
+        }
+    }
     if (status == errSecItemNotFound) status = errSecSuccess;
     if (status) {
         NSError *error = [self errorWithKey:key OSStatus:status];
@@ -167,6 +334,9 @@
             (__bridge id)kSecMatchLimit:            (__bridge id)kSecMatchLimitOne
         };
         CFDictionaryRef resultDictionary = NULL;
+        @synchronized (self) {
+            [self countRoundTrip];
+        }
         OSStatus status = SecItemCopyMatching((__bridge CFDictionaryRef)dictionary, (CFTypeRef*)&resultDictionary);
         
         if (status == errSecItemNotFound) { 
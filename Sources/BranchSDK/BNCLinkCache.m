@@ -8,38 +8,327 @@
 
 
 #import "BNCLinkCache.h"
+#import "BNCPreferenceHelper.h"
+#import "BNCEncodingUtils.h"
+#import "BranchLogger.h"
 
+static NSUInteger const BNCLinkCacheDefaultCountLimit = 128;
+static NSUInteger const BNCLinkCacheDefaultTotalBytesLimit = 64 * 1024;
+static NSTimeInterval const BNCLinkCacheDefaultTimeToLive = 7 * 24 * 60 * 60;
+
+// Delay used to coalesce several cache updates into a single file write
+static NSTimeInterval const BNCLinkCachePersistDelay = 1.0;
+
+static NSString * const BNCLinkCacheFileName = @"BNCLinkCache";
+static NSString * const BNCLinkCacheFileVersionKey = @"v";
+static NSString * const BNCLinkCacheFileContextKey = @"c";
+static NSString * const BNCLinkCacheFileEntriesKey = @"e";
+static NSInteger const BNCLinkCacheFileVersion = 2;
+
+#pragma mark - BNCLinkCacheEntry
+
+@interface BNCLinkCacheEntry : NSObject
+@property (nonatomic, copy) NSString *url;
+
+// canonical JSON of the link data, compared on lookup so a digest collision is a miss
+@property (nonatomic, copy) NSString *linkJSON;
+@property (nonatomic, assign) NSTimeInterval expiration;
+@property (nonatomic, assign) NSUInteger cost;
+@end
+
+@implementation BNCLinkCacheEntry
+@end
+
+#pragma mark - BNCLinkCache
 
 @interface BNCLinkCache ()
-@property (nonatomic, strong) NSMutableDictionary *cache;
+
+// key is the SHA-256 of the link data's canonical JSON, the ordered set tracks use from least to most recent
+@property (nonatomic, strong) NSMutableDictionary<NSString *, BNCLinkCacheEntry *> *cache;
+@property (nonatomic, strong) NSMutableOrderedSet<NSString *> *recentKeys;
+
+@property (nonatomic, copy) NSURL *storageURL;
+@property (nonatomic, copy) NSString *context;
+@property (nonatomic, assign) BOOL loaded;
+@property (nonatomic, assign) BOOL persistScheduled;
+@property (nonatomic, strong) dispatch_queue_t persistQueue;
+
+@property (assign, nonatomic, readwrite) NSUInteger totalBytes;
+@property (assign, nonatomic, readwrite) NSUInteger hitCount;
+@property (assign, nonatomic, readwrite) NSUInteger missCount;
+
 @end
 
 
 @implementation BNCLinkCache
 
 - (id)init {
+    return [self initWithStorageURL:nil];
+}
+
+- (instancetype)initWithStorageURL:(NSURL *)storageURL {
     if ((self = [super init])) {
         self.cache = [[NSMutableDictionary alloc] init];
+        self.recentKeys = [[NSMutableOrderedSet alloc] init];
+        self.storageURL = storageURL;
+        self.loaded = (storageURL == nil);
+        self.persistQueue = dispatch_queue_create("io.branch.sdk.linkcache", DISPATCH_QUEUE_SERIAL);
+        _countLimit = BNCLinkCacheDefaultCountLimit;
+        _totalBytesLimit = BNCLinkCacheDefaultTotalBytesLimit;
+        _timeToLive = BNCLinkCacheDefaultTimeToLive;
     }
     return self;
 }
 
++ (NSURL *)defaultStorageURL {
+    return [BNCURLForBranchDirectory() URLByAppendingPathComponent:BNCLinkCacheFileName isDirectory:NO];
+}
+
+#pragma mark - Cache access
+
 - (void)setObject:(NSString *)anObject forKey:(BNCLinkData *)aKey {
+    NSString *linkJSON = [aKey canonicalJSONString];
+    if (!linkJSON) return;
+    NSString *key = [BNCEncodingUtils sha256Encode:linkJSON];
     @synchronized (self) {
-        self.cache[@([aKey hash])] = anObject;
+        [self loadIfNeeded];
+        [self removeEntryForKey:key];
+        if (anObject) {
+            BNCLinkCacheEntry *entry = [BNCLinkCacheEntry new];
+            entry.url = anObject;
+            entry.linkJSON = linkJSON;
+            entry.expiration = [NSDate date].timeIntervalSince1970 + self.timeToLive;
+            entry.cost = [self costForURL:anObject linkJSON:linkJSON];
+            self.cache[key] = entry;
+            [self.recentKeys addObject:key];
+            self.totalBytes += entry.cost;
+            [self evictToLimits];
+        }
+        [self schedulePersist];
     }
 }
 
 - (NSString *)objectForKey:(BNCLinkData *)aKey {
+    NSString *linkJSON = [aKey canonicalJSONString];
+    if (!linkJSON) return nil;
+    NSString *key = [BNCEncodingUtils sha256Encode:linkJSON];
     @synchronized (self) {
-        return self.cache[@([aKey hash])];
+        [self loadIfNeeded];
+        BNCLinkCacheEntry *entry = self.cache[key];
+        if (entry && ![entry.linkJSON isEqualToString:linkJSON]) {
+            entry = nil;
+        } else if (entry && entry.expiration <= [NSDate date].timeIntervalSince1970) {
+            [self removeEntryForKey:key];
+            [self schedulePersist];
+            entry = nil;
+        }
+        if (!entry) {
+            self.missCount++;
+            return nil;
+        }
+        self.hitCount++;
+        [self.recentKeys removeObject:key];
+        [self.recentKeys addObject:key];
+        return entry.url;
     }
 }
 
 - (void) clear {
     @synchronized (self) {
         [self.cache removeAllObjects];
+        [self.recentKeys removeAllObjects];
+        self.totalBytes = 0;
+        self.loaded = YES;
+        [self schedulePersist];
+    }
+}
+
+- (void)updateContextWithBranchKey:(NSString *)branchKey userUrl:(NSString *)userUrl {
+    NSString *context = [NSString stringWithFormat:@"%@|%@", branchKey ?: @"", userUrl ?: @""];
+    @synchronized (self) {
+        if ([self.context isEqualToString:context]) return;
+
+        // A context seen for the first time only validates what is loaded from disk
+        BOOL hadContext = (self.context != nil);
+        self.context = context;
+        if (hadContext && self.cache.count) {
+            [[BranchLogger shared] logVerbose:@"Branch key or user URL changed, clearing link cache" error:nil];
+            [self clear];
+        }
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return self.cache.count;
+    }
+}
+
+- (void)setCountLimit:(NSUInteger)countLimit {
+    @synchronized (self) {
+        _countLimit = countLimit;
+        [self evictToLimits];
+    }
+}
+
+- (void)setTotalBytesLimit:(NSUInteger)totalBytesLimit {
+    @synchronized (self) {
+        _totalBytesLimit = totalBytesLimit;
+        [self evictToLimits];
+    }
+}
+
+#pragma mark - Statistics
+
+- (double)hitRate {
+    @synchronized (self) {
+        NSUInteger lookups = self.hitCount + self.missCount;
+        return (lookups) ? (double) self.hitCount / (double) lookups : 0.0;
     }
 }
 
+- (void)resetStatistics {
+    @synchronized (self) {
+        self.hitCount = 0;
+        self.missCount = 0;
+    }
+}
+
+#pragma mark - Eviction
+
+// callers hold the lock
+- (void)removeEntryForKey:(NSString *)key {
+    BNCLinkCacheEntry *entry = self.cache[key];
+    if (entry) {
+        self.totalBytes -= entry.cost;
+        [self.cache removeObjectForKey:key];
+        [self.recentKeys removeObject:key];
+    }
+}
+
+// callers hold the lock
+- (void)evictToLimits {
+    while (self.recentKeys.count &&
+           (self.cache.count > self.countLimit || self.totalBytes > self.totalBytesLimit)) {
+        [self removeEntryForKey:self.recentKeys.firstObject];
+    }
+}
+
+- (NSUInteger)costForURL:(NSString *)url linkJSON:(NSString *)linkJSON {
+    return [url lengthOfBytesUsingEncoding:NSUTF8StringEncoding] + [linkJSON lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+}
+
+#pragma mark - Persistence
+
+// callers hold the lock
+- (void)loadIfNeeded {
+    if (self.loaded) return;
+    self.loaded = YES;
+
+    NSData *data = [NSData dataWithContentsOfURL:self.storageURL];
+    if (!data) return;
+
+    NSDictionary *file = nil;
+    @try {
+        file = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    } @catch (NSException *exception) {
+        [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Exception reading link cache: %@.", exception] error:nil];
+    }
+    if (![file isKindOfClass:NSDictionary.class] ||
+        ![file[BNCLinkCacheFileVersionKey] isEqual:@(BNCLinkCacheFileVersion)]) {
+        return;
+    }
+
+    // Links from a different Branch key or user URL are stale
+    NSString *fileContext = file[BNCLinkCacheFileContextKey];
+    if (self.context && ![self.context isEqual:fileContext]) {
+        [self schedulePersist];
+        return;
+    }
+    if (!self.context && [fileContext isKindOfClass:NSString.class]) {
+        self.context = fileContext;
+    }
+
+    NSTimeInterval now = [NSDate date].timeIntervalSince1970;
+    NSArray *entries = file[BNCLinkCacheFileEntriesKey];
+    if (![entries isKindOfClass:NSArray.class]) return;
+
+    // entries are stored from least to most recently used
+    for (NSArray *record in entries) {
+        if (![record isKindOfClass:NSArray.class] || record.count != 3) continue;
+        NSString *linkJSON = record[0];
+        NSString *url = record[1];
+        NSNumber *expiration = record[2];
+        if (![linkJSON isKindOfClass:NSString.class] ||
+            ![url isKindOfClass:NSString.class] ||
+            ![expiration isKindOfClass:NSNumber.class] ||
+            expiration.doubleValue <= now) {
+            continue;
+        }
+        NSString *key = [BNCEncodingUtils sha256Encode:linkJSON];
+        BNCLinkCacheEntry *entry = [BNCLinkCacheEntry new];
+        entry.url = url;
+        entry.linkJSON = linkJSON;
+        entry.expiration = expiration.doubleValue;
+        entry.cost = [self costForURL:url linkJSON:linkJSON];
+        [self removeEntryForKey:key];
+        self.cache[key] = entry;
+        [self.recentKeys addObject:key];
+        self.totalBytes += entry.cost;
+    }
+    [self evictToLimits];
+}
+
+// callers hold the lock
+- (void)schedulePersist {
+    if (!self.storageURL || self.persistScheduled) return;
+    self.persistScheduled = YES;
+
+    __weak BNCLinkCache *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(BNCLinkCachePersistDelay * NSEC_PER_SEC)), self.persistQueue, ^{
+        [weakSelf persist];
+    });
+}
+
+- (void)persist {
+    NSData *data = nil;
+    NSURL *storageURL = nil;
+    @synchronized (self) {
+        if (!self.persistScheduled) return;
+        self.persistScheduled = NO;
+        storageURL = self.storageURL;
+
+        if (self.cache.count) {
+            NSMutableArray *entries = [NSMutableArray arrayWithCapacity:self.cache.count];
+            for (NSString *key in self.recentKeys) {
+                BNCLinkCacheEntry *entry = self.cache[key];
+                [entries addObject:@[ entry.linkJSON, entry.url, @(entry.expiration) ]];
+            }
+            NSDictionary *file = @{
+                BNCLinkCacheFileVersionKey: @(BNCLinkCacheFileVersion),
+                BNCLinkCacheFileContextKey: self.context ?: @"",
+                BNCLinkCacheFileEntriesKey: entries
+            };
+            data = [NSPropertyListSerialization dataWithPropertyList:file format:NSPropertyListBinaryFormat_v1_0 options:0 error:NULL];
+        }
+    }
+
+    NSError *error = nil;
+    if (data) {
+        [data writeToURL:storageURL options:NSDataWritingAtomic error:&error];
+    } else if ([[NSFileManager defaultManager] fileExistsAtPath:storageURL.path]) {
+        [[NSFileManager defaultManager] removeItemAtURL:storageURL error:&error];
+    }
+    if (error) {
+        [[BranchLogger shared] logWarning:@"Failed to persist link cache" error:error];
+    }
+}
+
+- (void)synchronize {
+    if (!self.storageURL) return;
+    dispatch_sync(self.persistQueue, ^{
+        [self persist];
+    });
+}
+
 @end
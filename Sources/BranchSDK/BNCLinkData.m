@@ -137,6 +137,17 @@
     return result;
 }
 
+- (NSString *)canonicalJSONString {
+    if (![NSJSONSerialization isValidJSONObject:self.data]) return nil;
+    NSData *json = [NSJSONSerialization dataWithJSONObject:self.data options:NSJSONWritingSortedKeys error:NULL];
+    return (json) ? [[NSString alloc] initWithData:json encoding:NSUTF8StringEncoding] : nil;
+}
+
+- (NSString *)digest {
+    NSString *json = [self canonicalJSONString];
+    return (json) ? [BNCEncodingUtils sha256Encode:json] : nil;
+}
+
 - (void)encodeWithCoder:(NSCoder *)coder {
     if (self.tags) {
         [coder encodeObject:self.tags forKey:BRANCH_REQUEST_KEY_URL_TAGS];
@@ -7,6 +7,10 @@
 //
 
 #import "BNCPreferenceHelper.h"
+#import "BNCPreferenceStore.h"
+#import "BNCContentAnalyticsStore.h"
+#import "BNCTimingRing.h"
+#import "BNCTrace.h"
 #import "BNCEncodingUtils.h"
 #import "BNCConfig.h"
 #import "Branch.h"
@@ -15,6 +19,8 @@
 #import "NSString+Branch.h"
 #import "BNCSKAdNetwork.h"
 
+#include <stdatomic.h>
+
 static const NSTimeInterval DEFAULT_TIMEOUT = 5.5;
 static const NSTimeInterval DEFAULT_THIRD_PARTY_APIS_TIMEOUT = 0.5; // 500ms default
 static const NSTimeInterval DEFAULT_RETRY_INTERVAL = 0;
@@ -75,22 +81,53 @@ static NSString * const BRANCH_PREFS_KEY_ATTRIBUTION_LEVEL = @"bnc_attribution_l
 static NSString * const BRANCH_PREFS_KEY_UX_TYPE = @"bnc_ux_type";
 static NSString * const BRANCH_PREFS_KEY_URL_LOAD_MS = @"bnc_url_load_ms";
 
+// Changes within this window are serialized and written once
+static NSTimeInterval const BNCPreferencePersistDelay = 0.5;
+
 NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 
 @interface BNCPreferenceHelper () {
     NSOperationQueue *_persistPrefsQueue;
+    atomic_int        _trackingDisabledState;   // checked on every request, -1 until read from storage
     NSString         *_lastSystemBuildVersion;
     NSString         *_browserUserAgentString;
-    NSString         *_referringURL;
 }
 
 @property (strong, nonatomic) NSMutableDictionary *persistenceDict;
+
+// Immutable copies for readers, republished by each writer so reads never wait on the @synchronized monitor
+@property (strong, atomic) NSDictionary *prefsSnapshot;
+@property (strong, atomic) NSDictionary *instrumentationSnapshot;
+
+// Round trip times of every request, summarized per endpoint into the instrumentation parameters
+@property (nonatomic, assign) BNCTimingRing *roundTripTimes;
+@property (strong, atomic) NSDictionary<NSNumber *, NSString *> *endpointNames;
 @property (strong, nonatomic) NSMutableDictionary *requestMetadataDictionary;
 @property (strong, nonatomic) NSMutableDictionary *instrumentationDictionary;
 
 // unit tests run in parallel, causing issues with data stored to disk
 @property (nonatomic, assign, readwrite) BOOL useStorage;
 
+// nil when the store cannot be opened, preferences are then archived to URLForPrefsFile
+@property (nonatomic, strong) BNCPreferenceStore *preferenceStore;
+@property (nonatomic, strong) BNCContentAnalyticsStore *contentAnalyticsStore;
+
+// Background load started by preloadPersistenceDict, the first reader waits on the group if it is still running
+@property (nonatomic, strong) dispatch_group_t loadGroup;
+@property (nonatomic, strong) NSMutableDictionary *loadedPersistenceDict;
+@property (atomic, assign, readwrite) NSTimeInterval loadBlockedTime;
+
+// keys in persistenceDict changed since the last flush, and whether a flush is scheduled for them
+@property (nonatomic, strong) NSMutableSet<NSString *> *dirtyKeys;
+@property (nonatomic, assign) BOOL persistScheduled;
+
+// nesting depth of performBatchUpdates:, the outermost call flushes
+@property (nonatomic, assign) NSUInteger batchDepth;
+
+// persistence counters, for benchmarks
+@property (nonatomic, assign) NSUInteger persistCount;
+@property (nonatomic, assign) NSUInteger bytesWritten;
+
 @end
 
 @implementation BNCPreferenceHelper
@@ -147,6 +184,7 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
         
         // the shared version read/writes data to storage
         preferenceHelper.useStorage = YES;
+        [preferenceHelper preloadPersistenceDict];
     });
     
     return preferenceHelper;
@@ -163,6 +201,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
         _isDebug = NO;
         _persistPrefsQueue = [[NSOperationQueue alloc] init];
         _persistPrefsQueue.maxConcurrentOperationCount = 1;
+        _dirtyKeys = [NSMutableSet new];
+        atomic_init(&_trackingDisabledState, -1);
+        _roundTripTimes = BNCTimingRingCreate(BNCTimingRingDefaultCapacity);
 
         self.disableAdNetworkCallouts = NO;
         self.useStorage = NO;
@@ -171,11 +212,13 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (void) synchronize {
+    [self flush];
     [_persistPrefsQueue waitUntilAllOperationsAreFinished];
 }
 
 - (void) dealloc {
     [self synchronize];
+    BNCTimingRingRelease(_roundTripTimes);
 }
 
 #pragma mark - API methods
@@ -183,6 +226,10 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 - (void)setPatternListURL:(NSString *)url {
     if ([url hasPrefix:@"http://"] || [url hasPrefix:@"https://"] ){
         @synchronized (self) {
+            // the saved ETag is for a list on the old host
+            if (![url isEqualToString:self.patternListURL]) {
+                [self writeObjectToDefaults:@"URLPatternListETag" value:nil];
+            }
             _patternListURL = url;
             [self writeObjectToDefaults:BRANCH_PREFS_KEY_PATTERN_LIST_URL value:url];
         }
@@ -341,34 +388,24 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSString *)externalIntentURI {
-    @synchronized(self) {
-        if (!_externalIntentURI) {
-            _externalIntentURI = [self readStringFromDefaults:BRANCH_REQUEST_KEY_EXTERNAL_INTENT_URI];
-        }
-        return _externalIntentURI;
-    }
+    return [self readStringFromDefaults:BRANCH_REQUEST_KEY_EXTERNAL_INTENT_URI];
 }
 
 - (void)setExternalIntentURI:(NSString *)externalIntentURI {
     @synchronized(self) {
-        if (externalIntentURI == nil || ![_externalIntentURI isEqualToString:externalIntentURI]) {
-            _externalIntentURI = externalIntentURI;
+        if (externalIntentURI == nil || ![self.externalIntentURI isEqualToString:externalIntentURI]) {
             [self writeObjectToDefaults:BRANCH_REQUEST_KEY_EXTERNAL_INTENT_URI value:externalIntentURI];
         }
     }
 }
 
 - (NSString*) referringURL {
-    @synchronized (self) {
-        if (!_referringURL) _referringURL = [self readStringFromDefaults:@"referringURL"];
-        return _referringURL;
-    }
+    return [self readStringFromDefaults:@"referringURL"];
 }
 
 - (void) setReferringURL:(NSString *)referringURL {
     @synchronized (self) {
-        _referringURL = [referringURL copy];
-        [self writeObjectToDefaults:@"referringURL" value:_referringURL];
+        [self writeObjectToDefaults:@"referringURL" value:[referringURL copy]];
     }
 }
 
@@ -397,19 +434,13 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSString *)sessionParams {
-    @synchronized (self) {
-        if (!_sessionParams) {
-            _sessionParams = [self readStringFromDefaults:BRANCH_PREFS_KEY_SESSION_PARAMS];
-        }
-        return _sessionParams;
-    }
+    return [self readStringFromDefaults:BRANCH_PREFS_KEY_SESSION_PARAMS];
 }
 
 - (void)setSessionParams:(NSString *)sessionParams {
     @synchronized (self) {
         [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"Setting session params %@", sessionParams] error:nil];
-        if (sessionParams == nil || ![_sessionParams isEqualToString:sessionParams]) {
-            _sessionParams = sessionParams;
+        if (sessionParams == nil || ![self.sessionParams isEqualToString:sessionParams]) {
             [self writeObjectToDefaults:BRANCH_PREFS_KEY_SESSION_PARAMS value:sessionParams];
             [[BranchLogger shared] logVerbose:@"Params set" error:nil];
         }
@@ -550,12 +581,69 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSDictionary *)instrumentationParameters {
-    @synchronized (self) {
-        if (_instrumentationDictionary.count == 0) {
-            return nil; // this avoids the .count check in prepareParamDict
+    return [self instrumentationParametersConsumingRoundTripTimes:NO];
+}
+
+- (NSDictionary *)takeInstrumentationParameters {
+    return [self instrumentationParametersConsumingRoundTripTimes:YES];
+}
+
+static void BNCCollectTimingSummary(const BNCTimingSummary *summary, void *context) {
+    NSMutableArray *summaries = (__bridge NSMutableArray *)context;
+    [summaries addObject:[NSValue valueWithBytes:summary objCType:@encode(BNCTimingSummary)]];
+}
+
+- (NSDictionary *)instrumentationParametersConsumingRoundTripTimes:(BOOL)consume {
+    // the result is nil when empty, this avoids the .count check in prepareParamDict
+    NSDictionary *snapshot = self.instrumentationSnapshot;
+    if (BNCTimingRingPendingCount(self.roundTripTimes) == 0) {
+        return snapshot;
+    }
+
+    NSMutableArray *summaries = [NSMutableArray new];
+    uint64_t dropped = 0;
+    BNCTimingRingSummarize(self.roundTripTimes, consume, BNCCollectTimingSummary, (__bridge void *)summaries, &dropped);
+
+    NSDictionary<NSNumber *, NSString *> *endpointNames = self.endpointNames;
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionaryWithDictionary:snapshot ?: @{}];
+    for (NSValue *value in summaries) {
+        BNCTimingSummary summary;
+        [value getValue:&summary];
+        NSString *endpoint = endpointNames[@(summary.endpoint)];
+        if (!endpoint) continue;
+
+        // brtt keeps the format of the single round trip time sent before summaries
+        parameters[[NSString stringWithFormat:@"%@-brtt", endpoint]] = [@(summary.last) stringValue];
+        parameters[[NSString stringWithFormat:@"%@-brtt-summary", endpoint]] = @{
+            @"count": @(summary.count),
+            @"min": @(summary.min),
+            @"p50": @(summary.p50),
+            @"p90": @(summary.p90),
+            @"p99": @(summary.p99),
+            @"max": @(summary.max)
+        };
+    }
+    if (dropped > 0) {
+        parameters[@"brtt-dropped"] = [@(dropped) stringValue];
+    }
+    return (parameters.count > 0) ? parameters : nil;
+}
+
+- (void)addRoundTripTime:(NSTimeInterval)milliseconds forEndpoint:(NSString *)endpoint {
+    if (!endpoint) return;
+    const char *name = endpoint.UTF8String;
+    uint32_t endpointID = BNCTimingRingEndpointID(name, strlen(name));
+
+    // names are published before the first record for the endpoint, so a summary can always name it
+    NSNumber *key = @(endpointID);
+    if (!self.endpointNames[key]) {
+        @synchronized (self) {
+            NSMutableDictionary *names = [NSMutableDictionary dictionaryWithDictionary:self.endpointNames ?: @{}];
+            names[key] = [endpoint copy];
+            self.endpointNames = [names copy];
         }
-        return [[NSDictionary alloc] initWithDictionary:_instrumentationDictionary];
     }
+    BNCTimingRingRecord(self.roundTripTimes, endpointID, (uint32_t)MIN(MAX(milliseconds, 0), (double)UINT32_MAX));
 }
 
 - (NSMutableDictionary *)instrumentationDictionary {
@@ -571,6 +659,7 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
     @synchronized (self) {
         if (key && value) {
             [self.instrumentationDictionary setObject:value forKey:key];
+            self.instrumentationSnapshot = [_instrumentationDictionary copy];
         }
     }
 }
@@ -578,13 +667,13 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 - (void)clearInstrumentationDictionary {
     @synchronized (self) {
         [_instrumentationDictionary removeAllObjects];
+        self.instrumentationSnapshot = nil;
+        BNCTimingRingReset(self.roundTripTimes);
     }
 }
 
 - (BOOL) limitFacebookTracking {
-    @synchronized (self) {
-        return [self readBoolFromDefaults:@"_limitFacebookTracking"];
-    }
+    return [self readBoolFromDefaults:@"_limitFacebookTracking"];
 }
 
 - (void) setLimitFacebookTracking:(BOOL)limitFacebookTracking {
@@ -594,26 +683,24 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSDate*) previousAppBuildDate {
-    @synchronized (self) {
-        NSDate *date = (NSDate*) [self readObjectFromDefaults:@"_previousAppBuildDate"];
-        if ([date isKindOfClass:[NSDate class]]) return date;
-        return nil;
-    }
+    NSDate *date = (NSDate*) [self readObjectFromDefaults:@"_previousAppBuildDate"];
+    if ([date isKindOfClass:[NSDate class]]) return date;
+    return nil;
 }
 
 - (void) setPreviousAppBuildDate:(NSDate*)date {
     @synchronized (self) {
+        // stamped on every open, only a new build changes it
+        if (date && [date isEqual:self.previousAppBuildDate]) return;
         if (date == nil || [date isKindOfClass:[NSDate class]])
             [self writeObjectToDefaults:@"_previousAppBuildDate" value:date];
     }
 }
 
 - (NSArray<NSString*>*) savedURLPatternList {
-    @synchronized(self) {
-        id a = [self readObjectFromDefaults:@"URLPatternList"];
-        if ([a isKindOfClass:NSArray.class]) return a;
-        return nil;
-    }
+    id a = [self readObjectFromDefaults:@"URLPatternList"];
+    if ([a isKindOfClass:NSArray.class]) return a;
+    return nil;
 }
 
 - (void) setSavedURLPatternList:(NSArray<NSString *> *)URLPatternList {
@@ -623,9 +710,7 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSInteger) savedURLPatternListVersion {
-    @synchronized(self) {
-        return [self readIntegerFromDefaults:@"URLPatternListVersion"];
-    }
+    return [self readIntegerFromDefaults:@"URLPatternListVersion"];
 }
 
 - (void) setSavedURLPatternListVersion:(NSInteger)URLPatternListVersion {
@@ -634,12 +719,20 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
     }
 }
 
-- (BOOL) dropURLOpen {
+- (NSString *) savedURLPatternListETag {
+    return [self readStringFromDefaults:@"URLPatternListETag"];
+}
+
+- (void) setSavedURLPatternListETag:(NSString *)URLPatternListETag {
     @synchronized(self) {
-        return [self readBoolFromDefaults:@"dropURLOpen"];
+        [self writeObjectToDefaults:@"URLPatternListETag" value:URLPatternListETag];
     }
 }
 
+- (BOOL) dropURLOpen {
+    return [self readBoolFromDefaults:@"dropURLOpen"];
+}
+
 - (void) setDropURLOpen:(BOOL)value {
     @synchronized(self) {
         [self writeBoolToDefaults:@"dropURLOpen" value:value];
@@ -647,63 +740,57 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (BOOL) trackingDisabled {
-    @synchronized(self) {
-        NSNumber *b = (id) [self readObjectFromDefaults:@"trackingDisabled"];
-        if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
-        return false;
+    int state = atomic_load_explicit(&_trackingDisabledState, memory_order_acquire);
+    if (state >= 0) return state;
+
+    NSNumber *b = (id) [self readObjectFromDefaults:@"trackingDisabled"];
+    BOOL disabled = ([b isKindOfClass:NSNumber.class]) ? [b boolValue] : false;
+
+    // a setter that ran meanwhile wins
+    int unknown = -1;
+    if (!atomic_compare_exchange_strong(&_trackingDisabledState, &unknown, disabled ? 1 : 0)) {
+        return unknown;
     }
+    return disabled;
 }
 
 - (void) setTrackingDisabled:(BOOL)disabled {
     @synchronized(self) {
         NSNumber *b = [NSNumber numberWithBool:disabled];
         [self writeObjectToDefaults:@"trackingDisabled" value:b];
+        atomic_store_explicit(&_trackingDisabledState, disabled ? 1 : 0, memory_order_release);
         if (disabled) [self clearTrackingInformation];
     }
 }
 
 - (void)setReferringURLQueryParameters:(NSMutableDictionary *)parameters {
     @synchronized(self) {
-        _referringURLQueryParameters = parameters;
         [self writeObjectToDefaults:BRANCH_PREFS_KEY_REFFERING_URL_QUERY_PARAMETERS value:parameters];
     }
 }
 
 - (NSMutableDictionary *)referringURLQueryParameters {
-    @synchronized(self) {
-        if (!_referringURLQueryParameters) {
-            _referringURLQueryParameters = (NSMutableDictionary *)[self readObjectFromDefaults:BRANCH_PREFS_KEY_REFFERING_URL_QUERY_PARAMETERS];
-        }
-    }
-    return _referringURLQueryParameters;
+    return (NSMutableDictionary *)[self readObjectFromDefaults:BRANCH_PREFS_KEY_REFFERING_URL_QUERY_PARAMETERS];
 }
 
 
 - (NSString *) referrerGBRAID {
-    @synchronized(self) {
-        if (!_referrerGBRAID) {
-            _referrerGBRAID = [self readStringFromDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID];
-        }
-        return _referrerGBRAID;
-    }
+    return [self readStringFromDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID];
 }
 
 - (void) setReferrerGBRAID:(NSString *)referrerGBRAID {
-    if (![_referrerGBRAID isEqualToString:referrerGBRAID]) {
-        _referrerGBRAID = referrerGBRAID;
+    if (![self.referrerGBRAID isEqualToString:referrerGBRAID]) {
         [self writeObjectToDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID value:referrerGBRAID];
         self.referrerGBRAIDInitDate = [NSDate date];
     }
 }
 
 - (NSTimeInterval) referrerGBRAIDValidityWindow {
-    @synchronized (self) {
-        _referrerGBRAIDValidityWindow = [self readDoubleFromDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID_WINDOW];
-        if (_referrerGBRAIDValidityWindow == NSNotFound) {
-            _referrerGBRAIDValidityWindow = DEFAULT_REFERRER_GBRAID_WINDOW;
-        }
-        return _referrerGBRAIDValidityWindow;
+    NSTimeInterval validityWindow = [self readDoubleFromDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID_WINDOW];
+    if (validityWindow == NSNotFound) {
+        validityWindow = DEFAULT_REFERRER_GBRAID_WINDOW;
     }
+    return validityWindow;
 }
 
 - (void) setReferrerGBRAIDValidityWindow:(NSTimeInterval)validityWindow {
@@ -713,11 +800,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSDate*) referrerGBRAIDInitDate {
-    @synchronized (self) {
-        NSDate* initdate = (NSDate*)[self readObjectFromDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID_INIT_DATE];
-        if ([initdate isKindOfClass:[NSDate class]]) return initdate;
-        return nil;
-    }
+    NSDate* initdate = (NSDate*)[self readObjectFromDefaults:BRANCH_PREFS_KEY_REFERRER_GBRAID_INIT_DATE];
+    if ([initdate isKindOfClass:[NSDate class]]) return initdate;
+    return nil;
 }
 
 - (void)setReferrerGBRAIDInitDate:(NSDate *)initDate {
@@ -744,33 +829,25 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSDate*) odmInfoInitDate {
-    @synchronized (self) {
-        if (!_odmInfoInitDate) {
-            _odmInfoInitDate = (NSDate*)[self readObjectFromDefaults:BRANCH_PREFS_KEY_ODM_INFO_INIT_DATE];
-            if ([_odmInfoInitDate isKindOfClass:[NSDate class]]) return _odmInfoInitDate;
-            return nil;
-        }
-        return _odmInfoInitDate;
-    }
+    NSDate *initDate = (NSDate*)[self readObjectFromDefaults:BRANCH_PREFS_KEY_ODM_INFO_INIT_DATE];
+    if ([initDate isKindOfClass:[NSDate class]]) return initDate;
+    return nil;
 }
 
 - (void) setOdmInfoInitDate:(NSDate *)initDate {
     @synchronized (self) {
-        if (![_odmInfoInitDate isEqualToDate:initDate]) {
-            _odmInfoInitDate = initDate;
+        if (![self.odmInfoInitDate isEqualToDate:initDate]) {
             [self writeObjectToDefaults:BRANCH_PREFS_KEY_ODM_INFO_INIT_DATE value:initDate];
         }
     }
 }
 
 - (NSTimeInterval) thirdPartyAPIsWaitTime {
-    @synchronized (self) {
-        _thirdPartyAPIsWaitTime = [self readDoubleFromDefaults:BRANCH_PREFS_KEY_THIRD_PARTY_APIS_TIMEOUT];
-        if (_thirdPartyAPIsWaitTime == NSNotFound) {
-            _thirdPartyAPIsWaitTime = DEFAULT_THIRD_PARTY_APIS_TIMEOUT;
-        }
-        return _thirdPartyAPIsWaitTime;
+    NSTimeInterval waitTime = [self readDoubleFromDefaults:BRANCH_PREFS_KEY_THIRD_PARTY_APIS_TIMEOUT];
+    if (waitTime == NSNotFound) {
+        waitTime = DEFAULT_THIRD_PARTY_APIS_TIMEOUT;
     }
+    return waitTime;
 }
 
 - (void) setThirdPartyAPIsWaitTime:(NSTimeInterval)waitTime {
@@ -781,12 +858,10 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSInteger) skanCurrentWindow {
-    @synchronized (self) {
-        _skanCurrentWindow = [self readIntegerFromDefaults:BRANCH_PREFS_KEY_SKAN_CURRENT_WINDOW];
-        if(_skanCurrentWindow == NSNotFound)
-            return BranchSkanWindowInvalid;
-        return _skanCurrentWindow;
-    }
+    NSInteger window = [self readIntegerFromDefaults:BRANCH_PREFS_KEY_SKAN_CURRENT_WINDOW];
+    if(window == NSNotFound)
+        return BranchSkanWindowInvalid;
+    return window;
 }
 
 - (void) setSkanCurrentWindow:(NSInteger) window {
@@ -797,28 +872,22 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 
 
 - (NSDate *) firstAppLaunchTime {
-    @synchronized (self) {
-        if(!_firstAppLaunchTime) {
-            _firstAppLaunchTime = (NSDate *)[self readObjectFromDefaults:BRANCH_PREFS_KEY_FIRST_APP_LAUNCH_TIME];
-        }
-        return _firstAppLaunchTime;
-    }
+    NSDate *launchTime = (NSDate *)[self readObjectFromDefaults:BRANCH_PREFS_KEY_FIRST_APP_LAUNCH_TIME];
+    if ([launchTime isKindOfClass:[NSDate class]]) return launchTime;
+    return nil;
 }
 
 - (void) setFirstAppLaunchTime:(NSDate *) launchTime {
     @synchronized (self) {
-        _firstAppLaunchTime = launchTime;
         [self writeObjectToDefaults:BRANCH_PREFS_KEY_FIRST_APP_LAUNCH_TIME value:launchTime];
     }
 }
 
 - (NSInteger) highestConversionValueSent {
-    @synchronized (self) {
-        _highestConversionValueSent = [self readIntegerFromDefaults:BRANCH_PREFS_KEY_SKAN_HIGHEST_CONV_VALUE_SENT];
-        if(_highestConversionValueSent == NSNotFound)
-            return 0;
-        return _highestConversionValueSent;
-    }
+    NSInteger value = [self readIntegerFromDefaults:BRANCH_PREFS_KEY_SKAN_HIGHEST_CONV_VALUE_SENT];
+    if(value == NSNotFound)
+        return 0;
+    return value;
 }
 
 - (void) setHighestConversionValueSent:(NSInteger)value {
@@ -828,11 +897,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (BOOL) invokeRegisterApp {
-    @synchronized (self) {
-        NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_SKAN_INVOKE_REGISTER_APP];
-        if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
-        return false;
-    }
+    NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_SKAN_INVOKE_REGISTER_APP];
+    if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
+    return false;
 }
 
 - (void) setInvokeRegisterApp:(BOOL)invoke {
@@ -843,19 +910,15 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (BOOL) eeaRegionInitialized {
-    @synchronized(self) {
-        if([self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_EEA])
-            return YES;
-        return NO;
-    }
+    if([self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_EEA])
+        return YES;
+    return NO;
 }
 
 - (BOOL) eeaRegion {
-    @synchronized(self) {
-        NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_EEA];
-        if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
-        return NO;
-    }
+    NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_EEA];
+    if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
+    return NO;
 }
 
 - (void) setEeaRegion:(BOOL)isEEARegion {
@@ -866,11 +929,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (BOOL) adPersonalizationConsent {
-    @synchronized(self) {
-        NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_AD_PERSONALIZATION];
-        if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
-        return NO;
-    }
+    NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_AD_PERSONALIZATION];
+    if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
+    return NO;
 }
 
 - (void) setAdPersonalizationConsent:(BOOL)hasConsent {
@@ -881,11 +942,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (BOOL) adUserDataUsageConsent {
-    @synchronized(self) {
-        NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_AD_USER_DATA];
-        if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
-        return NO;
-    }
+    NSNumber *b = (id) [self readObjectFromDefaults:BRANCH_PREFS_KEY_DMA_AD_USER_DATA];
+    if ([b isKindOfClass:NSNumber.class]) return [b boolValue];
+    return NO;
 }
 
 - (void) setAdUserDataUsageConsent:(BOOL)hasConsent {
@@ -896,11 +955,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (BOOL) attributionLevelInitialized {
-    @synchronized(self) {
-        if([self readObjectFromDefaults:BRANCH_PREFS_KEY_ATTRIBUTION_LEVEL])
-            return YES;
-        return NO;
-    }
+    if([self readObjectFromDefaults:BRANCH_PREFS_KEY_ATTRIBUTION_LEVEL])
+        return YES;
+    return NO;
 }
 
 - (BranchAttributionLevel)attributionLevel {
@@ -928,20 +985,14 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 }
 
 - (NSDate*) urlLoadMs {
-    @synchronized (self) {
-        if (!_urlLoadMs) {
-            _urlLoadMs = (NSDate*)[self readObjectFromDefaults:BRANCH_PREFS_KEY_URL_LOAD_MS];
-            if ([_urlLoadMs isKindOfClass:[NSDate class]]) return _urlLoadMs;
-            return nil;
-        }
-        return _urlLoadMs;
-    }
+    NSDate *urlLoadMs = (NSDate*)[self readObjectFromDefaults:BRANCH_PREFS_KEY_URL_LOAD_MS];
+    if ([urlLoadMs isKindOfClass:[NSDate class]]) return urlLoadMs;
+    return nil;
 }
 
 - (void) setUrlLoadMs:(NSDate *)urlLoadMs {
     @synchronized (self) {
-        if (![_urlLoadMs isEqualToDate:urlLoadMs]) {
-            _urlLoadMs = urlLoadMs;
+        if (![self.urlLoadMs isEqualToDate:urlLoadMs]) {
             [self writeObjectToDefaults:BRANCH_PREFS_KEY_URL_LOAD_MS value:urlLoadMs];
         }
     }
@@ -977,35 +1028,53 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 
 #pragma mark - Count Storage
 
-- (void)saveBranchAnalyticsData:(NSDictionary *)analyticsData {
-    if (_sessionID) {
-        if (!_savedAnalyticsData) {
-            _savedAnalyticsData = [self getBranchAnalyticsData];
+// Content analytics grows with app usage, so it is kept in its own file rather than in the preferences
+- (BNCContentAnalyticsStore *)contentAnalyticsStore {
+    @synchronized (self) {
+        if (!_contentAnalyticsStore) {
+            NSURL *url = [BNCContentAnalyticsStore defaultURL];
+            if (!self.useStorage) {
+                NSString *name = [NSString stringWithFormat:@"BNCContentAnalytics-%@.log", [NSUUID UUID].UUIDString];
+                url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name]];
+            }
+            _contentAnalyticsStore = [BNCContentAnalyticsStore storeWithURL:url];
+            [self migrateAnalyticsDataToStore:_contentAnalyticsStore];
         }
-        NSMutableArray *viewDataArray = [_savedAnalyticsData objectForKey:_sessionID];
-        if (!viewDataArray) {
-            viewDataArray = [[NSMutableArray alloc] init];
-            [_savedAnalyticsData setObject:viewDataArray forKey:_sessionID];
+        return _contentAnalyticsStore;
+    }
+}
+
+// Older SDKs kept content analytics in the preferences
+- (void)migrateAnalyticsDataToStore:(BNCContentAnalyticsStore *)store {
+    NSDictionary *analyticsData = (NSDictionary *)[self readObjectFromDefaults:BRANCH_PREFS_KEY_ANALYTICAL_DATA];
+    if (![analyticsData isKindOfClass:NSDictionary.class]) return;
+
+    for (NSString *sessionID in analyticsData) {
+        NSArray *events = analyticsData[sessionID];
+        if (![sessionID isKindOfClass:NSString.class] || ![events isKindOfClass:NSArray.class]) continue;
+        for (NSDictionary *event in events) {
+            if ([event isKindOfClass:NSDictionary.class]) {
+                [store appendEvent:event sessionID:sessionID];
+            }
         }
-        [viewDataArray addObject:analyticsData];
-        [self writeObjectToDefaults:BRANCH_PREFS_KEY_ANALYTICAL_DATA value:_savedAnalyticsData];
+    }
+    [self writeObjectToDefaults:BRANCH_PREFS_KEY_ANALYTICAL_DATA value:nil];
+}
+
+- (void)saveBranchAnalyticsData:(NSDictionary *)analyticsData {
+    NSString *sessionID = self.sessionID;
+    if (sessionID) {
+        [self.contentAnalyticsStore appendEvent:analyticsData sessionID:sessionID];
     }
 }
 
 - (void)clearBranchAnalyticsData {
-    [self writeObjectToDefaults:BRANCH_PREFS_KEY_ANALYTICAL_DATA value:nil];
+    [self.contentAnalyticsStore removeAllEvents];
     _savedAnalyticsData = nil;
 }
 
 - (NSMutableDictionary *)getBranchAnalyticsData {
-    NSMutableDictionary *analyticsDataObj = _savedAnalyticsData;
-    if (!analyticsDataObj) {
-        analyticsDataObj = (NSMutableDictionary *)[self readObjectFromDefaults:BRANCH_PREFS_KEY_ANALYTICAL_DATA];
-        if (!analyticsDataObj) {
-            analyticsDataObj = [[NSMutableDictionary alloc] init];
-        }
-    }
-    return analyticsDataObj;
+    return [self.contentAnalyticsStore eventsBySession];
 }
 
 - (void)saveContentAnalyticsManifest:(NSDictionary *)cdManifest {
@@ -1033,28 +1102,76 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
         } else {
             [self.persistenceDict removeObjectForKey:key];
         }
-        [self persistPrefsToDisk];
+        self.prefsSnapshot = [self.persistenceDict copy];
+        [self.dirtyKeys addObject:key];
+        if (!self.batchDepth) {
+            [self persistPrefsToDisk];
+        }
     }
 }
 
+- (void)performBatchUpdates:(void (NS_NOESCAPE ^)(void))updates {
+    @synchronized (self) {
+        self.batchDepth++;
+        updates();
+        self.batchDepth--;
+        if (self.batchDepth || !self.useStorage) return;
+        [self flush];
+    }
+}
+
+// Schedules a flush of the dirty keys. Writes are coalesced and persisted once per persist window.
 - (void)persistPrefsToDisk {
-    if (self.useStorage) {
-        @synchronized (self) {
-            if (!self.persistenceDict) return;
-            
-            NSData *data = [self serializePrefDict:self.persistenceDict];
-            if (!data) return;
-            
-            NSURL *prefsURL = [self.class.URLForPrefsFile copy];
-            NSBlockOperation *newPersistOp = [NSBlockOperation blockOperationWithBlock:^ {
-                NSError *error = nil;
-                [data writeToURL:prefsURL options:NSDataWritingAtomic error:&error];
-                if (error) {
-                    [[BranchLogger shared] logWarning:@"Failed to persist preferences" error:error];
+    if (!self.useStorage) return;
+    @synchronized (self) {
+        if (self.persistScheduled) return;
+        self.persistScheduled = YES;
+    }
+
+    __weak BNCPreferenceHelper *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(BNCPreferencePersistDelay * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [weakSelf flush];
+    });
+}
+
+- (void)flush {
+    @synchronized (self) {
+        self.persistScheduled = NO;
+        if (!self.dirtyKeys.count || !_persistenceDict) return;
+        NSSet<NSString *> *keys = [self.dirtyKeys copy];
+        [self.dirtyKeys removeAllObjects];
+        self.persistCount++;
+
+        // only the changed keys are appended to the store
+        BNCPreferenceStore *store = self.preferenceStore;
+        if (store) {
+            // committed together, a crash mid flush does not leave some of the keys on disk without the others
+            NSUInteger bytes = store.bytesWritten;
+            [store performBatchUpdates:^{
+                for (NSString *key in keys) {
+                    [store setObject:self.persistenceDict[key] forKey:key];
                 }
             }];
-            [_persistPrefsQueue addOperation:newPersistOp];
+            self.bytesWritten += store.bytesWritten - bytes;
+            [_persistPrefsQueue addOperationWithBlock:^{
+                [store synchronize];
+            }];
+            return;
         }
+
+        NSData *data = [self serializePrefDict:self.persistenceDict];
+        if (!data) return;
+
+        NSURL *prefsURL = [self.class.URLForPrefsFile copy];
+        NSBlockOperation *newPersistOp = [NSBlockOperation blockOperationWithBlock:^ {
+            NSError *error = nil;
+            [data writeToURL:prefsURL options:NSDataWritingAtomic error:&error];
+            if (error) {
+                [[BranchLogger shared] logWarning:@"Failed to persist preferences" error:error];
+            }
+        }];
+        [_persistPrefsQueue addOperation:newPersistOp];
+        self.bytesWritten += data.length;
     }
 }
 
@@ -1073,23 +1190,93 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
 + (void) clearAll {
     NSURL *prefsURL = [self.URLForPrefsFile copy];
     if (prefsURL) [[NSFileManager defaultManager] removeItemAtURL:prefsURL error:nil];
+
+    BNCPreferenceStore *store = [BNCPreferenceStore storeWithURL:[BNCPreferenceStore defaultURL]];
+    [store removeAllObjects];
+    [store synchronize];
 }
 
 #pragma mark - Reading From Persistence
 
+- (void)preloadPersistenceDict {
+    @synchronized(self) {
+        if (_persistenceDict || self.loadGroup || !self.useStorage) return;
+
+        // The load does not take the helper lock, so a reader holding it can wait for the load
+        dispatch_group_t group = dispatch_group_create();
+        self.loadGroup = group;
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            self.loadedPersistenceDict = [self loadPersistenceDict];
+        });
+    }
+}
+
+- (NSMutableDictionary *)waitForPreloadedPersistenceDict {
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    dispatch_group_wait(self.loadGroup, DISPATCH_TIME_FOREVER);
+    self.loadBlockedTime = [NSDate timeIntervalSinceReferenceDate] - start;
+    if (self.loadBlockedTime >= 0.001) {
+        [[BranchLogger shared] logDebug:[NSString stringWithFormat:@"Blocked %.1f ms waiting for preferences to load.", self.loadBlockedTime * 1000.0] error:nil];
+    }
+
+    NSMutableDictionary *dict = self.loadedPersistenceDict;
+    self.loadedPersistenceDict = nil;
+    self.loadGroup = nil;
+    return dict;
+}
+
 - (NSMutableDictionary *)persistenceDict {
     @synchronized(self) {
         if (!_persistenceDict) {
-            if (self.useStorage) {
-                _persistenceDict = [self deserializePrefDictFromData:[self loadPrefData]];
+            if (self.loadGroup) {
+                _persistenceDict = [self waitForPreloadedPersistenceDict] ?: [[NSMutableDictionary alloc] init];
+            } else if (self.useStorage) {
+                _persistenceDict = [self loadPersistenceDict];
             } else {
                 _persistenceDict = [[NSMutableDictionary alloc] init];
             }
+            self.prefsSnapshot = [_persistenceDict copy];
         }
         return _persistenceDict;
     }
 }
 
+- (NSMutableDictionary *)loadPersistenceDict {
+    BNC_TRACE_BEGIN("preferences_load");
+    NSMutableDictionary *dict = nil;
+    self.preferenceStore = [BNCPreferenceStore storeWithURL:[BNCPreferenceStore defaultURL]];
+    if (self.preferenceStore) {
+        [self migratePrefsFileToStore];
+        dict = [self.preferenceStore dictionary];
+    } else {
+        dict = [self deserializePrefDictFromData:[self loadPrefData]];
+    }
+    BNC_TRACE_END("preferences_load");
+    return dict;
+}
+
+// The archive is removed once migrated, so one that exists was written by an SDK without the store and is the latest data
+- (void)migratePrefsFileToStore {
+    NSURL *prefsURL = self.class.URLForPrefsFile;
+    if (![[NSFileManager defaultManager] fileExistsAtPath:prefsURL.path]) return;
+
+    NSData *data = [self loadPrefData];
+    if (!data) return;
+    NSDictionary *archived = [self deserializePrefDictFromData:data];
+
+    [self.preferenceStore removeAllObjects];
+    for (NSString *key in archived) {
+        [self.preferenceStore setObject:archived[key] forKey:key];
+    }
+    [self.preferenceStore synchronize];
+
+    NSError *error = nil;
+    if (![[NSFileManager defaultManager] removeItemAtURL:prefsURL error:&error]) {
+        [[BranchLogger shared] logWarning:@"Failed to remove migrated preferences file." error:error];
+    }
+    [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"Migrated %lu preferences to the preference store.", (unsigned long)archived.count] error:nil];
+}
+
 - (NSData *)loadPrefData {
     NSData *data = nil;
     @try {
@@ -1126,62 +1313,61 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory_Unthreaded(void);
     }
 }
 
-- (NSObject *)readObjectFromDefaults:(NSString *)key {
+// Lock free, the snapshot is only loaded under the lock the first time
+- (NSDictionary *)currentPrefsSnapshot {
+    NSDictionary *snapshot = self.prefsSnapshot;
+    if (snapshot) return snapshot;
     @synchronized(self) {
-        NSObject *obj = self.persistenceDict[key];
-        return obj;
+        [self persistenceDict];
+        return self.prefsSnapshot;
     }
 }
 
+- (NSObject *)readObjectFromDefaults:(NSString *)key {
+    return [self currentPrefsSnapshot][key];
+}
+
 - (NSString *)readStringFromDefaults:(NSString *)key {
-    @synchronized(self) {
-        id str = self.persistenceDict[key];
-        
-        // protect against NSNumber
-        if ([str isKindOfClass:[NSNumber class]]) {
-            str = [str stringValue];
-        }
-        
-        // protect against anything else
-        if (![str isKindOfClass:[NSString class]]) {
-            str = nil;
-        }
-        
-        return str;
+    id str = [self currentPrefsSnapshot][key];
+
+    // protect against NSNumber
+    if ([str isKindOfClass:[NSNumber class]]) {
+        str = [str stringValue];
     }
+
+    // protect against anything else
+    if (![str isKindOfClass:[NSString class]]) {
+        str = nil;
+    }
+
+    return str;
 }
 
 - (BOOL)readBoolFromDefaults:(NSString *)key {
-    @synchronized(self) {
-        BOOL boo = NO;
+    BOOL boo = NO;
 
-        NSNumber *boolean = self.persistenceDict[key];
-        if ([boolean respondsToSelector:@selector(boolValue)]) {
-            boo = [boolean boolValue];
-        }
-        
-        return boo;
+    NSNumber *boolean = [self currentPrefsSnapshot][key];
+    if ([boolean respondsToSelector:@selector(boolValue)]) {
+        boo = [boolean boolValue];
     }
+
+    return boo;
 }
 
 - (NSInteger)readIntegerFromDefaults:(NSString *)key {
-    @synchronized(self) {
-        NSNumber *number = self.persistenceDict[key];
-        if (number != nil && [number respondsToSelector:@selector(integerValue)]) {
-            return [number integerValue];
-        }
-        return NSNotFound;
+    NSNumber *number = [self currentPrefsSnapshot][key];
+    if (number != nil && [number respondsToSelector:@selector(integerValue)]) {
+        return [number integerValue];
     }
+    return NSNotFound;
 }
 
 - (double)readDoubleFromDefaults:(NSString *)key {
-    @synchronized(self) {
-        NSNumber *number = self.persistenceDict[key];
-        if (number != nil && [number respondsToSelector:@selector(doubleValue)]){
-            return [number doubleValue];
-        }
-        return NSNotFound;
+    NSNumber *number = [self currentPrefsSnapshot][key];
+    if (number != nil && [number respondsToSelector:@selector(doubleValue)]){
+        return [number doubleValue];
     }
+    return NSNotFound;
 }
 
 #pragma mark - Preferences File URL
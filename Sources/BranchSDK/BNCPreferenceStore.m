@@ -0,0 +1,294 @@
+//
+//  BNCPreferenceStore.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCPreferenceStore.h"
+#import "BNCKVStore.h"
+#import "BNCPreferenceHelper.h"
+#import "BranchLogger.h"
+
+static NSString * const BNCPreferenceStoreFileName = @"BNCPreferences.kv";
+
+// Record types, stored in the file so values must keep their numbers
+typedef NS_ENUM(uint8_t, BNCPreferenceType) {
+    BNCPreferenceTypeString = 1,
+    BNCPreferenceTypeInteger = 2,
+    BNCPreferenceTypeDouble = 3,
+    BNCPreferenceTypeBool = 4,
+    BNCPreferenceTypeDate = 5,
+    BNCPreferenceTypeData = 6,
+    BNCPreferenceTypeArchive = 7
+};
+
+@interface BNCPreferenceStore ()
+@property (nonatomic, assign) BNCKVStore *store;
+@property (nonatomic, strong) dispatch_queue_t compactionQueue;
+@property (nonatomic, assign) BOOL compactionScheduled;
+@property (nonatomic, assign, readwrite) NSUInteger bytesWritten;
+@end
+
+@implementation BNCPreferenceStore
+
++ (NSURL *)defaultURL {
+    return [BNCURLForBranchDirectory() URLByAppendingPathComponent:BNCPreferenceStoreFileName isDirectory:NO];
+}
+
++ (BNCPreferenceStore *)storeWithURL:(NSURL *)url {
+    static NSMutableDictionary<NSString *, BNCPreferenceStore *> *stores = nil;
+    static dispatch_once_t onceToken = 0;
+    dispatch_once(&onceToken, ^{
+        stores = [NSMutableDictionary new];
+    });
+
+    NSString *path = url.URLByStandardizingPath.path;
+    if (!path) return nil;
+    @synchronized (stores) {
+        BNCPreferenceStore *store = stores[path];
+        if (!store) {
+            store = [[BNCPreferenceStore alloc] initWithURL:url];
+            stores[path] = store;
+        }
+        return store;
+    }
+}
+
+- (instancetype)initWithURL:(NSURL *)url {
+    self = [super init];
+    if (!self) return self;
+
+    int error = 0;
+    _store = BNCKVStoreOpen(url.fileSystemRepresentation, &error);
+    if (!_store) {
+        NSError *openError = [NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:nil];
+        [[BranchLogger shared] logWarning:@"Failed to open preference store." error:openError];
+        return nil;
+    }
+    _compactionQueue = dispatch_queue_create("io.branch.sdk.preferencestore", DISPATCH_QUEUE_SERIAL);
+    return self;
+}
+
+- (void)dealloc {
+    BNCKVStoreClose(_store);
+}
+
+#pragma mark - Encoding
+
+- (NSData *)encodeObject:(id)object type:(BNCPreferenceType *)type {
+    if ([object isKindOfClass:NSString.class]) {
+        *type = BNCPreferenceTypeString;
+        return [(NSString *)object dataUsingEncoding:NSUTF8StringEncoding];
+    }
+    if ([object isKindOfClass:NSNumber.class]) {
+        NSNumber *number = object;
+        if (CFGetTypeID((__bridge CFTypeRef)number) == CFBooleanGetTypeID()) {
+            *type = BNCPreferenceTypeBool;
+            uint8_t value = number.boolValue;
+            return [NSData dataWithBytes:&value length:sizeof(value)];
+        }
+        if (CFNumberIsFloatType((__bridge CFNumberRef)number)) {
+            *type = BNCPreferenceTypeDouble;
+            double value = number.doubleValue;
+            return [NSData dataWithBytes:&value length:sizeof(value)];
+        }
+        *type = BNCPreferenceTypeInteger;
+        int64_t value = number.longLongValue;
+        return [NSData dataWithBytes:&value length:sizeof(value)];
+    }
+    if ([object isKindOfClass:NSDate.class]) {
+        *type = BNCPreferenceTypeDate;
+        double value = [(NSDate *)object timeIntervalSinceReferenceDate];
+        return [NSData dataWithBytes:&value length:sizeof(value)];
+    }
+    if ([object isKindOfClass:NSData.class]) {
+        *type = BNCPreferenceTypeData;
+        return object;
+    }
+
+    *type = BNCPreferenceTypeArchive;
+    NSError *error = nil;
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:object requiringSecureCoding:YES error:&error];
+    if (error) {
+        [[BranchLogger shared] logWarning:@"Failed to archive preference." error:error];
+    }
+    return data;
+}
+
+- (id)decodeBytes:(const void *)bytes length:(size_t)length type:(uint8_t)type {
+    switch (type) {
+        case BNCPreferenceTypeString:
+            return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+
+        case BNCPreferenceTypeBool:
+            if (length != sizeof(uint8_t)) return nil;
+            return @(*(const uint8_t *)bytes != 0);
+
+        case BNCPreferenceTypeInteger: {
+            int64_t value = 0;
+            if (length != sizeof(value)) return nil;
+            memcpy(&value, bytes, sizeof(value));
+            return @(value);
+        }
+        case BNCPreferenceTypeDouble:
+        case BNCPreferenceTypeDate: {
+            double value = 0;
+            if (length != sizeof(value)) return nil;
+            memcpy(&value, bytes, sizeof(value));
+            return (type == BNCPreferenceTypeDate) ? [NSDate dateWithTimeIntervalSinceReferenceDate:value] : @(value);
+        }
+        case BNCPreferenceTypeData:
+            return [NSData dataWithBytes:bytes length:length];
+
+        case BNCPreferenceTypeArchive: {
+            NSData *data = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+            NSSet *classes = [[NSSet alloc] initWithArray:@[ NSNumber.class, NSString.class, NSDate.class, NSArray.class, NSDictionary.class, NSData.class ]];
+            NSError *error = nil;
+            id object = [NSKeyedUnarchiver unarchivedObjectOfClasses:classes fromData:data error:&error];
+            if (error) {
+                [[BranchLogger shared] logWarning:@"Failed to unarchive preference." error:error];
+            }
+            return object;
+        }
+        default:
+            return nil;
+    }
+}
+
+#pragma mark - Access
+
+static void BNCPreferenceStoreCollect(const char *key, size_t keyLength, uint8_t type, const void *value, size_t valueLength, void *context) {
+    void **pair = context;
+    BNCPreferenceStore *self = (__bridge BNCPreferenceStore *)pair[0];
+    NSMutableDictionary *dictionary = (__bridge NSMutableDictionary *)pair[1];
+
+    NSString *name = [[NSString alloc] initWithBytes:key length:keyLength encoding:NSUTF8StringEncoding];
+    id object = [self decodeBytes:value length:valueLength type:type];
+    if (name && object) {
+        dictionary[name] = object;
+    }
+}
+
+- (NSMutableDictionary *)dictionary {
+    @synchronized (self) {
+        NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:BNCKVStoreCount(self.store)];
+        void *context[2] = { (__bridge void *)self, (__bridge void *)dictionary };
+        BNCKVStoreEnumerate(self.store, BNCPreferenceStoreCollect, context);
+        return dictionary;
+    }
+}
+
+- (id)objectForKey:(NSString *)key {
+    const char *name = key.UTF8String;
+    if (!name) return nil;
+
+    @synchronized (self) {
+        uint8_t type = 0;
+        const void *value = NULL;
+        size_t length = 0;
+        if (!BNCKVStoreGet(self.store, name, strlen(name), &type, &value, &length)) return nil;
+        return [self decodeBytes:value length:length type:type];
+    }
+}
+
+- (void)setObject:(id)object forKey:(NSString *)key {
+    const char *name = key.UTF8String;
+    if (!name) return;
+
+    BNCPreferenceType type = 0;
+    NSData *data = (object) ? [self encodeObject:object type:&type] : nil;
+    if (object && !data) return;
+
+    @synchronized (self) {
+        int error = (data) ?
+            BNCKVStorePut(self.store, name, strlen(name), type, data.bytes, data.length) :
+            BNCKVStoreDelete(self.store, name, strlen(name));
+        if (error) {
+            NSError *writeError = [NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:nil];
+            [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Failed to store preference %@.", key] error:writeError];
+        } else {
+            self.bytesWritten += strlen(name) + data.length;
+        }
+    }
+}
+
+- (void)removeAllObjects {
+    @synchronized (self) {
+        BNCKVStoreClear(self.store);
+    }
+}
+
+- (void)performBatchUpdates:(void (NS_NOESCAPE ^)(void))updates {
+    @synchronized (self) {
+        BOOL batching = (BNCKVStoreBeginBatch(self.store) == 0);
+        updates();
+        if (!batching) return;
+
+        int error = BNCKVStoreCommitBatch(self.store);
+        if (error) {
+            [[BranchLogger shared] logWarning:@"Failed to flush preference batch." error:[NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:nil]];
+        }
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return BNCKVStoreCount(self.store);
+    }
+}
+
+- (NSUInteger)garbageBytes {
+    @synchronized (self) {
+        return BNCKVStoreGarbageBytes(self.store);
+    }
+}
+
+#pragma mark - Persistence
+
+- (void)synchronize {
+    @synchronized (self) {
+        int error = BNCKVStoreSync(self.store);
+        if (error) {
+            [[BranchLogger shared] logWarning:@"Failed to sync preference store." error:[NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:nil]];
+        }
+        if (!BNCKVStoreNeedsCompaction(self.store) || self.compactionScheduled) return;
+        self.compactionScheduled = YES;
+    }
+
+    __weak BNCPreferenceStore *weakSelf = self;
+    dispatch_async(self.compactionQueue, ^{
+        [weakSelf compact];
+    });
+}
+
+// Only copying the live records and swapping files hold the lock, reads and writes continue while the new file is written
+- (void)compact {
+    int error = 0;
+    BNCKVCompaction *compaction = NULL;
+    @synchronized (self) {
+        self.compactionScheduled = NO;
+        compaction = BNCKVStoreCompactionBegin(self.store, &error);
+    }
+
+    if (compaction) {
+        error = BNCKVCompactionWrite(compaction);
+    }
+    if (!error) {
+        @synchronized (self) {
+            size_t garbage = BNCKVStoreGarbageBytes(self.store);
+            error = BNCKVStoreCompactionFinish(self.store, compaction);
+            if (!error) {
+                [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"Compacted preference store, %zu bytes reclaimed.", garbage - BNCKVStoreGarbageBytes(self.store)] error:nil];
+            }
+        }
+    }
+    BNCKVCompactionFree(compaction);
+
+    // a clear in the meantime leaves nothing to compact
+    if (error && error != ESTALE) {
+        [[BranchLogger shared] logWarning:@"Failed to compact preference store." error:[NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:nil]];
+    }
+}
+
+@end
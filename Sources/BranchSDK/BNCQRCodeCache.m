@@ -8,51 +8,318 @@
 
 #import "BNCQRCodeCache.h"
 #import "BranchConstants.h"
+#import "BNCEncodingUtils.h"
+#import "BNCPreferenceHelper.h"
+#import "BranchLogger.h"
+
+static NSUInteger const BNCQRCodeCacheDefaultMemoryBytesLimit = 2 * 1024 * 1024;
+static NSUInteger const BNCQRCodeCacheDefaultDiskBytesLimit = 10 * 1024 * 1024;
+static NSTimeInterval const BNCQRCodeCacheDefaultTimeToLive = 7 * 24 * 60 * 60;
+
+static NSString * const BNCQRCodeCacheDirectoryName = @"QRCodes";
 
 @interface BNCQRCodeCache()
-@property (nonatomic, strong) NSMutableDictionary *cache;
+
+// key is the params hash, the ordered set tracks use from least to most recent
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSData *> *cache;
+@property (nonatomic, strong) NSMutableOrderedSet<NSString *> *recentKeys;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSDate *> *expirations;
+
+// completions waiting on an in flight fetch, by key
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<BNCQRCodeCacheCompletion> *> *pendingFetches;
+
+@property (nonatomic, copy) NSURL *directoryURL;
+@property (nonatomic, strong) dispatch_queue_t diskQueue;
+
+@property (assign, nonatomic, readwrite) NSUInteger memoryBytes;
+@property (assign, nonatomic, readwrite) NSUInteger fetchCount;
+
 @end
 
 @implementation BNCQRCodeCache
 
-//Can only hold one QR code in cache. Just used to debounce.
 + (BNCQRCodeCache *) sharedInstance {
     static BNCQRCodeCache *singleton = nil;
     static dispatch_once_t onceToken = 0;
     dispatch_once(&onceToken, ^{
-        singleton = [BNCQRCodeCache new];
+        singleton = [[BNCQRCodeCache alloc] initWithDirectoryURL:[BNCQRCodeCache defaultDirectoryURL]];
     });
     return singleton;
 }
 
 - (instancetype)init {
+    return [self initWithDirectoryURL:nil];
+}
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL {
     if ((self = [super init])) {
         self.cache = [[NSMutableDictionary alloc] init];
+        self.recentKeys = [[NSMutableOrderedSet alloc] init];
+        self.expirations = [[NSMutableDictionary alloc] init];
+        self.pendingFetches = [[NSMutableDictionary alloc] init];
+        self.directoryURL = directoryURL;
+        self.diskQueue = dispatch_queue_create("io.branch.sdk.qrcodecache", DISPATCH_QUEUE_SERIAL);
+        _memoryBytesLimit = BNCQRCodeCacheDefaultMemoryBytesLimit;
+        _diskBytesLimit = BNCQRCodeCacheDefaultDiskBytesLimit;
+        _timeToLive = BNCQRCodeCacheDefaultTimeToLive;
     }
     return self;
 }
 
-- (void)addQRCodeToCache:(NSData *)qrCodeData withParams:(NSMutableDictionary *)parameters {
++ (NSURL *)defaultDirectoryURL {
+    return [BNCURLForBranchDirectory() URLByAppendingPathComponent:BNCQRCodeCacheDirectoryName isDirectory:YES];
+}
+
+#pragma mark - Keys
+
++ (NSString *)cacheKeyForParams:(NSDictionary *)parameters {
+    if (![parameters isKindOfClass:NSDictionary.class]) return nil;
+
+    // The timestamp and UUID change on every request without changing the image
+    NSMutableDictionary *stableParams = [parameters mutableCopy];
+    [stableParams removeObjectForKey:BRANCH_REQUEST_KEY_REQUEST_CREATION_TIME_STAMP];
+    [stableParams removeObjectForKey:BRANCH_REQUEST_KEY_REQUEST_UUID];
+    if ([stableParams[@"data"] isKindOfClass:NSDictionary.class]) {
+        NSMutableDictionary *data = [stableParams[@"data"] mutableCopy];
+        [data removeObjectForKey:@"$creation_timestamp"];
+        stableParams[@"data"] = data;
+    }
+
+    if (![NSJSONSerialization isValidJSONObject:stableParams]) return nil;
+    NSData *json = [NSJSONSerialization dataWithJSONObject:stableParams options:NSJSONWritingSortedKeys error:NULL];
+    if (!json) return nil;
+    return [BNCEncodingUtils sha256Encode:[[NSString alloc] initWithData:json encoding:NSUTF8StringEncoding]];
+}
+
+#pragma mark - Cache access
+
+- (void)addQRCodeToCache:(NSData *)qrCodeData withParams:(NSDictionary *)parameters {
+    NSString *key = [BNCQRCodeCache cacheKeyForParams:parameters];
+    if (!key || !qrCodeData) return;
+
+    @synchronized (self) {
+        [self setMemoryData:qrCodeData forKey:key expiration:[NSDate dateWithTimeIntervalSinceNow:self.timeToLive]];
+    }
+    [self writeDiskData:qrCodeData forKey:key];
+}
+
+- (NSData *)checkQRCodeCache:(NSDictionary *)parameters {
+    NSString *key = [BNCQRCodeCache cacheKeyForParams:parameters];
+    if (!key) return nil;
+    return [self dataForKey:key];
+}
+
+- (void)qrCodeForParams:(NSDictionary *)parameters
+                  fetch:(void (^)(BNCQRCodeCacheFetchCompletion done))fetch
+             completion:(BNCQRCodeCacheCompletion)completion {
+    NSString *key = [BNCQRCodeCache cacheKeyForParams:parameters];
+    if (!key) {
+        fetch(^(NSData *qrCode, NSError *error, BOOL cacheable) {
+            if (completion) completion(qrCode, error);
+        });
+        return;
+    }
+
+    NSData *qrCode = [self dataForKey:key];
+    if (qrCode) {
+        if (completion) completion(qrCode, nil);
+        return;
+    }
+
+    @synchronized (self) {
+        NSMutableArray *waiting = self.pendingFetches[key];
+        if (waiting) {
+            if (completion) [waiting addObject:[completion copy]];
+            return;
+        }
+        waiting = [NSMutableArray new];
+        if (completion) [waiting addObject:[completion copy]];
+        self.pendingFetches[key] = waiting;
+        self.fetchCount++;
+    }
+
+    fetch(^(NSData *qrCode, NSError *error, BOOL cacheable) {
+        if (qrCode && cacheable) {
+            [self addQRCodeToCache:qrCode withParams:parameters];
+        }
+        NSArray<BNCQRCodeCacheCompletion> *completions = nil;
+        @synchronized (self) {
+            completions = self.pendingFetches[key];
+            [self.pendingFetches removeObjectForKey:key];
+        }
+        for (BNCQRCodeCacheCompletion waiter in completions) {
+            waiter(qrCode, error);
+        }
+    });
+}
+
+- (void)clear {
     @synchronized (self) {
         [self.cache removeAllObjects];
-        NSMutableDictionary *tempParams = [parameters mutableCopy];
-        [tempParams removeObjectForKey:BRANCH_REQUEST_KEY_REQUEST_CREATION_TIME_STAMP];
-        [tempParams removeObjectForKey:BRANCH_REQUEST_KEY_REQUEST_UUID];
-        [tempParams[@"data"] removeObjectForKey:@"$creation_timestamp"];
-        self.cache[tempParams] = qrCodeData;
+        [self.recentKeys removeAllObjects];
+        [self.expirations removeAllObjects];
+        self.memoryBytes = 0;
     }
+    if (!self.directoryURL) return;
+    dispatch_async(self.diskQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    });
+}
+
+- (void)synchronize {
+    dispatch_sync(self.diskQueue, ^{});
 }
 
-- (NSData *)checkQRCodeCache:(NSMutableDictionary *)parameters {
-    NSData *qrCode;
+- (NSUInteger)count {
     @synchronized (self) {
-        NSMutableDictionary *tempParams = [parameters mutableCopy];
-        [tempParams[@"data"] removeObjectForKey:@"$creation_timestamp"];
-        [tempParams removeObjectForKey:BRANCH_REQUEST_KEY_REQUEST_CREATION_TIME_STAMP];
-        [tempParams removeObjectForKey:BRANCH_REQUEST_KEY_REQUEST_UUID];
-        qrCode = self.cache[tempParams];
+        return self.cache.count;
+    }
+}
+
+- (void)setMemoryBytesLimit:(NSUInteger)memoryBytesLimit {
+    @synchronized (self) {
+        _memoryBytesLimit = memoryBytesLimit;
+        [self evictToLimit];
+    }
+}
+
+#pragma mark - Memory tier
+
+- (NSData *)dataForKey:(NSString *)key {
+    @synchronized (self) {
+        NSData *data = self.cache[key];
+        if (data && [self.expirations[key] timeIntervalSinceNow] <= 0) {
+            [self removeMemoryDataForKey:key];
+            data = nil;
+        }
+        if (data) {
+            [self.recentKeys removeObject:key];
+            [self.recentKeys addObject:key];
+            return data;
+        }
+    }
+
+    // promote disk hits so repeat lookups stay in memory
+    NSDate *expiration = nil;
+    NSData *data = [self readDiskDataForKey:key expiration:&expiration];
+    if (data) {
+        @synchronized (self) {
+            [self setMemoryData:data forKey:key expiration:expiration];
+        }
+    }
+    return data;
+}
+
+// callers hold the lock
+- (void)setMemoryData:(NSData *)data forKey:(NSString *)key expiration:(NSDate *)expiration {
+    [self removeMemoryDataForKey:key];
+    self.cache[key] = data;
+    self.expirations[key] = expiration;
+    [self.recentKeys addObject:key];
+    self.memoryBytes += data.length;
+    [self evictToLimit];
+}
+
+// callers hold the lock
+- (void)removeMemoryDataForKey:(NSString *)key {
+    NSData *data = self.cache[key];
+    if (data) {
+        self.memoryBytes -= data.length;
+        [self.cache removeObjectForKey:key];
+        [self.expirations removeObjectForKey:key];
+        [self.recentKeys removeObject:key];
+    }
+}
+
+// callers hold the lock
+- (void)evictToLimit {
+    while (self.recentKeys.count && self.memoryBytes > self.memoryBytesLimit) {
+        [self removeMemoryDataForKey:self.recentKeys.firstObject];
+    }
+}
+
+#pragma mark - Disk tier
+
+- (NSURL *)fileURLForKey:(NSString *)key {
+    return [self.directoryURL URLByAppendingPathComponent:key isDirectory:NO];
+}
+
+// The creation date is when the image was cached, the modification date is when it was last used
+- (NSData *)readDiskDataForKey:(NSString *)key expiration:(NSDate **)expiration {
+    if (!self.directoryURL) return nil;
+
+    NSURL *fileURL = [self fileURLForKey:key];
+    NSDate *created = nil;
+    [fileURL getResourceValue:&created forKey:NSURLCreationDateKey error:nil];
+    NSDate *expires = [created dateByAddingTimeInterval:self.timeToLive];
+    if (!expires || [expires timeIntervalSinceNow] <= 0) {
+        if (created) {
+            dispatch_async(self.diskQueue, ^{
+                [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+            });
+        }
+        return nil;
+    }
+
+    NSData *data = [NSData dataWithContentsOfURL:fileURL];
+    if (data) {
+        if (expiration) *expiration = expires;
+        // the modification date orders files for eviction
+        dispatch_async(self.diskQueue, ^{
+            [[NSFileManager defaultManager] setAttributes:@{ NSFileModificationDate: [NSDate date] } ofItemAtPath:fileURL.path error:nil];
+        });
+    }
+    return data;
+}
+
+- (void)writeDiskData:(NSData *)data forKey:(NSString *)key {
+    if (!self.directoryURL) return;
+
+    dispatch_async(self.diskQueue, ^{
+        NSError *error = nil;
+        [[NSFileManager defaultManager] createDirectoryAtURL:self.directoryURL withIntermediateDirectories:YES attributes:nil error:&error];
+        if (!error) {
+            [data writeToURL:[self fileURLForKey:key] options:NSDataWritingAtomic error:&error];
+        }
+        if (error) {
+            [[BranchLogger shared] logWarning:@"Failed to write QR code to disk cache" error:error];
+            return;
+        }
+        [self trimDiskToLimit];
+    });
+}
+
+// runs on the disk queue, removes expired files then the least recently used until under the limit
+- (void)trimDiskToLimit {
+    NSArray<NSURLResourceKey> *keys = @[ NSURLFileSizeKey, NSURLContentModificationDateKey, NSURLCreationDateKey ];
+    NSArray<NSURL *> *files = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.directoryURL
+                                                           includingPropertiesForKeys:keys
+                                                                              options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                                                error:nil];
+    NSUInteger totalBytes = 0;
+    NSMutableArray<NSDictionary *> *entries = [NSMutableArray arrayWithCapacity:files.count];
+    for (NSURL *file in files) {
+        NSDictionary *values = [file resourceValuesForKeys:keys error:nil];
+        NSDate *created = values[NSURLCreationDateKey];
+        if (created && [created timeIntervalSinceNow] <= -self.timeToLive) {
+            [[NSFileManager defaultManager] removeItemAtURL:file error:nil];
+            continue;
+        }
+        NSUInteger size = [values[NSURLFileSizeKey] unsignedIntegerValue];
+        totalBytes += size;
+        [entries addObject:@{ @"url": file, @"size": @(size), @"date": values[NSURLContentModificationDateKey] ?: [NSDate distantPast] }];
+    }
+    if (totalBytes <= self.diskBytesLimit) return;
+
+    [entries sortUsingComparator:^NSComparisonResult(NSDictionary *a, NSDictionary *b) {
+        return [a[@"date"] compare:b[@"date"]];
+    }];
+    for (NSDictionary *entry in entries) {
+        if (totalBytes <= self.diskBytesLimit) break;
+        if ([[NSFileManager defaultManager] removeItemAtURL:entry[@"url"] error:nil]) {
+            totalBytes -= [entry[@"size"] unsignedIntegerValue];
+        }
     }
-    return qrCode;
 }
 
 @end
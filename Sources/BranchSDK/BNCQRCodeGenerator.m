@@ -0,0 +1,114 @@
+//
+//  BNCQRCodeGenerator.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCQRCodeGenerator.h"
+#import "BNCQREncoder.h"
+#import "BranchLogger.h"
+
+// Side of the center logo relative to the code. High error correction recovers the covered modules.
+static CGFloat const BNCQRCodeLogoScale = 0.2;
+
+@implementation BNCQRCodeGenerator
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _width = 300;
+        _margin = 1;
+        _imageFormat = BranchQRCodeImageFormatPNG;
+    }
+    return self;
+}
+
+- (BOOL)supportsStyle {
+    // Pattern colors have no single fill color to draw modules with
+    for (UIColor *color in @[ self.codeColor ?: UIColor.blackColor, self.backgroundColor ?: UIColor.whiteColor ]) {
+        if (CGColorSpaceGetModel(CGColorGetColorSpace(color.CGColor)) == kCGColorSpaceModelPattern) {
+            return NO;
+        }
+    }
+    return self.width > 0 && self.margin >= 0;
+}
+
+- (NSData *)imageDataForString:(NSString *)string {
+    if (![self supportsStyle]) return nil;
+
+    NSData *payload = [string dataUsingEncoding:NSUTF8StringEncoding];
+    BNCQRErrorCorrection errorCorrection = (self.centerLogo) ? BNCQRErrorCorrectionHigh : BNCQRErrorCorrectionMedium;
+    BNCQRCode *code = BNCQRCodeCreate(payload.bytes, payload.length, errorCorrection, BNCQRMaskAuto);
+    if (!code) {
+        [[BranchLogger shared] logVerbose:@"QR code payload is too long to encode on device." error:nil];
+        return nil;
+    }
+
+    // Whole pixel modules keep edges sharp, any remainder is added to the border
+    NSInteger moduleSize = (self.width - 2 * self.margin) / code->size;
+    if (moduleSize < 1) {
+        [[BranchLogger shared] logVerbose:@"QR code width is too small to render on device." error:nil];
+        BNCQRCodeRelease(code);
+        return nil;
+    }
+    CGFloat codeSide = moduleSize * code->size;
+    CGFloat origin = floor((self.width - codeSide) / 2.0);
+
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat defaultFormat];
+    format.scale = 1.0;
+    format.opaque = (self.imageFormat == BranchQRCodeImageFormatJPEG);
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(self.width, self.width) format:format];
+
+    UIImage *image = [renderer imageWithActions:^(UIGraphicsImageRendererContext * _Nonnull rendererContext) {
+        CGContextRef context = rendererContext.CGContext;
+        [(self.backgroundColor ?: UIColor.whiteColor) setFill];
+        CGContextFillRect(context, CGRectMake(0, 0, self.width, self.width));
+
+        // one rect per horizontal run of dark modules
+        for (int y = 0; y < code->size; y++) {
+            int x = 0;
+            while (x < code->size) {
+                if (!BNCQRCodeGetModule(code, x, y)) {
+                    x++;
+                    continue;
+                }
+                int start = x;
+                while (x < code->size && BNCQRCodeGetModule(code, x, y)) {
+                    x++;
+                }
+                CGContextAddRect(context, CGRectMake(origin + start * moduleSize, origin + y * moduleSize, (x - start) * moduleSize, moduleSize));
+            }
+        }
+        [(self.codeColor ?: UIColor.blackColor) setFill];
+        CGContextFillPath(context);
+
+        if (self.centerLogo) {
+            [self drawLogoInRect:CGRectMake(origin, origin, codeSide, codeSide) moduleSize:moduleSize context:context];
+        }
+    }];
+    BNCQRCodeRelease(code);
+
+    if (self.imageFormat == BranchQRCodeImageFormatJPEG) {
+        return UIImageJPEGRepresentation(image, 1.0);
+    }
+    return UIImagePNGRepresentation(image);
+}
+
+- (void)drawLogoInRect:(CGRect)codeRect moduleSize:(NSInteger)moduleSize context:(CGContextRef)context {
+    CGSize logoSize = self.centerLogo.size;
+    if (logoSize.width <= 0 || logoSize.height <= 0) return;
+
+    CGFloat side = floor(CGRectGetWidth(codeRect) * BNCQRCodeLogoScale);
+    CGFloat scale = MIN(side / logoSize.width, side / logoSize.height);
+    CGSize fitted = CGSizeMake(logoSize.width * scale, logoSize.height * scale);
+    CGRect logoRect = CGRectMake(CGRectGetMidX(codeRect) - fitted.width / 2.0,
+                                 CGRectGetMidY(codeRect) - fitted.height / 2.0,
+                                 fitted.width, fitted.height);
+
+    // clear a one module border around the logo so it does not merge with the modules
+    [(self.backgroundColor ?: UIColor.whiteColor) setFill];
+    CGContextFillRect(context, CGRectInset(logoRect, -moduleSize, -moduleSize));
+    [self.centerLogo drawInRect:logoRect];
+}
+
+@end
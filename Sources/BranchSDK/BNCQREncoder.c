@@ -0,0 +1,478 @@
+//
+//  BNCQREncoder.c
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#include "BNCQREncoder.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// MARK: - Tables
+
+// Indexed by error correction level then version, index 0 is unused
+static const int8_t BNCQREccCodewordsPerBlock[4][41] = {
+    {-1,  7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28, 28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26, 26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28},
+    {-1, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30, 28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+    {-1, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28, 30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30},
+};
+
+static const int8_t BNCQRNumBlocks[4][41] = {
+    {-1, 1, 1, 1, 1, 1, 2, 2, 2, 2,  4,  4,  4,  4,  4,  6,  6,  6,  6,  7,  8,  8,  9,  9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25},
+    {-1, 1, 1, 1, 2, 2, 4, 4, 4, 5,  5,  5,  8,  9,  9, 10, 10, 11, 13, 14, 16, 17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49},
+    {-1, 1, 1, 2, 2, 4, 4, 6, 6, 8,  8,  8, 10, 12, 16, 12, 17, 16, 18, 21, 20, 23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68},
+    {-1, 1, 1, 2, 4, 4, 4, 5, 6, 8,  8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25, 25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81},
+};
+
+// Two bit level indicator used in the format information
+static const int BNCQRFormatBits[4] = { 1, 0, 3, 2 };
+
+// MARK: - Capacity
+
+// Modules available for data and error correction once the function patterns are placed
+static int BNCQRRawDataModules(int version) {
+    int result = (16 * version + 128) * version + 64;
+    if (version >= 2) {
+        int numAlign = version / 7 + 2;
+        result -= (25 * numAlign - 10) * numAlign - 55;
+        if (version >= 7) {
+            result -= 36;
+        }
+    }
+    return result;
+}
+
+static int BNCQRDataCodewords(int version, BNCQRErrorCorrection ecc) {
+    return BNCQRRawDataModules(version) / 8 - BNCQREccCodewordsPerBlock[ecc][version] * BNCQRNumBlocks[ecc][version];
+}
+
+static int BNCQRCharCountBits(int version) {
+    return (version <= 9) ? 8 : 16;
+}
+
+size_t BNCQRCodeByteCapacity(int version, BNCQRErrorCorrection errorCorrection) {
+    if (version < BNCQRVersionMin || version > BNCQRVersionMax ||
+        errorCorrection < BNCQRErrorCorrectionLow || errorCorrection > BNCQRErrorCorrectionHigh) {
+        return 0;
+    }
+    int bits = BNCQRDataCodewords(version, errorCorrection) * 8 - 4 - BNCQRCharCountBits(version);
+    size_t capacity = (size_t)(bits / 8);
+    size_t maxCount = ((size_t)1 << BNCQRCharCountBits(version)) - 1;
+    return (capacity < maxCount) ? capacity : maxCount;
+}
+
+// MARK: - Reed-Solomon
+
+// GF(2^8) with the QR code polynomial x^8 + x^4 + x^3 + x^2 + 1
+static uint8_t BNCQRMultiply(uint8_t x, uint8_t y) {
+    int z = 0;
+    for (int i = 7; i >= 0; i--) {
+        z = (z << 1) ^ ((z >> 7) * 0x11D);
+        z ^= ((y >> i) & 1) * x;
+    }
+    return (uint8_t)z;
+}
+
+// Generator polynomial with roots 2^0 ... 2^(degree - 1), leading coefficient omitted
+static void BNCQRComputeDivisor(int degree, uint8_t *result) {
+    memset(result, 0, (size_t)degree);
+    result[degree - 1] = 1;
+    uint8_t root = 1;
+    for (int i = 0; i < degree; i++) {
+        for (int j = 0; j < degree; j++) {
+            result[j] = BNCQRMultiply(result[j], root);
+            if (j + 1 < degree) {
+                result[j] ^= result[j + 1];
+            }
+        }
+        root = BNCQRMultiply(root, 0x02);
+    }
+}
+
+static void BNCQRComputeRemainder(const uint8_t *data, int dataLength, const uint8_t *divisor, int degree, uint8_t *result) {
+    memset(result, 0, (size_t)degree);
+    for (int i = 0; i < dataLength; i++) {
+        uint8_t factor = data[i] ^ result[0];
+        memmove(&result[0], &result[1], (size_t)(degree - 1));
+        result[degree - 1] = 0;
+        for (int j = 0; j < degree; j++) {
+            result[j] ^= BNCQRMultiply(divisor[j], factor);
+        }
+    }
+}
+
+// MARK: - Codewords
+
+static void BNCQRAppendBits(uint8_t *buffer, int *bitLength, uint32_t value, int count) {
+    for (int i = count - 1; i >= 0; i--, (*bitLength)++) {
+        if ((value >> i) & 1) {
+            buffer[*bitLength >> 3] |= (uint8_t)(1 << (7 - (*bitLength & 7)));
+        }
+    }
+}
+
+// Byte mode segment, terminator and padding, filling exactly dataCodewords bytes
+static void BNCQREncodeData(const uint8_t *data, size_t length, int version, int dataCodewords, uint8_t *result) {
+    memset(result, 0, (size_t)dataCodewords);
+    int bitLength = 0;
+    BNCQRAppendBits(result, &bitLength, 0x4, 4);
+    BNCQRAppendBits(result, &bitLength, (uint32_t)length, BNCQRCharCountBits(version));
+    for (size_t i = 0; i < length; i++) {
+        BNCQRAppendBits(result, &bitLength, data[i], 8);
+    }
+
+    int capacityBits = dataCodewords * 8;
+    int terminator = capacityBits - bitLength;
+    if (terminator > 4) terminator = 4;
+    bitLength += terminator;
+    bitLength = (bitLength + 7) & ~7;
+
+    for (uint8_t pad = 0xEC; bitLength < capacityBits; pad ^= 0xEC ^ 0x11) {
+        BNCQRAppendBits(result, &bitLength, pad, 8);
+    }
+}
+
+// Splits the data into blocks, appends error correction to each and interleaves the result
+static bool BNCQRAddErrorCorrection(const uint8_t *data, int version, BNCQRErrorCorrection ecc, uint8_t *result) {
+    int numBlocks = BNCQRNumBlocks[ecc][version];
+    int blockEccLength = BNCQREccCodewordsPerBlock[ecc][version];
+    int rawCodewords = BNCQRRawDataModules(version) / 8;
+    int numShortBlocks = numBlocks - rawCodewords % numBlocks;
+    int shortBlockLength = rawCodewords / numBlocks;
+
+    uint8_t divisor[30];
+    uint8_t *remainder = malloc((size_t)blockEccLength);
+    if (!remainder) return false;
+    BNCQRComputeDivisor(blockEccLength, divisor);
+
+    const uint8_t *blockData = data;
+    for (int i = 0; i < numBlocks; i++) {
+        int dataLength = shortBlockLength - blockEccLength + (i < numShortBlocks ? 0 : 1);
+        BNCQRComputeRemainder(blockData, dataLength, divisor, blockEccLength, remainder);
+
+        // Long blocks have one more data codeword, short blocks skip that column
+        for (int j = 0, k = i; j < dataLength; j++, k += numBlocks) {
+            if (j == shortBlockLength - blockEccLength) {
+                k -= numShortBlocks;
+            }
+            result[k] = blockData[j];
+        }
+        for (int j = 0, k = rawCodewords - blockEccLength * numBlocks + i; j < blockEccLength; j++, k += numBlocks) {
+            result[k] = remainder[j];
+        }
+        blockData += dataLength;
+    }
+    free(remainder);
+    return true;
+}
+
+// MARK: - Function patterns
+
+typedef struct {
+    int size;
+    uint8_t *modules;
+    uint8_t *isFunction;
+} BNCQRMatrix;
+
+static void BNCQRSetFunction(BNCQRMatrix *m, int x, int y, bool dark) {
+    m->modules[y * m->size + x] = dark ? 1 : 0;
+    m->isFunction[y * m->size + x] = 1;
+}
+
+static int BNCQRAlignmentPositions(int version, int size, int *result) {
+    if (version == 1) return 0;
+    int numAlign = version / 7 + 2;
+    int step = (version == 32) ? 26 : (version * 4 + numAlign * 2 + 1) / (numAlign * 2 - 2) * 2;
+    result[0] = 6;
+    for (int i = numAlign - 1, pos = size - 7; i >= 1; i--, pos -= step) {
+        result[i] = pos;
+    }
+    return numAlign;
+}
+
+static void BNCQRDrawFinder(BNCQRMatrix *m, int x, int y) {
+    for (int dy = -4; dy <= 4; dy++) {
+        for (int dx = -4; dx <= 4; dx++) {
+            int xx = x + dx, yy = y + dy;
+            if (xx < 0 || xx >= m->size || yy < 0 || yy >= m->size) continue;
+            int dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+            BNCQRSetFunction(m, xx, yy, dist != 2 && dist != 4);
+        }
+    }
+}
+
+static void BNCQRDrawAlignment(BNCQRMatrix *m, int x, int y) {
+    for (int dy = -2; dy <= 2; dy++) {
+        for (int dx = -2; dx <= 2; dx++) {
+            int dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+            BNCQRSetFunction(m, x + dx, y + dy, dist != 1);
+        }
+    }
+}
+
+static void BNCQRDrawFormatBits(BNCQRMatrix *m, BNCQRErrorCorrection ecc, int mask) {
+    int data = BNCQRFormatBits[ecc] << 3 | mask;
+    int rem = data;
+    for (int i = 0; i < 10; i++) {
+        rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    }
+    int bits = (data << 10 | rem) ^ 0x5412;
+    int size = m->size;
+
+    // Around the top left finder
+    for (int i = 0; i <= 5; i++) BNCQRSetFunction(m, 8, i, (bits >> i) & 1);
+    BNCQRSetFunction(m, 8, 7, (bits >> 6) & 1);
+    BNCQRSetFunction(m, 8, 8, (bits >> 7) & 1);
+    BNCQRSetFunction(m, 7, 8, (bits >> 8) & 1);
+    for (int i = 9; i < 15; i++) BNCQRSetFunction(m, 14 - i, 8, (bits >> i) & 1);
+
+    // Split between the other two finders
+    for (int i = 0; i < 8; i++) BNCQRSetFunction(m, size - 1 - i, 8, (bits >> i) & 1);
+    for (int i = 8; i < 15; i++) BNCQRSetFunction(m, 8, size - 15 + i, (bits >> i) & 1);
+    BNCQRSetFunction(m, 8, size - 8, true);
+}
+
+static void BNCQRDrawVersionBits(BNCQRMatrix *m, int version) {
+    if (version < 7) return;
+    int rem = version;
+    for (int i = 0; i < 12; i++) {
+        rem = (rem << 1) ^ ((rem >> 11) * 0x1F25);
+    }
+    long bits = (long)version << 12 | rem;
+    for (int i = 0; i < 18; i++) {
+        bool bit = (bits >> i) & 1;
+        int a = m->size - 11 + i % 3, b = i / 3;
+        BNCQRSetFunction(m, a, b, bit);
+        BNCQRSetFunction(m, b, a, bit);
+    }
+}
+
+static void BNCQRDrawFunctionPatterns(BNCQRMatrix *m, int version, BNCQRErrorCorrection ecc) {
+    int size = m->size;
+    for (int i = 0; i < size; i++) {
+        BNCQRSetFunction(m, 6, i, i % 2 == 0);
+        BNCQRSetFunction(m, i, 6, i % 2 == 0);
+    }
+
+    BNCQRDrawFinder(m, 3, 3);
+    BNCQRDrawFinder(m, size - 4, 3);
+    BNCQRDrawFinder(m, 3, size - 4);
+
+    int positions[7];
+    int numAlign = BNCQRAlignmentPositions(version, size, positions);
+    for (int i = 0; i < numAlign; i++) {
+        for (int j = 0; j < numAlign; j++) {
+            // skip the three corners taken by finder patterns
+            if ((i == 0 && j == 0) || (i == 0 && j == numAlign - 1) || (i == numAlign - 1 && j == 0)) continue;
+            BNCQRDrawAlignment(m, positions[i], positions[j]);
+        }
+    }
+
+    // reserve the format areas, the real bits are drawn once the mask is chosen
+    BNCQRDrawFormatBits(m, ecc, 0);
+    BNCQRDrawVersionBits(m, version);
+}
+
+// MARK: - Data placement and masking
+
+static void BNCQRDrawCodewords(BNCQRMatrix *m, const uint8_t *codewords, int length) {
+    int size = m->size;
+    int i = 0;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) right = 5;
+        for (int vert = 0; vert < size; vert++) {
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                bool upward = ((right + 1) & 2) == 0;
+                int y = upward ? size - 1 - vert : vert;
+                if (!m->isFunction[y * size + x] && i < length * 8) {
+                    m->modules[y * size + x] = (codewords[i >> 3] >> (7 - (i & 7))) & 1;
+                    i++;
+                }
+                // any remainder bits stay light
+            }
+        }
+    }
+}
+
+static void BNCQRApplyMask(BNCQRMatrix *m, int mask) {
+    int size = m->size;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            bool invert;
+            switch (mask) {
+                case 0:  invert = (x + y) % 2 == 0;                     break;
+                case 1:  invert = y % 2 == 0;                           break;
+                case 2:  invert = x % 3 == 0;                           break;
+                case 3:  invert = (x + y) % 3 == 0;                     break;
+                case 4:  invert = (x / 3 + y / 2) % 2 == 0;             break;
+                case 5:  invert = x * y % 2 + x * y % 3 == 0;           break;
+                case 6:  invert = (x * y % 2 + x * y % 3) % 2 == 0;     break;
+                default: invert = ((x + y) % 2 + x * y % 3) % 2 == 0;   break;
+            }
+            if (invert && !m->isFunction[y * size + x]) {
+                m->modules[y * size + x] ^= 1;
+            }
+        }
+    }
+}
+
+// MARK: - Penalty score
+
+static bool BNCQRDark(const BNCQRMatrix *m, int x, int y, bool vertical) {
+    if (x < 0 || x >= m->size) return false;
+    return vertical ? m->modules[x * m->size + y] : m->modules[y * m->size + x];
+}
+
+// Rules 1 and 3 along rows, or columns when vertical is true
+static long BNCQRLinePenalty(const BNCQRMatrix *m, bool vertical) {
+    static const uint8_t finder[7] = { 1, 0, 1, 1, 1, 0, 1 };
+    int size = m->size;
+    long result = 0;
+    for (int y = 0; y < size; y++) {
+        int run = 0;
+        bool color = false;
+        for (int x = 0; x < size; x++) {
+            bool dark = BNCQRDark(m, x, y, vertical);
+            if (x > 0 && dark == color) {
+                run++;
+                if (run == 5) result += 3;
+                else if (run > 5) result++;
+            } else {
+                color = dark;
+                run = 1;
+            }
+        }
+
+        for (int x = 0; x + 7 <= size; x++) {
+            bool match = true;
+            for (int k = 0; k < 7 && match; k++) {
+                match = BNCQRDark(m, x + k, y, vertical) == finder[k];
+            }
+            if (!match) continue;
+            bool lightBefore = true, lightAfter = true;
+            for (int k = 1; k <= 4; k++) {
+                lightBefore = lightBefore && !BNCQRDark(m, x - k, y, vertical);
+                lightAfter = lightAfter && !BNCQRDark(m, x + 6 + k, y, vertical);
+            }
+            if (lightBefore) result += 40;
+            if (lightAfter) result += 40;
+        }
+    }
+    return result;
+}
+
+static long BNCQRPenaltyScore(const BNCQRMatrix *m) {
+    int size = m->size;
+    long result = BNCQRLinePenalty(m, false) + BNCQRLinePenalty(m, true);
+
+    // 2x2 blocks of one color
+    for (int y = 0; y < size - 1; y++) {
+        for (int x = 0; x < size - 1; x++) {
+            uint8_t c = m->modules[y * size + x];
+            if (c == m->modules[y * size + x + 1] &&
+                c == m->modules[(y + 1) * size + x] &&
+                c == m->modules[(y + 1) * size + x + 1]) {
+                result += 3;
+            }
+        }
+    }
+
+    // balance of dark and light modules, 10 points per 5% away from half
+    long dark = 0;
+    long total = (long)size * size;
+    for (long i = 0; i < total; i++) {
+        dark += m->modules[i];
+    }
+    long k = (labs(dark * 20 - total * 10) + total - 1) / total - 1;
+    result += k * 10;
+    return result;
+}
+
+// MARK: - Public
+
+BNCQRCode *BNCQRCodeCreate(const uint8_t *data, size_t length, BNCQRErrorCorrection minErrorCorrection, int mask) {
+    if ((!data && length) || mask < BNCQRMaskAuto || mask > 7 ||
+        minErrorCorrection < BNCQRErrorCorrectionLow || minErrorCorrection > BNCQRErrorCorrectionHigh) {
+        return NULL;
+    }
+
+    int version = BNCQRVersionMin;
+    while (version <= BNCQRVersionMax && BNCQRCodeByteCapacity(version, minErrorCorrection) < length) {
+        version++;
+    }
+    if (version > BNCQRVersionMax) return NULL;
+
+    BNCQRErrorCorrection ecc = minErrorCorrection;
+    while (ecc < BNCQRErrorCorrectionHigh && BNCQRCodeByteCapacity(version, ecc + 1) >= length) {
+        ecc++;
+    }
+
+    int size = version * 4 + 17;
+    int dataCodewords = BNCQRDataCodewords(version, ecc);
+    int rawCodewords = BNCQRRawDataModules(version) / 8;
+
+    BNCQRCode *code = calloc(1, sizeof(BNCQRCode));
+    uint8_t *dataBuffer = malloc((size_t)dataCodewords);
+    uint8_t *allCodewords = malloc((size_t)rawCodewords);
+    BNCQRMatrix matrix = { size, calloc((size_t)(size * size), 1), calloc((size_t)(size * size), 1) };
+    uint8_t *best = NULL;
+    bool ok = code && dataBuffer && allCodewords && matrix.modules && matrix.isFunction;
+
+    if (ok) {
+        BNCQREncodeData(data, length, version, dataCodewords, dataBuffer);
+        ok = BNCQRAddErrorCorrection(dataBuffer, version, ecc, allCodewords);
+    }
+    if (ok) {
+        BNCQRDrawFunctionPatterns(&matrix, version, ecc);
+        BNCQRDrawCodewords(&matrix, allCodewords, rawCodewords);
+
+        if (mask == BNCQRMaskAuto) {
+            long minPenalty = -1;
+            for (int i = 0; i < 8; i++) {
+                BNCQRApplyMask(&matrix, i);
+                BNCQRDrawFormatBits(&matrix, ecc, i);
+                long penalty = BNCQRPenaltyScore(&matrix);
+                if (minPenalty < 0 || penalty < minPenalty) {
+                    mask = i;
+                    minPenalty = penalty;
+                }
+                BNCQRApplyMask(&matrix, i);  // XOR again to undo
+            }
+        }
+        BNCQRApplyMask(&matrix, mask);
+        BNCQRDrawFormatBits(&matrix, ecc, mask);
+        best = matrix.modules;
+        matrix.modules = NULL;
+    }
+
+    free(dataBuffer);
+    free(allCodewords);
+    free(matrix.modules);
+    free(matrix.isFunction);
+    if (!ok) {
+        free(code);
+        return NULL;
+    }
+
+    code->version = version;
+    code->size = size;
+    code->errorCorrection = ecc;
+    code->mask = mask;
+    code->modules = best;
+    return code;
+}
+
+void BNCQRCodeRelease(BNCQRCode *code) {
+    if (!code) return;
+    free(code->modules);
+    free(code);
+}
+
+bool BNCQRCodeGetModule(const BNCQRCode *code, int x, int y) {
+    if (!code || x < 0 || y < 0 || x >= code->size || y >= code->size) return false;
+    return code->modules[y * code->size + x] != 0;
+}
@@ -7,9 +7,18 @@
 //
 
 #import "BNCReachability.h"
+#import "BNCNetworkInterface.h"
 #import <netinet/in.h>
 #import <SystemConfiguration/SystemConfiguration.h>
 
+#if __has_feature(modules)
+@import UIKit;
+#else
+#import <UIKit/UIKit.h>
+#endif
+
+NSString * const BNCReachabilityDidChangeNotification = @"BNCReachabilityDidChangeNotification";
+
 typedef NS_ENUM(NSInteger, BNCNetworkStatus) {
     BNCNetworkStatusNotReachable,
     BNCNetworkStatusReachableViaWiFi,
@@ -18,8 +27,22 @@ typedef NS_ENUM(NSInteger, BNCNetworkStatus) {
 
 @interface BNCReachability()
 @property (nonatomic, assign, readwrite) SCNetworkReachabilityRef reachability;
+@property (nonatomic, strong, readwrite) dispatch_queue_t queue;
+
+// Current network path, updated when it changes so readers make no system calls
+@property (atomic, assign, readwrite) BOOL monitoring;
+@property (atomic, copy, readwrite) NSString *cachedStatus;
+@property (atomic, copy, readwrite) NSString *cachedLocalIPAddress;
+
+- (void)updateWithFlags:(SCNetworkReachabilityFlags)flags;
 @end
 
+static void BNCReachabilityCallback(SCNetworkReachabilityRef target, SCNetworkReachabilityFlags flags, void *info) {
+    BNCReachability *reachability = (__bridge BNCReachability *)info;
+    [reachability updateWithFlags:flags];
+    [[NSNotificationCenter defaultCenter] postNotificationName:BNCReachabilityDidChangeNotification object:reachability];
+}
+
 /**
  Based on Apple's Reachability Sample
  
@@ -39,6 +62,7 @@ typedef NS_ENUM(NSInteger, BNCNetworkStatus) {
 - (instancetype)init {
     self = [super init];
     if (self) {
+        self.queue = dispatch_queue_create("io.branch.sdk.reachability", DISPATCH_QUEUE_SERIAL);
         [self setupForInternet];
     }
     return self;
@@ -51,6 +75,45 @@ typedef NS_ENUM(NSInteger, BNCNetworkStatus) {
     zeroAddress.sin_family = AF_INET;
     
     self.reachability = SCNetworkReachabilityCreateWithAddress(kCFAllocatorDefault,  (const struct sockaddr *) &zeroAddress);
+
+    // watch for network path changes, so network info can be cached until one happens
+    if (self.reachability) {
+        SCNetworkReachabilityContext context = { 0, (__bridge void *)self, NULL, NULL, NULL };
+        if (SCNetworkReachabilitySetCallback(self.reachability, BNCReachabilityCallback, &context) &&
+            SCNetworkReachabilitySetDispatchQueue(self.reachability, self.queue)) {
+            dispatch_sync(self.queue, ^{
+                [self refresh];
+            });
+            self.monitoring = YES;
+
+            // joining another Wi-Fi network can change the address without changing reachability
+            [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationDidBecomeActive) name:UIApplicationDidBecomeActiveNotification object:nil];
+        }
+    }
+}
+
+- (void)applicationDidBecomeActive {
+    dispatch_async(self.queue, ^{
+        NSString *address = self.cachedLocalIPAddress;
+        [self refresh];
+        if (!(address == self.cachedLocalIPAddress || [address isEqualToString:self.cachedLocalIPAddress])) {
+            [[NSNotificationCenter defaultCenter] postNotificationName:BNCReachabilityDidChangeNotification object:self];
+        }
+    });
+}
+
+- (void)refresh {
+    SCNetworkReachabilityFlags flags = 0;
+    if (!SCNetworkReachabilityGetFlags(self.reachability, &flags)) {
+        flags = 0;
+    }
+    [self updateWithFlags:flags];
+}
+
+// Called on the reachability queue
+- (void)updateWithFlags:(SCNetworkReachabilityFlags)flags {
+    self.cachedStatus = [self translateReachabilityStatus:[self networkStatusForFlags:flags]];
+    self.cachedLocalIPAddress = [BNCNetworkInterface localIPAddress];
 }
 
 - (BNCNetworkStatus)networkStatusForFlags:(SCNetworkReachabilityFlags)flags {
@@ -107,11 +170,24 @@ typedef NS_ENUM(NSInteger, BNCNetworkStatus) {
 }
 
 - (nullable NSString *)reachabilityStatus {
+    if (self.monitoring) {
+        return self.cachedStatus;
+    }
     return [self translateReachabilityStatus:[self currentReachabilityStatus]];
 }
 
+- (nullable NSString *)localIPAddress {
+    if (self.monitoring) {
+        return self.cachedLocalIPAddress;
+    }
+    return [BNCNetworkInterface localIPAddress];
+}
+
 - (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
     if (self.reachability) {
+        SCNetworkReachabilitySetDispatchQueue(self.reachability, NULL);
+        SCNetworkReachabilitySetCallback(self.reachability, NULL, NULL);
         CFRelease(self.reachability);
         self.reachability = nil;
     }
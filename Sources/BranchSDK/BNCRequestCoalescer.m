@@ -0,0 +1,116 @@
+//
+//  BNCRequestCoalescer.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCRequestCoalescer.h"
+
+@interface BNCRequestFlight : NSObject
+@property (nonatomic, strong) NSMutableArray<BNCRequestCoalescerCompletion> *completions;
+@property (nonatomic, strong) dispatch_group_t group;
+@property (nonatomic, strong) id result;
+@end
+
+@implementation BNCRequestFlight
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _completions = [NSMutableArray new];
+        _group = dispatch_group_create();
+        dispatch_group_enter(_group);
+    }
+    return self;
+}
+
+@end
+
+@interface BNCRequestCoalescer ()
+@property (nonatomic, strong) NSMutableDictionary<id<NSCopying>, BNCRequestFlight *> *flights;
+@property (nonatomic, assign, readwrite) NSUInteger coalescedCount;
+@end
+
+@implementation BNCRequestCoalescer
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _flights = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (NSUInteger)inFlightCount {
+    @synchronized (self) {
+        return self.flights.count;
+    }
+}
+
+// Returns the flight for key, and whether the caller created it and must run the request
+- (BNCRequestFlight *)flightForKey:(id<NSCopying>)key completion:(BNCRequestCoalescerCompletion)completion isNew:(BOOL *)isNew {
+    @synchronized (self) {
+        BNCRequestFlight *flight = self.flights[key];
+        *isNew = (flight == nil);
+        if (flight) {
+            self.coalescedCount++;
+        } else {
+            flight = [BNCRequestFlight new];
+            self.flights[key] = flight;
+        }
+        if (completion) [flight.completions addObject:[completion copy]];
+        return flight;
+    }
+}
+
+- (NSArray<BNCRequestCoalescerCompletion> *)finishFlight:(BNCRequestFlight *)flight forKey:(id<NSCopying>)key result:(id)result {
+    NSArray<BNCRequestCoalescerCompletion> *completions = nil;
+    @synchronized (self) {
+        if (self.flights[key] != flight) return nil;
+        [self.flights removeObjectForKey:key];
+        completions = [flight.completions copy];
+        flight.result = result;
+    }
+    dispatch_group_leave(flight.group);
+    return completions;
+}
+
+- (void)performForKey:(id<NSCopying>)key work:(void (^)(BNCRequestCoalescerCompletion))work completion:(BNCRequestCoalescerCompletion)completion {
+    BOOL isNew = NO;
+    BNCRequestFlight *flight = [self flightForKey:key completion:completion isNew:&isNew];
+    if (!isNew) return;
+
+    work(^(id result, NSError *error) {
+        for (BNCRequestCoalescerCompletion waiter in [self finishFlight:flight forKey:key result:result]) {
+            waiter(result, error);
+        }
+    });
+}
+
+- (void)failAllWithError:(NSError *)error {
+    NSArray<BNCRequestFlight *> *flights = nil;
+    @synchronized (self) {
+        flights = self.flights.allValues;
+        [self.flights removeAllObjects];
+    }
+    for (BNCRequestFlight *flight in flights) {
+        dispatch_group_leave(flight.group);
+        for (BNCRequestCoalescerCompletion waiter in flight.completions) {
+            waiter(nil, error);
+        }
+    }
+}
+
+- (id)performSynchronouslyForKey:(id<NSCopying>)key work:(id (^)(void))work {
+    BOOL isNew = NO;
+    BNCRequestFlight *flight = [self flightForKey:key completion:nil isNew:&isNew];
+    if (!isNew) {
+        dispatch_group_wait(flight.group, DISPATCH_TIME_FOREVER);
+        return flight.result;
+    }
+
+    id result = work();
+    [self finishFlight:flight forKey:key result:result];
+    return result;
+}
+
+@end
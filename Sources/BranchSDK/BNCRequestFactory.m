@@ -33,7 +33,8 @@
 #import "BNCSKAdNetwork.h"
 #import "BNCReferringURLUtility.h"
 #import "BNCPasteboard.h"
-#import "BNCODMInfoCollector.h"
+#import "BNCThirdPartySignals.h"
+#import "BNCTrace.h"
 #import "BranchConfigurationController.h"
 
 @interface BNCRequestFactory()
@@ -76,33 +77,14 @@
 
 - (void) loadDataFromThirdPartyAPIs {
 #if !TARGET_OS_TV
-    dispatch_group_t apiGroup = dispatch_group_create();
-    dispatch_queue_t concurrentQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
-    
-    if (![self.preferenceHelper attributionLevelInitialized] || [[self.preferenceHelper attributionLevel] isEqualToString:BranchAttributionLevelFull])
-    {
-        dispatch_group_enter(apiGroup);
-        dispatch_async(concurrentQueue, ^{
-            [[BNCODMInfoCollector instance] loadODMInfoWithCompletionHandler:^(NSString * _Nullable odmInfo, NSError * _Nullable error) {
-                self.odmInfo = odmInfo;
-                dispatch_group_leave(apiGroup);
-            }];
-        });
-    }
-    
-    if (!self.preferenceHelper.appleAttributionTokenChecked) {
-        dispatch_group_enter(apiGroup);
-        dispatch_async(concurrentQueue, ^{
-            self.appleAttributionToken = [BNCSystemObserver appleAttributionToken];
-            dispatch_group_leave(apiGroup);
-        });
-    }
-    
-    NSTimeInterval timeoutSeconds = [BNCPreferenceHelper sharedInstance].thirdPartyAPIsWaitTime;
-    dispatch_time_t timeOut = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeoutSeconds * NSEC_PER_SEC));
-    dispatch_group_wait(apiGroup, timeOut);
+    // Gathering started at init, this only waits for what is left of the wait time since then
+    BNCThirdPartySignals *signals = [BNCThirdPartySignals shared];
+    BNC_TRACE_BEGIN("third_party_signals_wait");
+    [signals waitForSignalsUntilDeadline];
+    BNC_TRACE_END("third_party_signals_wait");
+    self.odmInfo = signals.odmInfo;
+    self.appleAttributionToken = signals.appleAttributionToken;
 #endif
-    
 }
 
 // SDK level tracking control
@@ -113,6 +95,7 @@
 }
 
 - (NSDictionary *)dataForInstallWithURLString:(NSString *)urlString {
+    BNC_TRACE_BEGIN("build_install_request");
     NSMutableDictionary *json = [NSMutableDictionary new];
     
     [self loadDataFromThirdPartyAPIs];
@@ -170,10 +153,12 @@
     // Add Operation Metrics for Install only.
     [self addOperationalMetrics:json];
 
+    BNC_TRACE_END("build_install_request");
     return json;
 }
 
 - (NSDictionary *)dataForOpenWithURLString:(NSString *)urlString {
+    BNC_TRACE_BEGIN("build_open_request");
     NSMutableDictionary *json = [NSMutableDictionary new];
     
     [self loadDataFromThirdPartyAPIs];
@@ -233,6 +218,7 @@
     // Add Enhanced Web UX params
     [self addWebUXParams:json];
     
+    BNC_TRACE_END("build_open_request");
     return json;
 }
 
@@ -545,7 +531,7 @@
 
 // POST requests include instrumentation
 - (void)addInstrumentationToJSON:(NSMutableDictionary *)json {
-    NSDictionary *instrumentationDictionary = self.preferenceHelper.instrumentationParameters;
+    NSDictionary *instrumentationDictionary = [self.preferenceHelper takeInstrumentationParameters];
     if (instrumentationDictionary) {
         json[BRANCH_REQUEST_KEY_INSTRUMENTATION] = instrumentationDictionary;
     }
@@ -595,67 +581,39 @@
 }
 
 - (NSDictionary *)v2dictionary {
-    NSMutableDictionary *dictionary = [NSMutableDictionary new];
-    @synchronized (self.deviceInfo) {
-        [self.deviceInfo checkAdvertisingIdentifier];
-        
-        BOOL disableAdNetworkCallouts = self.preferenceHelper.disableAdNetworkCallouts;
-        if (disableAdNetworkCallouts) {
-            dictionary[@"disable_ad_network_callouts"] = [NSNumber numberWithBool:disableAdNetworkCallouts];
-        }
-        
-        if (self.preferenceHelper.isDebug) {
-            dictionary[@"unidentified_device"] = @(YES);
-        } else {
-            BranchAttributionLevel attributionLevel = [self.preferenceHelper attributionLevel];
-            
-            if ([attributionLevel isEqualToString:BranchAttributionLevelFull] ||
-                ![self.preferenceHelper attributionLevelInitialized]) {
-                [dictionary bnc_safeSetObject:self.deviceInfo.advertiserId forKey:@"idfa"];
-            }
+    // device fields only change on system notifications, so they are copied from a shared snapshot
+    NSMutableDictionary *dictionary = [[self.deviceInfo userDataSnapshot] mutableCopy];
 
-            if (![attributionLevel isEqualToString:BranchAttributionLevelNone] ||
-                ![self.preferenceHelper attributionLevelInitialized]) {
-                [dictionary bnc_safeSetObject:self.deviceInfo.vendorId forKey:@"idfv"];
-            }
-        }
-        
-        [dictionary bnc_safeSetObject:self.deviceInfo.anonId forKey:@"anon_id"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.localIPAddress forKey:@"local_ip"];
+    BOOL disableAdNetworkCallouts = self.preferenceHelper.disableAdNetworkCallouts;
+    if (disableAdNetworkCallouts) {
+        dictionary[@"disable_ad_network_callouts"] = [NSNumber numberWithBool:disableAdNetworkCallouts];
+    }
 
-        [dictionary bnc_safeSetObject:self.deviceInfo.optedInStatus forKey:@"opted_in_status"];
+    if (self.preferenceHelper.isDebug) {
+        [dictionary removeObjectsForKeys:@[ @"idfa", @"idfv" ]];
+        dictionary[@"unidentified_device"] = @(YES);
+    } else {
+        BranchAttributionLevel attributionLevel = [self.preferenceHelper attributionLevel];
 
-        if (self.preferenceHelper.limitFacebookTracking) {
-            dictionary[@"limit_facebook_tracking"] = @(YES);
+        if (![attributionLevel isEqualToString:BranchAttributionLevelFull] &&
+            [self.preferenceHelper attributionLevelInitialized]) {
+            [dictionary removeObjectForKey:@"idfa"];
         }
-        [dictionary bnc_safeSetObject:self.deviceInfo.brandName forKey:@"brand"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.modelName forKey:@"model"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.osName forKey:@"os"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.osVersion forKey:@"os_version"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.osBuildVersion forKey:@"build"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.environment forKey:@"environment"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.cpuType forKey:@"cpu_type"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.screenScale forKey:@"screen_dpi"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.screenHeight forKey:@"screen_height"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.screenWidth forKey:@"screen_width"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.locale forKey:@"locale"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.country forKey:@"country"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.language forKey:@"language"];
-        [dictionary bnc_safeSetObject:[self.deviceInfo connectionType] forKey:@"connection_type"];
-        [dictionary bnc_safeSetObject:[self.deviceInfo userAgentString] forKey:@"user_agent"];
-
-        [dictionary bnc_safeSetObject:[BNCPreferenceHelper sharedInstance].userIdentity forKey:@"developer_identity"];
-        
-        [dictionary bnc_safeSetObject:[BNCPreferenceHelper sharedInstance].randomizedDeviceToken forKey:@"randomized_device_token"];
 
-        [dictionary bnc_safeSetObject:self.deviceInfo.applicationVersion forKey:@"app_version"];
+        if ([attributionLevel isEqualToString:BranchAttributionLevelNone] &&
+            [self.preferenceHelper attributionLevelInitialized]) {
+            [dictionary removeObjectForKey:@"idfv"];
+        }
+    }
 
-        [dictionary bnc_safeSetObject:self.deviceInfo.pluginName forKey:@"plugin_name"];
-        [dictionary bnc_safeSetObject:self.deviceInfo.pluginVersion forKey:@"plugin_version"];
-        dictionary[@"sdk_version"] = BNC_SDK_VERSION;
-        dictionary[@"sdk"] = @"ios";
+    if (self.preferenceHelper.limitFacebookTracking) {
+        dictionary[@"limit_facebook_tracking"] = @(YES);
     }
 
+    [dictionary bnc_safeSetObject:[BNCPreferenceHelper sharedInstance].userIdentity forKey:@"developer_identity"];
+
+    [dictionary bnc_safeSetObject:[BNCPreferenceHelper sharedInstance].randomizedDeviceToken forKey:@"randomized_device_token"];
+
     // Add DMA Compliance Params for Google
     [self addDMAConsentParamsToJSON:dictionary];
     
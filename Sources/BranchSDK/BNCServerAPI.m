@@ -55,6 +55,10 @@
     return [[self getBaseURLForLinkingEndpoints:YES] stringByAppendingString: @"/v1/url"];
 }
 
+- (NSString *)linkBulkServiceURL {
+    return [[self getBaseURLForLinkingEndpoints:YES] stringByAppendingString: @"/v1/url/bulk"];
+}
+
 - (NSString *)qrcodeServiceURL {
     return [[self getBaseURLForLinkingEndpoints:YES] stringByAppendingString: @"/v1/qr-code"];
 }
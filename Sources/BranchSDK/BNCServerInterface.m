@@ -92,6 +92,20 @@
     }];
 }
 
+- (void)postRequestWithArray:(NSArray<NSDictionary *> *)post url:(NSString *)url key:(NSString *)key callback:(BNCServerCallback)callback {
+    // Only linking endpoints take an array, so these are not dropped when tracking is disabled
+    self.requestEndpoint = url;
+    NSURLRequest *request = [self preparePostRequestWithArray:post url:url retryNumber:0];
+
+    [self genericHTTPRequest:request
+                 retryNumber:0
+                expectsArray:YES
+                    callback:callback
+                retryHandler:^ NSURLRequest *(NSInteger lastRetryNumber) {
+        return [self preparePostRequestWithArray:post url:url retryNumber:lastRetryNumber+1];
+    }];
+}
+
 // Only used by BranchShortUrlSyncRequest
 - (BNCServerResponse *)postRequestSynchronous:(NSDictionary *)post url:(NSString *)url key:(NSString *)key {
     NSURLRequest *request = [self preparePostRequest:post url:url key:key retryNumber:0];
@@ -108,11 +122,16 @@
 }
 
 - (void)genericHTTPRequest:(NSURLRequest *)request retryNumber:(NSInteger)retryNumber callback:(BNCServerCallback)callback retryHandler:(NSURLRequest *(^)(NSInteger))retryHandler {
+    [self genericHTTPRequest:request retryNumber:retryNumber expectsArray:NO callback:callback retryHandler:retryHandler];
+}
+
+// expectsArray is set for endpoints that answer with a JSON array rather than a dictionary
+- (void)genericHTTPRequest:(NSURLRequest *)request retryNumber:(NSInteger)retryNumber expectsArray:(BOOL)expectsArray callback:(BNCServerCallback)callback retryHandler:(NSURLRequest *(^)(NSInteger))retryHandler {
     
     void (^completionHandler)(id<BNCNetworkOperationProtocol>operation) =
         ^void (id<BNCNetworkOperationProtocol>operation) {
 
-            BNCServerResponse *serverResponse = [self processServerResponse:operation.response data:operation.responseData error:operation.error];
+            BNCServerResponse *serverResponse = [self processServerResponse:operation.response data:operation.responseData error:operation.error expectsArray:expectsArray];
             [self collectInstrumentationMetricsWithOperation:operation];
 
             // If the phone is in a poor network condition,
@@ -135,7 +154,7 @@
                     if (retryHandler) {
                         [[BranchLogger shared] logDebug: [NSString stringWithFormat:@"Retrying request with HTTP status code %ld", (long)status] error:underlyingError];
                         NSURLRequest *retryRequest = retryHandler(retryNumber);
-                        [self genericHTTPRequest:retryRequest retryNumber:(retryNumber + 1) callback:callback retryHandler:retryHandler];
+                        [self genericHTTPRequest:retryRequest retryNumber:(retryNumber + 1) expectsArray:expectsArray callback:callback retryHandler:retryHandler];
                     }
                 });
                 
@@ -151,7 +170,7 @@
                         // If a network request is successful, the `data` field will be populated with the error response from the service
                         // We have to create an NSError object here to pass down to callback.
                         
-                        if(serverResponse.data && serverResponse.data[@"error"] != nil){
+                        if([serverResponse.data isKindOfClass:NSDictionary.class] && serverResponse.data[@"error"] != nil){
                             id errorJson = serverResponse.data[@"error"];
                             
                             if(errorJson[@"message"] != nil){
@@ -260,7 +279,7 @@
             completion:^void (id<BNCNetworkOperationProtocol>operation) {
                 serverResponse =
                     [self processServerResponse:operation.response
-                        data:operation.responseData error:operation.error];
+                        data:operation.responseData error:operation.error expectsArray:NO];
                 [self collectInstrumentationMetricsWithOperation:operation];                    
                 dispatch_semaphore_signal(semaphore);
             }];
@@ -312,7 +331,34 @@
     return request;
 }
 
-- (BNCServerResponse *)processServerResponse:(NSURLResponse *)response data:(NSData *)data error:(NSError *)error {
+- (NSURLRequest *)preparePostRequestWithArray:(NSArray<NSDictionary *> *)params url:(NSString *)url retryNumber:(NSInteger)retryNumber {
+
+    NSMutableArray *updatedParams = [NSMutableArray arrayWithCapacity:params.count];
+    for (NSDictionary *item in params) {
+        [updatedParams addObject:[self addRetryCount:retryNumber toJSON:item]];
+    }
+
+    // Link data may hold dates and URLs, which NSJSONSerialization throws on
+    NSData *postData = [[BNCEncodingUtils encodeArrayToJsonString:updatedParams] dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *postLength = [NSString stringWithFormat:@"%lu", (unsigned long)[postData length]];
+
+    NSMutableURLRequest *request =
+        [NSMutableURLRequest requestWithURL:[NSURL URLWithString:url]
+            cachePolicy:NSURLRequestReloadIgnoringLocalCacheData
+            timeoutInterval:self.preferenceHelper.timeout];
+    [request setHTTPMethod:@"POST"];
+    [request setValue:postLength forHTTPHeaderField:@"Content-Length"];
+    [request setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+    [request setHTTPBody:postData];
+
+    if ([[BranchLogger shared] shouldLog:BranchLogLevelDebug]) {
+        [[BranchLogger shared] logDebug:[NSString stringWithFormat:@"%@\nHeaders %@\nBody %@ links", request, [request allHTTPHeaderFields], @(updatedParams.count)] error:nil request:request response:nil];
+    }
+
+    return request;
+}
+
+- (BNCServerResponse *)processServerResponse:(NSURLResponse *)response data:(NSData *)data error:(NSError *)error expectsArray:(BOOL)expectsArray {
     BNCServerResponse *serverResponse = [[BNCServerResponse alloc] init];
     NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
     NSString *requestId = httpResponse.allHeaderFields[@"X-Branch-Request-Id"];
@@ -323,7 +369,15 @@
 
     if (!error) {
         serverResponse.statusCode = @([httpResponse statusCode]);
-        serverResponse.data = [BNCEncodingUtils decodeJsonDataToDictionary:data];
+        id json = nil;
+        if (expectsArray && data.length) {
+            json = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:nil];
+        }
+        if ([json isKindOfClass:NSArray.class]) {
+            serverResponse.data = json;
+        } else {
+            serverResponse.data = [BNCEncodingUtils decodeJsonDataToDictionary:data];
+        }
         serverResponse.requestId = requestId;
      
         if ([[BranchLogger shared] shouldLog:BranchLogLevelDebug]) {
@@ -346,10 +400,7 @@
 - (void)collectInstrumentationMetricsWithOperation:(id<BNCNetworkOperationProtocol>)operation {
     // multiplying by negative because startTime happened in the past
     NSTimeInterval elapsedTime = [operation.startDate timeIntervalSinceNow] * -1000.0;
-    NSString *lastRoundTripTime = [[NSNumber numberWithDouble:floor(elapsedTime)] stringValue];
-    NSString * brttKey = [NSString stringWithFormat:@"%@-brtt", self.requestEndpoint];
-    [self.preferenceHelper clearInstrumentationDictionary];
-    [self.preferenceHelper addInstrumentationDictionaryKey:brttKey value:lastRoundTripTime];
+    [self.preferenceHelper addRoundTripTime:floor(elapsedTime) forEndpoint:self.requestEndpoint];
 }
 
 - (NSDictionary *)addRetryCount:(NSInteger)count toJSON:(NSDictionary *)json {
@@ -17,6 +17,8 @@
 
 #import "BranchLogger.h"
 
+NSString * const BNCServerRequestQueueDidClearNotification = @"BNCServerRequestQueueDidClearNotification";
+
 @interface BNCServerRequestQueue()
 @property (strong, nonatomic) NSMutableArray<BNCServerRequest *> *queue;
 @end
@@ -116,6 +118,7 @@
     @synchronized (self) {
         [self.queue removeAllObjects];
     }
+    [[NSNotificationCenter defaultCenter] postNotificationName:BNCServerRequestQueueDidClearNotification object:self];
 }
 
 - (BOOL)containsInstallOrOpen {
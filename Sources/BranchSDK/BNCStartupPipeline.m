@@ -0,0 +1,174 @@
+//
+//  BNCStartupPipeline.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCStartupPipeline.h"
+#import "BranchLogger.h"
+#import "BNCTrace.h"
+
+@interface BNCStartupStage : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, copy) NSArray<NSString *> *dependencies;
+@property (nonatomic, copy) void (^work)(dispatch_block_t complete);
+
+// entered when the stage is added, left when it completes
+@property (nonatomic, strong) dispatch_group_t group;
+@property (nonatomic, assign) BOOL scheduled;
+@property (nonatomic, assign) BOOL complete;
+@property (nonatomic, assign) NSTimeInterval beginTime;
+@property (nonatomic, assign) uint64_t traceID;
+@end
+
+@implementation BNCStartupStage
+@end
+
+@interface BNCStartupPipeline ()
+@property (nonatomic, strong) NSMutableDictionary<NSString *, BNCStartupStage *> *stages;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *timings;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *completionTimes;
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, assign) BOOL started;
+@property (nonatomic, assign) NSTimeInterval startTime;
+@end
+
+@implementation BNCStartupPipeline
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _stages = [NSMutableDictionary new];
+        _timings = [NSMutableDictionary new];
+        _completionTimes = [NSMutableDictionary new];
+        _queue = dispatch_queue_create("io.branch.sdk.startup", DISPATCH_QUEUE_CONCURRENT);
+    }
+    return self;
+}
+
+- (void)addStage:(NSString *)name dependencies:(NSArray<NSString *> *)dependencies work:(void (^)(dispatch_block_t complete))work {
+    BNCStartupStage *stage = [BNCStartupStage new];
+    stage.name = name;
+    stage.dependencies = dependencies ?: @[];
+    stage.work = work;
+    stage.group = dispatch_group_create();
+    dispatch_group_enter(stage.group);
+
+    BOOL started = NO;
+    @synchronized (self) {
+        if (self.stages[name]) {
+            [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Startup stage %@ was already added.", name] error:nil];
+            return;
+        }
+        self.stages[name] = stage;
+        started = self.started;
+    }
+    if (started) {
+        [self scheduleStage:stage];
+    }
+}
+
+- (void)start {
+    NSArray<BNCStartupStage *> *stages = nil;
+    @synchronized (self) {
+        if (self.started) return;
+        self.started = YES;
+        self.startTime = [NSDate timeIntervalSinceReferenceDate];
+        stages = self.stages.allValues;
+    }
+    for (BNCStartupStage *stage in stages) {
+        [self scheduleStage:stage];
+    }
+}
+
+- (void)scheduleStage:(BNCStartupStage *)stage {
+    @synchronized (self) {
+        if (stage.scheduled) return;
+        stage.scheduled = YES;
+    }
+
+    [self notifyWhenStagesComplete:stage.dependencies queue:self.queue block:^{
+        stage.beginTime = [NSDate timeIntervalSinceReferenceDate];
+        if (BNCTraceIsEnabled()) {
+            stage.traceID = BNCTraceNextIdentifier();
+            BNCTraceRecord(BNCTracePhaseAsyncBegin, stage.name.UTF8String, stage.traceID);
+        }
+        stage.work(^{
+            [self completeStage:stage];
+        });
+    }];
+}
+
+- (void)completeStage:(BNCStartupStage *)stage {
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    double duration = (now - stage.beginTime) * 1000.0;
+    double completion = 0;
+    @synchronized (self) {
+        if (stage.complete) return;
+        stage.complete = YES;
+        completion = (now - self.startTime) * 1000.0;
+        self.timings[stage.name] = @(duration);
+        self.completionTimes[stage.name] = @(completion);
+    }
+
+    BNC_TRACE_ASYNC_END(stage.name.UTF8String, stage.traceID);
+    [[BranchLogger shared] logDebug:[NSString stringWithFormat:@"Startup stage %@ took %.1f ms, complete at %.1f ms.", stage.name, duration, completion] error:nil];
+    dispatch_group_leave(stage.group);
+}
+
+- (NSArray<dispatch_group_t> *)groupsForStages:(NSArray<NSString *> *)names {
+    NSMutableArray<dispatch_group_t> *groups = [NSMutableArray new];
+    @synchronized (self) {
+        for (NSString *name in names) {
+            dispatch_group_t group = self.stages[name].group;
+            if (group) [groups addObject:group];
+        }
+    }
+    return groups;
+}
+
+- (void)notifyWhenStagesComplete:(NSArray<NSString *> *)stages queue:(dispatch_queue_t)queue block:(dispatch_block_t)block {
+    NSArray<dispatch_group_t> *groups = [self groupsForStages:stages];
+    if (groups.count == 1) {
+        dispatch_group_notify(groups.firstObject, queue, block);
+        return;
+    }
+
+    dispatch_group_t all = dispatch_group_create();
+    for (dispatch_group_t group in groups) {
+        dispatch_group_enter(all);
+        dispatch_group_notify(group, self.queue, ^{
+            dispatch_group_leave(all);
+        });
+    }
+    dispatch_group_notify(all, queue, block);
+}
+
+- (BOOL)waitForStages:(NSArray<NSString *> *)stages timeout:(NSTimeInterval)timeout {
+    dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC));
+    for (dispatch_group_t group in [self groupsForStages:stages]) {
+        if (dispatch_group_wait(group, deadline) != 0) return NO;
+    }
+    return YES;
+}
+
+- (BOOL)isStageComplete:(NSString *)name {
+    @synchronized (self) {
+        BNCStartupStage *stage = self.stages[name];
+        return !stage || stage.complete;
+    }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)stageTimings {
+    @synchronized (self) {
+        return [self.timings copy];
+    }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)stageCompletionTimes {
+    @synchronized (self) {
+        return [self.completionTimes copy];
+    }
+}
+
+@end
@@ -0,0 +1,144 @@
+//
+//  BNCThirdPartySignals.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if !TARGET_OS_TV
+
+#import "BNCThirdPartySignals.h"
+#import "BNCODMInfoCollector.h"
+#import "BNCPreferenceHelper.h"
+#import "BNCSystemObserver.h"
+#import "Branch.h"
+#import "BranchLogger.h"
+
+@interface BNCThirdPartySignals ()
+@property (nonatomic, strong) BNCPreferenceHelper *preferenceHelper;
+
+// the latest load, left once each of its signals is loaded
+@property (nonatomic, strong) dispatch_group_t group;
+@property (nonatomic, assign) dispatch_time_t deadline;
+
+@property (atomic, copy, readwrite) NSString *loadedAttributionToken;
+@property (atomic, strong) NSDate *attributionTokenDate;
+@end
+
+@implementation BNCThirdPartySignals
+
++ (BNCThirdPartySignals *)shared {
+    static BNCThirdPartySignals *signals = nil;
+    static dispatch_once_t onceToken = 0;
+    dispatch_once(&onceToken, ^{
+        signals = [[BNCThirdPartySignals alloc] initWithPreferenceHelper:[BNCPreferenceHelper sharedInstance]];
+    });
+    return signals;
+}
+
+- (instancetype)initWithPreferenceHelper:(BNCPreferenceHelper *)preferenceHelper {
+    if ((self = [super init])) {
+        _preferenceHelper = preferenceHelper;
+        _attributionTokenValidityWindow = 24 * 60 * 60;
+    }
+    return self;
+}
+
+- (BOOL)odmInfoAllowed {
+    return ![self.preferenceHelper attributionLevelInitialized] || [[self.preferenceHelper attributionLevel] isEqualToString:BranchAttributionLevelFull];
+}
+
+- (BOOL)attributionTokenNeeded {
+    return !self.preferenceHelper.appleAttributionTokenChecked && !self.appleAttributionToken;
+}
+
+- (void)gatherSignalsWithCompletion:(dispatch_block_t)completion {
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+    dispatch_group_t group = nil;
+    @synchronized (self) {
+        BOOL loading = (self.group && dispatch_group_wait(self.group, DISPATCH_TIME_NOW) != 0);
+        if (!loading) {
+            BOOL loadODMInfo = [self odmInfoAllowed] && !self.preferenceHelper.odmInfo;
+            BOOL loadAttributionToken = [self attributionTokenNeeded];
+            if (loadODMInfo || loadAttributionToken || !self.group) {
+                [self startLoadingODMInfo:loadODMInfo attributionToken:loadAttributionToken];
+            }
+        }
+        group = self.group;
+    }
+    if (completion) {
+        dispatch_group_notify(group, queue, completion);
+    }
+}
+
+// Called while synchronized on self
+- (void)startLoadingODMInfo:(BOOL)loadODMInfo attributionToken:(BOOL)loadAttributionToken {
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+    NSTimeInterval waitTime = self.preferenceHelper.thirdPartyAPIsWaitTime;
+    dispatch_group_t group = dispatch_group_create();
+    self.group = group;
+    self.deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(waitTime * NSEC_PER_SEC));
+
+    if (loadODMInfo) {
+        dispatch_group_enter(group);
+        dispatch_async(queue, ^{
+            [self loadODMInfoWithCompletion:^{
+                dispatch_group_leave(group);
+            }];
+        });
+    }
+
+    if (loadAttributionToken) {
+        dispatch_group_enter(group);
+        dispatch_async(queue, ^{
+            NSString *token = [self loadAppleAttributionToken];
+            if (token) {
+                self.attributionTokenDate = [NSDate date];
+                self.loadedAttributionToken = token;
+            }
+            dispatch_group_leave(group);
+        });
+    }
+}
+
+- (void)waitForSignalsUntilDeadline {
+    [self gatherSignalsWithCompletion:nil];
+
+    dispatch_group_t group = nil;
+    dispatch_time_t deadline = 0;
+    @synchronized (self) {
+        group = self.group;
+        deadline = self.deadline;
+    }
+    if (dispatch_group_wait(group, deadline) != 0) {
+        [[BranchLogger shared] logDebug:@"Third party signals were not loaded by the deadline." error:nil];
+    }
+}
+
+- (void)loadODMInfoWithCompletion:(void (^)(void))completion {
+    [[BNCODMInfoCollector instance] loadODMInfoWithCompletionHandler:^(NSString * _Nullable odmInfo, NSError * _Nullable error) {
+        completion();
+    }];
+}
+
+- (NSString *)loadAppleAttributionToken {
+    return [BNCSystemObserver appleAttributionToken];
+}
+
+#pragma mark - Signals
+
+- (NSString *)odmInfo {
+    NSString *odmInfo = self.preferenceHelper.odmInfo;
+    if (!odmInfo) return nil;
+    BOOL valid = [[BNCODMInfoCollector instance] isWithinValidityWindow:self.preferenceHelper.odmInfoInitDate timeInterval:self.preferenceHelper.odmInfoValidityWindow];
+    return (valid) ? odmInfo : nil;
+}
+
+- (NSString *)appleAttributionToken {
+    NSDate *date = self.attributionTokenDate;
+    if (!date || [date timeIntervalSinceNow] < -self.attributionTokenValidityWindow) return nil;
+    return self.loadedAttributionToken;
+}
+
+@end
+#endif
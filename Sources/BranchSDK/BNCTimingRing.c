@@ -0,0 +1,220 @@
+//
+//  BNCTimingRing.c
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#include "BNCTimingRing.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// MARK: - Ring
+
+// Record n lives in slot n & mask. A slot's sequence is 2n + 1 while record n is written and 2n + 2 once it is complete,
+// so a reader can tell a complete record from one in progress, one from an earlier lap or one already overwritten.
+typedef struct {
+    _Atomic uint64_t sequence;
+    _Atomic uint32_t endpoint;
+    _Atomic uint32_t milliseconds;
+} BNCTimingSlot;
+
+struct BNCTimingRing {
+    _Atomic uint64_t head;      // next record number
+    _Atomic uint64_t tail;      // first record not consumed
+    size_t mask;
+    BNCTimingSlot *slots;
+};
+
+typedef struct {
+    uint64_t number;
+    uint32_t endpoint;
+    uint32_t milliseconds;
+} BNCTimingRecord;
+
+BNCTimingRing *BNCTimingRingCreate(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    BNCTimingRing *ring = calloc(1, sizeof(BNCTimingRing));
+    if (!ring) return NULL;
+    ring->slots = calloc(size, sizeof(BNCTimingSlot));
+    if (!ring->slots) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&ring->slots[i].sequence, 0);
+        atomic_init(&ring->slots[i].endpoint, 0);
+        atomic_init(&ring->slots[i].milliseconds, 0);
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ring;
+}
+
+void BNCTimingRingRelease(BNCTimingRing *ring) {
+    if (!ring) return;
+    free(ring->slots);
+    free(ring);
+}
+
+// FNV-1a
+uint32_t BNCTimingRingEndpointID(const char *endpoint, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)endpoint[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void BNCTimingRingRecord(BNCTimingRing *ring, uint32_t endpoint, uint32_t milliseconds) {
+    if (!ring) return;
+    uint64_t number = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed);
+    BNCTimingSlot *slot = &ring->slots[number & ring->mask];
+
+    // Only move a slot forward. A writer stalled for a whole lap gives up rather than hide a newer record.
+    uint64_t writing = 2 * number + 1;
+    uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    do {
+        if (sequence >= writing) return;
+    } while (!atomic_compare_exchange_weak_explicit(&slot->sequence, &sequence, writing, memory_order_relaxed, memory_order_relaxed));
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->endpoint, endpoint, memory_order_relaxed);
+    atomic_store_explicit(&slot->milliseconds, milliseconds, memory_order_relaxed);
+
+    sequence = writing;
+    atomic_compare_exchange_strong_explicit(&slot->sequence, &sequence, writing + 1, memory_order_release, memory_order_relaxed);
+}
+
+// MARK: - Summaries
+
+typedef enum {
+    BNCTimingReadComplete,
+    BNCTimingReadPending,
+    BNCTimingReadOverwritten
+} BNCTimingReadResult;
+
+static BNCTimingReadResult BNCTimingRingRead(const BNCTimingRing *ring, uint64_t number, BNCTimingRecord *record) {
+    BNCTimingSlot *slot = &ring->slots[number & ring->mask];
+    uint64_t complete = 2 * number + 2;
+
+    uint64_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (before < complete) return BNCTimingReadPending;
+    if (before > complete) return BNCTimingReadOverwritten;
+
+    record->number = number;
+    record->endpoint = atomic_load_explicit(&slot->endpoint, memory_order_relaxed);
+    record->milliseconds = atomic_load_explicit(&slot->milliseconds, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    return (after == before) ? BNCTimingReadComplete : BNCTimingReadOverwritten;
+}
+
+static int BNCTimingRecordCompare(const void *a, const void *b) {
+    const BNCTimingRecord *x = a, *y = b;
+    if (x->endpoint != y->endpoint) return (x->endpoint < y->endpoint) ? -1 : 1;
+    if (x->milliseconds != y->milliseconds) return (x->milliseconds < y->milliseconds) ? -1 : 1;
+    return 0;
+}
+
+// Nearest rank
+static uint32_t BNCTimingPercentile(const BNCTimingRecord *sorted, size_t count, unsigned percent) {
+    size_t rank = (count * percent + 99) / 100;
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1].milliseconds;
+}
+
+static void BNCTimingSummarizeSorted(const BNCTimingRecord *records, size_t count, BNCTimingSummaryHandler handler, void *context) {
+    size_t start = 0;
+    while (start < count) {
+        size_t end = start;
+        uint64_t lastNumber = records[start].number;
+        uint32_t last = records[start].milliseconds;
+        while (end < count && records[end].endpoint == records[start].endpoint) {
+            if (records[end].number > lastNumber) {
+                lastNumber = records[end].number;
+                last = records[end].milliseconds;
+            }
+            end++;
+        }
+
+        size_t n = end - start;
+        BNCTimingSummary summary = {
+            .endpoint = records[start].endpoint,
+            .count = (uint32_t)n,
+            .min = records[start].milliseconds,
+            .max = records[end - 1].milliseconds,
+            .p50 = BNCTimingPercentile(records + start, n, 50),
+            .p90 = BNCTimingPercentile(records + start, n, 90),
+            .p99 = BNCTimingPercentile(records + start, n, 99),
+            .last = last
+        };
+        if (handler) handler(&summary, context);
+        start = end;
+    }
+}
+
+size_t BNCTimingRingSummarize(BNCTimingRing *ring, bool consume, BNCTimingSummaryHandler handler, void *context, uint64_t *dropped) {
+    if (dropped) *dropped = 0;
+    if (!ring) return 0;
+
+    size_t capacity = ring->mask + 1;
+    BNCTimingRecord *records = malloc(capacity * sizeof(BNCTimingRecord));
+    if (!records) return 0;
+
+    size_t count = 0;
+    uint64_t lost = 0;
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    for (;;) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t start = (head - tail > capacity) ? head - capacity : tail;
+        uint64_t end = start;
+
+        count = 0;
+        lost = start - tail;
+        for (; end < head; end++) {
+            BNCTimingReadResult result = BNCTimingRingRead(ring, end, &records[count]);
+            if (result == BNCTimingReadComplete) {
+                count++;
+            } else if (result == BNCTimingReadOverwritten) {
+                lost++;
+            } else if (consume) {
+                // a consumer stops at the first record in progress so it is not lost
+                break;
+            }
+        }
+
+        if (!consume) break;
+        // on failure another consumer moved the tail, summarize what is left after it
+        if (atomic_compare_exchange_strong_explicit(&ring->tail, &tail, end, memory_order_acq_rel, memory_order_acquire)) break;
+    }
+
+    qsort(records, count, sizeof(BNCTimingRecord), BNCTimingRecordCompare);
+    BNCTimingSummarizeSorted(records, count, handler, context);
+    free(records);
+
+    if (dropped) *dropped = lost;
+    return count;
+}
+
+size_t BNCTimingRingPendingCount(const BNCTimingRing *ring) {
+    if (!ring) return 0;
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t pending = (head > tail) ? head - tail : 0;
+    return (pending > ring->mask + 1) ? ring->mask + 1 : (size_t)pending;
+}
+
+void BNCTimingRingReset(BNCTimingRing *ring) {
+    if (!ring) return;
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    while (tail < head && !atomic_compare_exchange_weak_explicit(&ring->tail, &tail, head, memory_order_acq_rel, memory_order_relaxed)) {
+    }
+}
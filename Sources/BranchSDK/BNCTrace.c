@@ -0,0 +1,168 @@
+//
+//  BNCTrace.c
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#include "BNCTrace.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// MARK: - Buffer
+
+// A slot is ready once its event is completely written
+typedef struct {
+    BNCTraceEvent event;
+    atomic_bool ready;
+} BNCTraceSlot;
+
+atomic_bool BNCTraceEnabled = false;
+
+static BNCTraceSlot *bnc_trace_slots = NULL;
+static size_t bnc_trace_capacity = 0;
+static _Atomic size_t bnc_trace_next = 0;
+static _Atomic uint64_t bnc_trace_dropped = 0;
+static _Atomic uint64_t bnc_trace_identifier = 0;
+static pthread_mutex_t bnc_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+bool BNCTraceStart(size_t capacity) {
+    pthread_mutex_lock(&bnc_trace_lock);
+    if (!bnc_trace_slots) {
+        if (capacity < 1) capacity = BNCTraceDefaultCapacity;
+        bnc_trace_slots = calloc(capacity, sizeof(BNCTraceSlot));
+        if (!bnc_trace_slots) {
+            pthread_mutex_unlock(&bnc_trace_lock);
+            return false;
+        }
+        bnc_trace_capacity = capacity;
+    }
+
+    atomic_store_explicit(&BNCTraceEnabled, false, memory_order_relaxed);
+    for (size_t i = 0; i < bnc_trace_capacity; i++) {
+        atomic_store_explicit(&bnc_trace_slots[i].ready, false, memory_order_relaxed);
+    }
+    atomic_store_explicit(&bnc_trace_dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&bnc_trace_next, 0, memory_order_release);
+    atomic_store_explicit(&BNCTraceEnabled, true, memory_order_release);
+    pthread_mutex_unlock(&bnc_trace_lock);
+    return true;
+}
+
+void BNCTraceStop(void) {
+    atomic_store_explicit(&BNCTraceEnabled, false, memory_order_release);
+}
+
+static uint64_t BNCTraceThreadID(void) {
+    uint64_t thread = 0;
+#ifdef __APPLE__
+    pthread_threadid_np(NULL, &thread);
+#else
+    thread = (uint64_t)(uintptr_t)pthread_self();
+#endif
+    return thread;
+}
+
+static uint64_t BNCTraceTimestamp(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+void BNCTraceRecord(BNCTracePhase phase, const char *name, uint64_t identifier) {
+    if (!atomic_load_explicit(&BNCTraceEnabled, memory_order_acquire)) return;
+
+    size_t index = atomic_fetch_add_explicit(&bnc_trace_next, 1, memory_order_relaxed);
+    if (index >= bnc_trace_capacity) {
+        atomic_fetch_add_explicit(&bnc_trace_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    BNCTraceSlot *slot = &bnc_trace_slots[index];
+    strncpy(slot->event.name, (name) ? name : "", BNCTraceNameLength - 1);
+    slot->event.name[BNCTraceNameLength - 1] = '\0';
+    slot->event.phase = (char)phase;
+    slot->event.thread = BNCTraceThreadID();
+    slot->event.identifier = identifier;
+    slot->event.timestamp = BNCTraceTimestamp();
+    atomic_store_explicit(&slot->ready, true, memory_order_release);
+}
+
+uint64_t BNCTraceNextIdentifier(void) {
+    return atomic_fetch_add_explicit(&bnc_trace_identifier, 1, memory_order_relaxed) + 1;
+}
+
+size_t BNCTraceCopyEvents(BNCTraceEvent *events, size_t capacity, uint64_t *dropped) {
+    if (dropped) *dropped = atomic_load_explicit(&bnc_trace_dropped, memory_order_relaxed);
+
+    size_t recorded = atomic_load_explicit(&bnc_trace_next, memory_order_acquire);
+    if (recorded > bnc_trace_capacity) recorded = bnc_trace_capacity;
+
+    // events still being written are skipped
+    size_t count = 0;
+    for (size_t i = 0; i < recorded && count < capacity; i++) {
+        if (!atomic_load_explicit(&bnc_trace_slots[i].ready, memory_order_acquire)) continue;
+        events[count++] = bnc_trace_slots[i].event;
+    }
+    return count;
+}
+
+// MARK: - Export
+
+static void BNCTraceWriteString(FILE *file, const char *string) {
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char *)string; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if (*c < 0x20) {
+            fprintf(file, "\\u%04x", *c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+int BNCTraceWriteJSON(const char *path) {
+    size_t capacity = (bnc_trace_capacity) ? bnc_trace_capacity : 1;
+    BNCTraceEvent *events = malloc(capacity * sizeof(BNCTraceEvent));
+    if (!events) return ENOMEM;
+    uint64_t dropped = 0;
+    size_t count = BNCTraceCopyEvents(events, capacity, &dropped);
+
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        int error = errno;
+        free(events);
+        return error;
+    }
+
+    int pid = (int)getpid();
+    fputs("{\"traceEvents\":[", file);
+    for (size_t i = 0; i < count; i++) {
+        const BNCTraceEvent *event = &events[i];
+        fputs((i) ? ",\n{\"name\":" : "\n{\"name\":", file);
+        BNCTraceWriteString(file, event->name);
+        fprintf(file, ",\"cat\":\"branch\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":%d,\"tid\":%llu",
+            event->phase, (unsigned long long)event->timestamp, pid, (unsigned long long)event->thread);
+        if (event->phase == BNCTracePhaseAsyncBegin || event->phase == BNCTracePhaseAsyncEnd) {
+            fprintf(file, ",\"id\":\"0x%llx\"", (unsigned long long)event->identifier);
+        } else if (event->phase == BNCTracePhaseInstant) {
+            fputs(",\"s\":\"t\"", file);
+        }
+        fputc('}', file);
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%llu}}\n", (unsigned long long)dropped);
+    free(events);
+
+    int error = (ferror(file)) ? EIO : 0;
+    if (fclose(file) != 0 && !error) error = errno;
+    return error;
+}
@@ -12,6 +12,14 @@
 #import "Branch.h"
 #import "BranchLogger.h"
 #import "NSError+Branch.h"
+#import "BNCURLPatternMatcher.h"
+
+static NSString * const BNCURLFilterCacheFileName = @"BNCURLPatternCache";
+static NSString * const BNCURLFilterCacheVersionKey = @"version";
+static NSString * const BNCURLFilterCachePatternsKey = @"patterns";
+static NSString * const BNCURLFilterCacheMatcherKey = @"matcher";
+
+static NSString * const BNCURLFilterIdleNotification = @"BNCURLFilterIdleNotification";
 
 @interface BNCURLFilter ()
 
@@ -20,9 +28,21 @@
 // Is YES if the list has already been updated from the server, or is overridden with a custom list.
 @property (nonatomic, assign, readwrite) BOOL hasUpdatedPatternList;
 
-@property (strong, nonatomic) NSArray<NSRegularExpression*> *ignoredURLRegex;
 @property (assign, nonatomic) NSInteger listVersion;
 
+// Restored from the cache queue after the list changes, or built from the pattern list on first use
+@property (strong, nonatomic) BNCURLPatternMatcher *matcher;
+
+// Names the saved matcher for the current list, nil if it is not saved
+@property (copy, nonatomic) NSString *cacheKey;
+
+// Counts list changes, so a restore for an older list is dropped
+@property (assign, nonatomic) NSUInteger matcherGeneration;
+
+@property (strong, nonatomic) NSURL *cacheURL;
+
+@property (atomic, assign) BOOL idleUpdateScheduled;
+
 @end
 
 @implementation BNCURLFilter
@@ -31,6 +51,7 @@
     self = [super init];
     if (!self) return self;
 
+    self.cacheURL = [BNCURLForBranchDirectory() URLByAppendingPathComponent:BNCURLFilterCacheFileName isDirectory:NO];
     [self useDefaultPatternList];
     
     return self;
@@ -47,35 +68,114 @@
         @"^(?i)((http|https):\\/\\/).*[\\/|?|#].*\\b(password|o?auth|o?auth.?token|access|access.?token)\\b",
     ];
     self.listVersion = -1; // First time always refresh the list version, version 0.
-    self.ignoredURLRegex = [self compileRegexArray:self.patternList];
+    [self resetMatcherWithCacheKey:nil];
 }
 
-- (NSArray<NSRegularExpression *> *)compileRegexArray:(NSArray<NSString *> *)patternList {
-    NSMutableArray<NSRegularExpression *> *array = [NSMutableArray<NSRegularExpression *> new];
-    for (NSString *pattern in patternList) {
-        NSError *regexError = nil;
-        NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern options: NSRegularExpressionAnchorsMatchLines | NSRegularExpressionUseUnicodeWordBoundaries error:&regexError];
-        
-        if (regex && !regexError) {
-            [array addObject:regex];
-        } else {
-            [[BranchLogger shared] logError:[NSString stringWithFormat:@"Invalid regular expression '%@'", pattern] error:regexError];
+#pragma mark Matcher
+
+// Reads the saved analysis for the new list on the cache queue. A match before it is ready analyzes the list itself.
+- (void)resetMatcherWithCacheKey:(nullable NSString *)cacheKey {
+    NSURL *url = self.cacheURL;
+    NSArray<NSString *> *patternList = nil;
+    NSInteger version = 0;
+    NSUInteger generation = 0;
+    @synchronized (self) {
+        _matcher = nil;
+        _cacheKey = [cacheKey copy];
+        generation = ++_matcherGeneration;
+        patternList = self.patternList;
+        version = self.listVersion;
+    }
+    if (!cacheKey || !url) return;
+
+    dispatch_async([BNCURLFilter cacheQueue], ^{
+        BNCURLPatternMatcher *matcher = [BNCURLFilter savedMatcherFromURL:url cacheKey:cacheKey patternList:patternList version:version];
+        if (!matcher) return;
+        @synchronized (self) {
+            if (self.matcherGeneration == generation && !self->_matcher) {
+                self->_matcher = matcher;
+            }
         }
+    });
+}
+
+- (BNCURLPatternMatcher *)matcher {
+    @synchronized (self) {
+        if (!_matcher) {
+            _matcher = [[BNCURLPatternMatcher alloc] initWithPatterns:self.patternList];
+            if (_cacheKey && self.cacheURL) {
+                [BNCURLFilter saveMatcher:_matcher patternList:self.patternList version:self.listVersion cacheKey:_cacheKey toURL:self.cacheURL];
+            }
+        }
+        return _matcher;
+    }
+}
+
++ (dispatch_queue_t)cacheQueue {
+    static dispatch_queue_t queue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("io.branch.sdk.urlfilter", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+// Call on the cache queue
++ (NSDictionary *)readCacheFromURL:(NSURL *)url {
+    NSData *data = (url) ? [NSData dataWithContentsOfURL:url] : nil;
+    if (!data) return @{};
+
+    NSDictionary *cache = nil;
+    @try {
+        cache = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:NULL];
+    } @catch (NSException *exception) {
+        [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Exception reading URL pattern cache: %@.", exception] error:nil];
+    }
+    return ([cache isKindOfClass:NSDictionary.class]) ? cache : @{};
+}
+
+// Call on the cache queue. Restores the analyzed patterns saved for this list version, so launches after the first
+// skip the analysis and only compile the expressions they run.
++ (nullable BNCURLPatternMatcher *)savedMatcherFromURL:(NSURL *)url cacheKey:(NSString *)cacheKey patternList:(NSArray<NSString *> *)patternList version:(NSInteger)version {
+    NSDictionary *entry = [self readCacheFromURL:url][cacheKey];
+    if (![entry isKindOfClass:NSDictionary.class] ||
+        ![entry[BNCURLFilterCacheVersionKey] isEqual:@(version)] ||
+        ![entry[BNCURLFilterCachePatternsKey] isEqual:patternList]) {
+        return nil;
+    }
+
+    BNCURLPatternMatcher *matcher = [[BNCURLPatternMatcher alloc] initWithDictionary:entry[BNCURLFilterCacheMatcherKey]];
+    if (matcher) {
+        [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"Using saved URL patterns for list version %ld.", (long)version] error:nil];
     }
-    return array;
+    return matcher;
 }
 
++ (void)saveMatcher:(BNCURLPatternMatcher *)matcher patternList:(NSArray<NSString *> *)patternList version:(NSInteger)version cacheKey:(NSString *)cacheKey toURL:(NSURL *)url {
+    NSDictionary *newEntry = @{
+        BNCURLFilterCacheVersionKey: @(version),
+        BNCURLFilterCachePatternsKey: patternList,
+        BNCURLFilterCacheMatcherKey: [matcher dictionaryRepresentation]
+    };
+    dispatch_async([BNCURLFilter cacheQueue], ^{
+        NSMutableDictionary *cache = [[BNCURLFilter readCacheFromURL:url] mutableCopy];
+        cache[cacheKey] = newEntry;
+
+        NSError *error = nil;
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:cache format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+        if (!data || ![data writeToURL:url options:NSDataWritingAtomic error:&error]) {
+            [[BranchLogger shared] logWarning:@"Failed to save URL pattern cache" error:error];
+        }
+    });
+}
+
+#pragma mark Matching
+
 - (nullable NSString *)patternMatchingURL:(NSURL *)url {
     NSString *urlString = url.absoluteString;
     if (urlString == nil || urlString.length <= 0) return nil;
-    
-    NSRange range = NSMakeRange(0, urlString.length);
-    for (NSRegularExpression* regex in self.ignoredURLRegex) {
-        NSUInteger matches = [regex numberOfMatchesInString:urlString options:0 range:range];
-        if (matches > 0) return regex.pattern;
-    }
-    
-    return nil;
+
+    return [self.matcher patternMatchingString:urlString];
 }
 
 - (BOOL)shouldIgnoreURL:(NSURL *)url {
@@ -88,7 +188,7 @@
         self.patternList = storedList;
         self.listVersion = [BNCPreferenceHelper sharedInstance].savedURLPatternListVersion;
     }
-    self.ignoredURLRegex = [self compileRegexArray:self.patternList];
+    [self resetMatcherWithCacheKey:@"saved"];
 }
 
 - (void)useCustomPatternList:(NSArray<NSString *> *)patternList {
@@ -96,7 +196,7 @@
         self.patternList = patternList;
         self.listVersion = 0;
     }
-    self.ignoredURLRegex = [self compileRegexArray:self.patternList];
+    [self resetMatcherWithCacheKey:@"custom"];
 }
 
 #pragma mark Server update
@@ -109,6 +209,14 @@
     NSString *urlString = [NSString stringWithFormat:@"%@/sdk/uriskiplist_v%ld.json", [BNCPreferenceHelper sharedInstance].patternListURL, (long) self.listVersion+1];
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:urlString] cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:30.0];
 
+    // New lists are published under the next version number and existing versions don't change, so a missing version
+    // can't be validated, it is a small 404 each time. The saved tag is for a list at this URL that could not be used,
+    // the server answers 304 while it is unchanged instead of sending it again.
+    NSString *entityTag = [BNCPreferenceHelper sharedInstance].savedURLPatternListETag;
+    if (entityTag.length > 0) {
+        [request setValue:entityTag forHTTPHeaderField:@"If-None-Match"];
+    }
+
     __block id<BNCNetworkServiceProtocol> networkService = [[Branch networkServiceClass] new];
     id<BNCNetworkOperationProtocol> operation = [networkService networkOperationWithURLRequest:request completion: ^(id<BNCNetworkOperationProtocol> operation) {
         [self processServerOperation:operation];
@@ -119,6 +227,37 @@
     [operation start];
 }
 
+// Posted when the main run loop is idle, so the download stays out of session init
+- (void)updatePatternListFromServerWhenIdle {
+    @synchronized (self) {
+        if (self.hasUpdatedPatternList || self.idleUpdateScheduled) return;
+        self.idleUpdateScheduled = YES;
+    }
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        __block id observer = [center addObserverForName:BNCURLFilterIdleNotification object:self queue:nil usingBlock:^(NSNotification *note) {
+            [center removeObserver:observer];
+            [self updatePatternListFromServerWithCompletion:^{
+                self.idleUpdateScheduled = NO;
+            }];
+        }];
+
+        NSNotification *idle = [NSNotification notificationWithName:BNCURLFilterIdleNotification object:self];
+        [[NSNotificationQueue defaultQueue] enqueueNotification:idle postingStyle:NSPostWhenIdle];
+    });
+}
+
+- (nullable NSString *)entityTagFromResponse:(NSHTTPURLResponse *)response {
+    for (id key in response.allHeaderFields) {
+        if ([key isKindOfClass:NSString.class] && [key caseInsensitiveCompare:@"ETag"] == NSOrderedSame) {
+            id value = response.allHeaderFields[key];
+            return ([value isKindOfClass:NSString.class]) ? value : nil;
+        }
+    }
+    return nil;
+}
+
 - (BOOL)foundUpdatedURLList:(id<BNCNetworkOperationProtocol>)operation {
     NSInteger statusCode = operation.response.statusCode;
     NSError *error = operation.error;
@@ -130,6 +269,9 @@
     if (statusCode == 404) {
         [[BranchLogger shared] logDebug:@"No update for URL ignore list found." error:nil];
         return NO;
+    } else if (statusCode == 304) {
+        [[BranchLogger shared] logDebug:@"URL ignore list not modified." error:nil];
+        return NO;
     } else if (statusCode != 200 || error != nil || jsonString == nil) {   
         if ([NSError branchDNSBlockingError:error]) {
             NSError *dnsError = [NSError branchErrorWithCode:BNCDNSAdBlockerError];
@@ -175,17 +317,26 @@
 - (void)processServerOperation:(id<BNCNetworkOperationProtocol>)operation {
     if ([self foundUpdatedURLList:operation]) {
         NSDictionary *json = [self parseJSONFromData:operation.responseData];
-        if (json) {
+        if (!json) {
+            // skip downloading the same unusable list again
+            [BNCPreferenceHelper sharedInstance].savedURLPatternListETag = [self entityTagFromResponse:operation.response];
+        } else {
             NSNumber *version = json[@"version"];
             
-            self.hasUpdatedPatternList = YES;
-            self.patternList = json[@"uri_skip_list"];
-            self.listVersion = [version longValue];
-            self.ignoredURLRegex = [self compileRegexArray:self.patternList];
+            @synchronized (self) {
+                self.hasUpdatedPatternList = YES;
+                self.patternList = json[@"uri_skip_list"];
+                self.listVersion = [version longValue];
+                [self resetMatcherWithCacheKey:@"saved"];
+            }
 
+            // the next request is for the next version, the saved ETag does not apply to it
             [BNCPreferenceHelper sharedInstance].savedURLPatternList = self.patternList;
             [BNCPreferenceHelper sharedInstance].savedURLPatternListVersion = self.listVersion;
+            [BNCPreferenceHelper sharedInstance].savedURLPatternListETag = nil;
         }
+    } else if (operation.response.statusCode == 404) {
+        [BNCPreferenceHelper sharedInstance].savedURLPatternListETag = nil;
     }
 }
 
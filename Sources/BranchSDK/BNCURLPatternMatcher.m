@@ -0,0 +1,459 @@
+//
+//  BNCURLPatternMatcher.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCURLPatternMatcher.h"
+#import "BranchLogger.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+#pragma mark - BNCURLPatternRule
+
+static NSRegularExpressionOptions const BNCURLPatternOptions = NSRegularExpressionAnchorsMatchLines | NSRegularExpressionUseUnicodeWordBoundaries;
+
+// Bump when the analysis changes, saved representations from other formats are ignored
+static NSInteger const BNCURLPatternMatcherFormat = 1;
+
+static NSString * const BNCURLPatternFormatKey = @"format";
+static NSString * const BNCURLPatternRulesKey = @"rules";
+static NSString * const BNCURLPatternPatternKey = @"pattern";
+static NSString * const BNCURLPatternPrefixKey = @"prefix";
+static NSString * const BNCURLPatternSchemesKey = @"schemes";
+static NSString * const BNCURLPatternSchemesExcludedKey = @"schemes_excluded";
+static NSString * const BNCURLPatternCaseInsensitiveKey = @"case_insensitive";
+
+// A pattern with the conditions a string must meet before its expression can match
+@interface BNCURLPatternRule : NSObject
+@property (nonatomic, copy) NSString *pattern;
+@property (nonatomic, assign) NSUInteger index;
+@property (nonatomic, assign) BOOL caseInsensitive;
+
+// Compiled on first use when the rule is restored from a saved representation
+@property (atomic, strong) NSRegularExpression *compiledRegex;
+
+// Literal start of every match, lowercased when case insensitive
+@property (nonatomic, copy) NSString *prefix;
+@property (nonatomic, strong, readonly) NSData *prefixData;
+
+// Every match starts with, or with none of, these schemes followed by a colon
+@property (nonatomic, copy) NSSet<NSString *> *schemes;
+@property (nonatomic, assign) BOOL schemesExcluded;
+@end
+
+@implementation BNCURLPatternRule
+
+- (void)setPrefix:(NSString *)prefix {
+    _prefix = [prefix copy];
+    _prefixData = [_prefix dataUsingEncoding:NSASCIIStringEncoding];
+}
+
+// Two threads may both compile, either result is fine
+- (nullable NSRegularExpression *)regex {
+    NSRegularExpression *regex = self.compiledRegex;
+    if (!regex) {
+        NSError *regexError = nil;
+        regex = [NSRegularExpression regularExpressionWithPattern:self.pattern options:BNCURLPatternOptions error:&regexError];
+        if (!regex) {
+            [[BranchLogger shared] logError:[NSString stringWithFormat:@"Invalid regular expression '%@'", self.pattern] error:regexError];
+        }
+        self.compiledRegex = regex;
+    }
+    return regex;
+}
+
+// chars is the ASCII string, scheme is the text before its first colon or nil
+- (BOOL)acceptsChars:(const char *)chars scheme:(NSString *)scheme lowercaseScheme:(NSString *)lowercaseScheme {
+    if (self.prefixData.length) {
+        const char *prefix = self.prefixData.bytes;
+        size_t length = self.prefixData.length;
+        int result = (self.caseInsensitive) ? strncasecmp(chars, prefix, length) : strncmp(chars, prefix, length);
+        if (result != 0) return NO;
+    }
+    if (self.schemes) {
+        NSString *key = (self.caseInsensitive) ? lowercaseScheme : scheme;
+        BOOL listed = (key && [self.schemes containsObject:key]);
+        if (listed == self.schemesExcluded) return NO;
+    }
+    return YES;
+}
+
+- (NSDictionary *)dictionaryRepresentation {
+    NSMutableDictionary *dictionary = [NSMutableDictionary new];
+    dictionary[BNCURLPatternPatternKey] = self.pattern;
+    dictionary[BNCURLPatternPrefixKey] = self.prefix;
+    dictionary[BNCURLPatternSchemesKey] = self.schemes.allObjects;
+    if (self.schemesExcluded) dictionary[BNCURLPatternSchemesExcludedKey] = @YES;
+    if (self.caseInsensitive) dictionary[BNCURLPatternCaseInsensitiveKey] = @YES;
+    return dictionary;
+}
+
++ (nullable BNCURLPatternRule *)ruleWithDictionary:(NSDictionary *)dictionary {
+    if (![dictionary isKindOfClass:NSDictionary.class]) return nil;
+
+    NSString *pattern = dictionary[BNCURLPatternPatternKey];
+    NSString *prefix = dictionary[BNCURLPatternPrefixKey];
+    NSArray *schemes = dictionary[BNCURLPatternSchemesKey];
+    NSNumber *schemesExcluded = dictionary[BNCURLPatternSchemesExcludedKey];
+    NSNumber *caseInsensitive = dictionary[BNCURLPatternCaseInsensitiveKey];
+    if (![pattern isKindOfClass:NSString.class] ||
+        (prefix && (![prefix isKindOfClass:NSString.class] || ![prefix canBeConvertedToEncoding:NSASCIIStringEncoding])) ||
+        (schemes && ![schemes isKindOfClass:NSArray.class]) ||
+        (schemesExcluded && ![schemesExcluded isKindOfClass:NSNumber.class]) ||
+        (caseInsensitive && ![caseInsensitive isKindOfClass:NSNumber.class])) {
+        return nil;
+    }
+    for (NSString *scheme in schemes) {
+        if (![scheme isKindOfClass:NSString.class]) return nil;
+    }
+
+    BNCURLPatternRule *rule = [BNCURLPatternRule new];
+    rule.pattern = pattern;
+    rule.prefix = prefix;
+    rule.schemes = (schemes) ? [NSSet setWithArray:schemes] : nil;
+    rule.schemesExcluded = schemesExcluded.boolValue;
+    rule.caseInsensitive = caseInsensitive.boolValue;
+    return rule;
+}
+
+@end
+
+#pragma mark - Pattern analysis
+
+static BOOL BNCIsLiteralPunctuation(unichar c) {
+    return c < 128 && ispunct(c) && !strchr(".*+?()[]{}|^$\\", c);
+}
+
+static BOOL BNCIsSchemeCharacter(unichar c) {
+    return c < 128 && (isalnum(c) || c == '-');
+}
+
+// Rejects syntax the scanners below do not follow: quoting, comments, free spacing and nested or unusual classes.
+// Also rejects alternation at the top level, which would let a match start anywhere.
+static BOOL BNCPatternIsAnalyzable(NSString *pattern) {
+    if ([pattern containsString:@"\\Q"] || [pattern containsString:@"(?#"]) return NO;
+
+    NSInteger depth = 0;
+    BOOL inClass = NO;
+    NSUInteger length = pattern.length;
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar c = [pattern characterAtIndex:i];
+        if (c == '\\') {
+            i++;
+            continue;
+        }
+        if (inClass) {
+            if (c == '[') return NO;
+            if (c == ']') inClass = NO;
+            continue;
+        }
+        if (c == '[') {
+            inClass = YES;
+            if (i + 1 < length && [pattern characterAtIndex:i + 1] == ']') return NO;
+            if (i + 2 < length && [pattern characterAtIndex:i + 1] == '^' && [pattern characterAtIndex:i + 2] == ']') return NO;
+        } else if (c == '(') {
+            depth++;
+            // inline flags, free spacing changes what is literal
+            if (i + 1 < length && [pattern characterAtIndex:i + 1] == '?') {
+                for (NSUInteger j = i + 2; j < length; j++) {
+                    unichar flag = [pattern characterAtIndex:j];
+                    if (flag == 'x') return NO;
+                    if (!isalpha(flag) && flag != '-') break;
+                }
+            }
+        } else if (c == ')') {
+            depth--;
+        } else if (c == '|' && depth <= 0) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+// Reads `word|word|...)` at index, leaving index after the closing parenthesis
+static NSSet<NSString *> *BNCScanSchemeList(NSString *pattern, NSUInteger *index, BOOL lowercase) {
+    NSMutableSet<NSString *> *schemes = [NSMutableSet new];
+    NSMutableString *word = [NSMutableString new];
+    NSUInteger length = pattern.length;
+    for (NSUInteger i = *index; i < length; i++) {
+        unichar c = [pattern characterAtIndex:i];
+        if (BNCIsSchemeCharacter(c)) {
+            [word appendFormat:@"%C", (unichar)((lowercase) ? tolower(c) : c)];
+        } else if ((c == '|' || c == ')') && word.length) {
+            [schemes addObject:[word copy]];
+            [word setString:@""];
+            if (c == ')') {
+                *index = i + 1;
+                return schemes;
+            }
+        } else {
+            return nil;
+        }
+    }
+    return nil;
+}
+
+// Reads a colon, plain or escaped, at index
+static BOOL BNCScanColon(NSString *pattern, NSUInteger *index) {
+    NSUInteger i = *index;
+    if (i < pattern.length && [pattern characterAtIndex:i] == ':') {
+        *index = i + 1;
+        return YES;
+    }
+    if (i + 1 < pattern.length && [pattern characterAtIndex:i] == '\\' && [pattern characterAtIndex:i + 1] == ':') {
+        *index = i + 2;
+        return YES;
+    }
+    return NO;
+}
+
+// Given the index after an open parenthesis, returns YES if its group is required and has no alternation of its own
+static BOOL BNCGroupIsRequired(NSString *pattern, NSUInteger index) {
+    NSInteger depth = 1;
+    BOOL inClass = NO;
+    NSUInteger length = pattern.length;
+    for (NSUInteger i = index; i < length; i++) {
+        unichar c = [pattern characterAtIndex:i];
+        if (c == '\\') {
+            i++;
+        } else if (inClass) {
+            if (c == ']') inClass = NO;
+        } else if (c == '[') {
+            inClass = YES;
+        } else if (c == '(') {
+            depth++;
+        } else if (c == '|' && depth == 1) {
+            return NO;
+        } else if (c == ')' && --depth == 0) {
+            if (i + 1 >= length) return YES;
+            unichar next = [pattern characterAtIndex:i + 1];
+            return (next != '?' && next != '*' && next != '{');
+        }
+    }
+    return NO;
+}
+
+static void BNCAnalyzePattern(NSString *pattern, BNCURLPatternRule *rule) {
+    if (!BNCPatternIsAnalyzable(pattern)) return;
+
+    NSUInteger length = pattern.length;
+    NSUInteger i = 0;
+    BOOL anchored = NO;
+    while (i < length) {
+        if ([pattern characterAtIndex:i] == '^' && !anchored) {
+            anchored = YES;
+            i++;
+        } else if (i + 4 <= length && [[pattern substringWithRange:NSMakeRange(i, 4)] isEqualToString:@"(?i)"]) {
+            rule.caseInsensitive = YES;
+            i += 4;
+        } else {
+            break;
+        }
+    }
+    if (!anchored) return;
+
+    BOOL ci = rule.caseInsensitive;
+
+    // (?!(http|https):) excludes schemes and matches nothing, so the prefix continues after it
+    if ([pattern rangeOfString:@"(?!(" options:NSAnchoredSearch range:NSMakeRange(i, length - i)].location != NSNotFound) {
+        NSUInteger j = i + 4;
+        NSSet *schemes = BNCScanSchemeList(pattern, &j, ci);
+        if (schemes && BNCScanColon(pattern, &j) && j < length && [pattern characterAtIndex:j] == ')') {
+            rule.schemes = schemes;
+            rule.schemesExcluded = YES;
+            i = j + 1;
+        } else {
+            return;
+        }
+    }
+
+    // (http|https): or ((http|https):...) requires one of the schemes
+    if (i < length && [pattern characterAtIndex:i] == '(') {
+        BOOL outerGroup = (i + 1 < length && [pattern characterAtIndex:i + 1] == '(');
+        NSUInteger j = i + ((outerGroup) ? 2 : 1);
+        if (rule.schemes) return;
+        if (j < length && [pattern characterAtIndex:j] == '?') return;
+        NSSet *schemes = BNCScanSchemeList(pattern, &j, ci);
+        if (!schemes || !BNCScanColon(pattern, &j)) return;
+        if (outerGroup && !BNCGroupIsRequired(pattern, i + 1)) return;
+        rule.schemes = schemes;
+        return;
+    }
+
+    // literal prefix, a literal followed by an optional quantifier is not required
+    NSMutableString *prefix = [NSMutableString new];
+    while (i < length) {
+        unichar c = [pattern characterAtIndex:i];
+        unichar literal = 0;
+        NSUInteger next = i + 1;
+        if (c == '\\') {
+            if (i + 1 < length && BNCIsLiteralPunctuation([pattern characterAtIndex:i + 1])) {
+                literal = [pattern characterAtIndex:i + 1];
+                next = i + 2;
+            }
+        } else if (c < 128 && (isalnum(c) || BNCIsLiteralPunctuation(c)) && c != '#' && c != ' ') {
+            literal = c;
+        }
+        if (!literal) break;
+
+        unichar quantifier = (next < length) ? [pattern characterAtIndex:next] : 0;
+        if (quantifier == '*' || quantifier == '?' || quantifier == '{') break;
+        [prefix appendFormat:@"%C", (unichar)((ci) ? tolower(literal) : literal)];
+        if (quantifier == '+') break;
+        i = next;
+    }
+    if (prefix.length) {
+        rule.prefix = prefix;
+    }
+}
+
+#pragma mark - BNCURLPatternMatcher
+
+@interface BNCURLPatternMatcher ()
+@property (nonatomic, copy, readwrite) NSArray<NSString *> *patterns;
+@property (nonatomic, copy) NSArray<BNCURLPatternRule *> *rules;
+
+// Rules with a prefix, by its lowercased first character
+@property (nonatomic, copy) NSDictionary<NSNumber *, NSArray<BNCURLPatternRule *> *> *prefixedRules;
+
+// Rules without a prefix, checked for every string
+@property (nonatomic, copy) NSArray<BNCURLPatternRule *> *otherRules;
+@end
+
+@implementation BNCURLPatternMatcher
+
+- (instancetype)initWithPatterns:(NSArray<NSString *> *)patterns {
+    if ((self = [super init])) {
+        NSMutableArray<BNCURLPatternRule *> *rules = [NSMutableArray new];
+        for (NSString *pattern in patterns) {
+            if (![pattern isKindOfClass:NSString.class]) continue;
+            NSError *regexError = nil;
+            NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern options:BNCURLPatternOptions error:&regexError];
+            if (!regex || regexError) {
+                [[BranchLogger shared] logError:[NSString stringWithFormat:@"Invalid regular expression '%@'", pattern] error:regexError];
+                continue;
+            }
+
+            BNCURLPatternRule *rule = [BNCURLPatternRule new];
+            rule.pattern = pattern;
+            rule.compiledRegex = regex;
+            BNCAnalyzePattern(pattern, rule);
+            [rules addObject:rule];
+        }
+        [self indexRules:rules];
+    }
+    return self;
+}
+
+- (nullable instancetype)initWithDictionary:(NSDictionary *)dictionary {
+    if (![dictionary isKindOfClass:NSDictionary.class] ||
+        ![dictionary[BNCURLPatternFormatKey] isEqual:@(BNCURLPatternMatcherFormat)] ||
+        ![dictionary[BNCURLPatternRulesKey] isKindOfClass:NSArray.class]) {
+        return nil;
+    }
+
+    NSMutableArray<BNCURLPatternRule *> *rules = [NSMutableArray new];
+    for (NSDictionary *ruleDictionary in dictionary[BNCURLPatternRulesKey]) {
+        BNCURLPatternRule *rule = [BNCURLPatternRule ruleWithDictionary:ruleDictionary];
+        if (!rule) return nil;
+        [rules addObject:rule];
+    }
+
+    if ((self = [super init])) {
+        [self indexRules:rules];
+    }
+    return self;
+}
+
+- (void)indexRules:(NSArray<BNCURLPatternRule *> *)rules {
+    NSMutableArray<NSString *> *patterns = [NSMutableArray new];
+    NSMutableDictionary<NSNumber *, NSMutableArray<BNCURLPatternRule *> *> *prefixedRules = [NSMutableDictionary new];
+    NSMutableArray<BNCURLPatternRule *> *otherRules = [NSMutableArray new];
+
+    for (BNCURLPatternRule *rule in rules) {
+        rule.index = patterns.count;
+        [patterns addObject:rule.pattern];
+
+        if (rule.prefix.length) {
+            NSNumber *key = @(tolower([rule.prefix characterAtIndex:0]));
+            if (!prefixedRules[key]) prefixedRules[key] = [NSMutableArray new];
+            [prefixedRules[key] addObject:rule];
+        } else {
+            [otherRules addObject:rule];
+        }
+    }
+
+    _patterns = [patterns copy];
+    _rules = [rules copy];
+    _prefixedRules = [prefixedRules copy];
+    _otherRules = [otherRules copy];
+}
+
+- (NSDictionary *)dictionaryRepresentation {
+    NSMutableArray *rules = [NSMutableArray new];
+    for (BNCURLPatternRule *rule in self.rules) {
+        [rules addObject:[rule dictionaryRepresentation]];
+    }
+    return @{
+        BNCURLPatternFormatKey: @(BNCURLPatternMatcherFormat),
+        BNCURLPatternRulesKey: rules
+    };
+}
+
+- (NSArray<BNCURLPatternRule *> *)candidatesForString:(NSString *)string {
+    // The conditions assume a single line of ASCII, where ^ only matches at the start and case folding is simple
+    const char *chars = [string cStringUsingEncoding:NSASCIIStringEncoding];
+    if (!chars || strlen(chars) != string.length || strpbrk(chars, "\n\r\v\f")) {
+        return self.rules;
+    }
+
+    NSString *scheme = nil;
+    NSString *lowercaseScheme = nil;
+    const char *colon = strchr(chars, ':');
+    if (colon) {
+        scheme = [string substringToIndex:(NSUInteger)(colon - chars)];
+        lowercaseScheme = scheme.lowercaseString;
+    }
+
+    // both lists are in pattern order, merge them
+    NSArray<BNCURLPatternRule *> *prefixed = self.prefixedRules[@(tolower(chars[0]))];
+    NSArray<BNCURLPatternRule *> *others = self.otherRules;
+    NSMutableArray<BNCURLPatternRule *> *candidates = [NSMutableArray new];
+    NSUInteger p = 0, o = 0;
+    while (p < prefixed.count || o < others.count) {
+        BNCURLPatternRule *rule = nil;
+        if (o >= others.count || (p < prefixed.count && prefixed[p].index < others[o].index)) {
+            rule = prefixed[p++];
+        } else {
+            rule = others[o++];
+        }
+        if ([rule acceptsChars:chars scheme:scheme lowercaseScheme:lowercaseScheme]) {
+            [candidates addObject:rule];
+        }
+    }
+    return candidates;
+}
+
+- (nullable NSString *)patternMatchingString:(NSString *)string {
+    if (string.length == 0) return nil;
+
+    NSRange range = NSMakeRange(0, string.length);
+    for (BNCURLPatternRule *rule in [self candidatesForString:string]) {
+        NSRegularExpression *regex = rule.regex;
+        if (regex && [regex rangeOfFirstMatchInString:string options:0 range:range].location != NSNotFound) {
+            return rule.pattern;
+        }
+    }
+    return nil;
+}
+
+- (NSUInteger)candidateCountForString:(NSString *)string {
+    if (string.length == 0) return 0;
+    return [self candidatesForString:string].count;
+}
+
+@end
@@ -10,18 +10,29 @@
 #import "BNCUserAgentCollector.h"
 #import "BNCPreferenceHelper.h"
 #import "BNCDeviceSystem.h"
+#import "BranchLogger.h"
 #if __has_feature(modules)
 @import WebKit;
+@import UIKit;
 #else
 #import <WebKit/WebKit.h>
+#import <UIKit/UIKit.h>
 #endif
 
+// WebKit occasionally fails to evaluate the user agent, mostly on simulator
+static NSInteger const BNCUserAgentCollectionRetries = 3;
+
+static NSString * const BNCUserAgentIdleNotification = @"BNCUserAgentIdleNotification";
+
 @interface BNCUserAgentCollector()
 // need to hold onto the webview until the async user agent fetch is done
 @property (nonatomic, strong, readwrite) WKWebView *webview;
 
 // use system build as an indicator that the OS has been updated
 @property (nonatomic, copy, readwrite) NSString *systemBuildVersion;
+
+// a deferred collection is waiting for the main thread to be idle or running
+@property (atomic, assign, readwrite) BOOL idleCollectionScheduled;
 @end
 
 @implementation BNCUserAgentCollector
@@ -50,6 +61,13 @@
         if (completion) {
             completion(savedUserAgent);
         }
+    } else if (self.deferCollection) {
+        NSString *userAgent = [[BNCPreferenceHelper sharedInstance].browserUserAgentString copy] ?: [self synthesizedUserAgent];
+        self.userAgent = userAgent;
+        [self collectUserAgentWhenIdle];
+        if (completion) {
+            completion(userAgent);
+        }
     } else {
         [self collectUserAgentWithCompletion:^(NSString * _Nullable userAgent) {
             self.userAgent = userAgent;
@@ -61,6 +79,42 @@
     }
 }
 
+// Same format as WKWebView, e.g. "Mozilla/5.0 (iPhone; CPU iPhone OS 17_4 like Mac OS X) AppleWebKit/605.1.15 (KHTML, like Gecko) Mobile/15E148".
+// WebKit has reported these fixed WebKit and Mobile versions since iOS 11.
+- (NSString *)synthesizedUserAgent {
+    UIDevice *device = [UIDevice currentDevice];
+    NSString *version = [device.systemVersion stringByReplacingOccurrencesOfString:@"." withString:@"_"];
+    NSString *platform = ([device.model hasPrefix:@"iPad"]) ?
+        [NSString stringWithFormat:@"iPad; CPU OS %@", version] :
+        [NSString stringWithFormat:@"%@; CPU iPhone OS %@", device.model, version];
+    return [NSString stringWithFormat:@"Mozilla/5.0 (%@ like Mac OS X) AppleWebKit/605.1.15 (KHTML, like Gecko) Mobile/15E148", platform];
+}
+
+// Collects the real user agent once the main run loop has nothing else to do, so the web view does not compete with app launch.
+- (void)collectUserAgentWhenIdle {
+    @synchronized (self) {
+        if (self.idleCollectionScheduled) return;
+        self.idleCollectionScheduled = YES;
+    }
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        __block id observer = [center addObserverForName:BNCUserAgentIdleNotification object:self queue:nil usingBlock:^(NSNotification *note) {
+            [center removeObserver:observer];
+            [self collectUserAgentWithCompletion:^(NSString * _Nullable userAgent) {
+                if (userAgent) {
+                    self.userAgent = userAgent;
+                    [self saveUserAgent:userAgent forSystemBuildVersion:self.systemBuildVersion];
+                }
+                self.idleCollectionScheduled = NO;
+            }];
+        }];
+
+        NSNotification *idle = [NSNotification notificationWithName:BNCUserAgentIdleNotification object:self];
+        [[NSNotificationQueue defaultQueue] enqueueNotification:idle postingStyle:NSPostWhenIdle];
+    });
+}
+
 // load user agent from preferences
 - (NSString *)loadUserAgentForSystemBuildVersion:(NSString *)systemBuildVersion {
     
@@ -87,6 +141,10 @@
 
 // collect user agent from webkit.  this is expensive.
 - (void)collectUserAgentWithCompletion:(void (^)(NSString *userAgent))completion {
+    [self collectUserAgentWithRetries:BNCUserAgentCollectionRetries completion:completion];
+}
+
+- (void)collectUserAgentWithRetries:(NSInteger)retries completion:(void (^)(NSString *userAgent))completion {
     dispatch_async(dispatch_get_main_queue(), ^{
         if (!self.webview) {
             self.webview = [[WKWebView alloc] initWithFrame:CGRectZero];
@@ -99,9 +157,13 @@
                     self.webview = nil;
                     
                     completion(response);
-                } else {
+                } else if (retries > 0) {
                     // retry if we failed to obtain user agent.  This occasionally occurs on simulator.
-                    [self collectUserAgentWithCompletion:completion];
+                    [self collectUserAgentWithRetries:retries - 1 completion:completion];
+                } else {
+                    self.webview = nil;
+                    [[BranchLogger shared] logWarning:@"Failed to collect user agent." error:error];
+                    completion(nil);
                 }
             }
         }];
@@ -23,6 +23,10 @@
 #import "BranchJsonConfig.h"
 #import "BranchOpenRequest.h"
 #import "BranchShortUrlRequest.h"
+#import "BranchShortUrlBatchRequest.h"
+#import "BNCRequestCoalescer.h"
+#import "BNCStartupPipeline.h"
+#import "BNCTrace.h"
 #import "BranchShortUrlSyncRequest.h"
 #import "BranchSpotlightUrlRequest.h"
 #import "BranchUniversalObject.h"
@@ -31,6 +35,7 @@
 #import "Branch+Validator.h"
 #import "BNCApplication.h"
 #import "BNCURLFilter.h"
+#import "BNCQRCodeCache.h"
 #import "BNCDeviceInfo.h"
 #import "BNCCallbackMap.h"
 #import "BNCSKAdNetwork.h"
@@ -47,12 +52,15 @@
 #import "BranchLogger.h"
 #import "BranchConfigurationController.h"
 
+#include <stdatomic.h>
+
 #if !TARGET_OS_TV
 #import "BNCUserAgentCollector.h"
 #import "BNCSpotlightService.h"
 #import "BNCContentDiscoveryManager.h"
 #import "BranchContentDiscoverer.h"
 #import "BNCODMInfoCollector.h"
+#import "BNCThirdPartySignals.h"
 #endif
 
 NSString * const BRANCH_FEATURE_TAG_SHARE = @"share";
@@ -92,7 +100,24 @@ BranchAttributionLevel const BranchAttributionLevelReduced = @"REDUCED";
 BranchAttributionLevel const BranchAttributionLevelMinimal = @"MINIMAL";
 BranchAttributionLevel const BranchAttributionLevelNone = @"NONE";
 
-static BOOL bnc_disableAutomaticOpenTracking = NO;
+// Configuration checked on every request. Writers still serialize on the class, readers load without waiting.
+static struct {
+    atomic_bool useTestBranchKey;
+    atomic_bool automaticOpenTrackingDisabled;
+    _Atomic(void *) branchKey;  // retained NSString
+} bnc_config;
+
+// Startup stages, see startStartupPipeline
+static NSString * const BNCStartupStagePreferences = @"preferences";
+static NSString * const BNCStartupStageApplicationData = @"application_data";
+static NSString * const BNCStartupStageUserAgent = @"user_agent";
+static NSString * const BNCStartupStageThirdPartySignals = @"third_party_signals";
+
+// Coalescer key for link requests, stable across launches. Link data that is not valid JSON is never shared.
+static NSString *BNCRequestKeyForLinkData(BNCLinkData *linkData) {
+    return linkData.digest ?: [NSUUID UUID].UUIDString;
+}
+
 static dispatch_source_t bnc_disableAutomaticOpenTimer = nil;
 static NSTimeInterval const BNC_DEFAULT_DISABLE_FOREGROUND_TIMEOUT = 30.0;
 
@@ -149,6 +174,17 @@ typedef NS_ENUM(NSInteger, BNCInitStatus) {
 @property (assign, nonatomic) BNCInitStatus initializationStatus;
 @property (assign, nonatomic) BOOL shouldAutomaticallyDeepLink;
 @property (strong, nonatomic) BNCLinkCache *linkCache;
+// Loads the data requests are built from, independent stages run concurrently
+@property (strong, nonatomic) BNCStartupPipeline *startupPipeline;
+// async span from init to the first init callback, when cold start tracing is enabled
+@property (assign, nonatomic) uint64_t coldStartTraceID;
+// Resumes within this long of the last open are served from the cached session, 0 disables
+@property (assign, nonatomic) NSTimeInterval warmResumeInterval;
+@property (strong, atomic) NSDate *lastOpenDate;
+// In flight link requests by link data, so identical requests share one server call
+@property (strong, nonatomic) BNCRequestCoalescer *shortUrlRequests;
+@property (strong, nonatomic) BNCRequestCoalescer *shortUrlSyncRequests;
+@property (strong, nonatomic) BNCRequestCoalescer *spotlightUrlRequests;
 @property (strong, nonatomic) BNCPreferenceHelper *preferenceHelper;
 @property (strong, nonatomic) NSMutableDictionary *deepLinkControllers;
 @property (weak,   nonatomic) UIViewController *deepLinkPresentingController;
@@ -204,6 +240,11 @@ typedef NS_ENUM(NSInteger, BNCInitStatus) {
     self = [super init];
     if (!self) return self;
 
+    if (BNCTraceIsEnabled()) {
+        _coldStartTraceID = BNCTraceNextIdentifier();
+        BNC_TRACE_ASYNC_BEGIN("cold_start", _coldStartTraceID);
+    }
+
     // Initialize instance variables
     self.isolationQueue = dispatch_queue_create([@"branchIsolationQueue" UTF8String], DISPATCH_QUEUE_SERIAL);
 
@@ -211,6 +252,9 @@ typedef NS_ENUM(NSInteger, BNCInitStatus) {
     _serverInterface.preferenceHelper = preferenceHelper;
     _requestQueue = queue;
     _linkCache = cache;
+    _shortUrlRequests = [BNCRequestCoalescer new];
+    _shortUrlSyncRequests = [BNCRequestCoalescer new];
+    _spotlightUrlRequests = [BNCRequestCoalescer new];
     _preferenceHelper = preferenceHelper;
     _initializationStatus = BNCInitStatusUninitialized;
     _processing_sema = dispatch_semaphore_create(1);
@@ -244,9 +288,14 @@ typedef NS_ENUM(NSInteger, BNCInitStatus) {
         name:UIApplicationDidBecomeActiveNotification
         object:nil];
 
-    // queue up async data loading
-    [self loadApplicationData];
-    [self loadUserAgent];
+    [notificationCenter
+        addObserver:self
+        selector:@selector(requestQueueDidClear)
+        name:BNCServerRequestQueueDidClearNotification
+        object:nil];
+
+    // start async data loading
+    [self startStartupPipeline];
     
     BranchJsonConfig *config = BranchJsonConfig.instance;
     self.deferInitForPluginRuntime = config.deferInitForPluginRuntime;
@@ -343,27 +392,32 @@ static callbackForTracingRequests bnc_tracingCallback = nil;
 
 #pragma mark - Configuration methods
 
-static BOOL bnc_useTestBranchKey = NO;
-static NSString *bnc_branchKey = nil;
+static NSString *BNCConfigBranchKey(void) {
+    return (__bridge NSString *)atomic_load_explicit(&bnc_config.branchKey, memory_order_acquire);
+}
+
+// A published key is never released so a reader can't load a freed string. It is set once per process outside of tests.
+static void BNCConfigSetBranchKey(NSString *branchKey) {
+    void *retained = (branchKey) ? (void *)CFBridgingRetain([branchKey copy]) : NULL;
+    atomic_store_explicit(&bnc_config.branchKey, retained, memory_order_release);
+}
 
 + (void)resetBranchKey {
-    bnc_branchKey = nil;
+    BNCConfigSetBranchKey(nil);
 }
 
 + (void)setUseTestBranchKey:(BOOL)useTestKey {
     @synchronized (self) {
-        if (bnc_branchKey && !!useTestKey != !!bnc_useTestBranchKey) {
+        if (BNCConfigBranchKey() && !!useTestKey != !!self.useTestBranchKey) {
             [[BranchLogger shared] logError:@"Can't switch the Branch key once it's in use." error:nil];
             return;
         }
-        bnc_useTestBranchKey = useTestKey;
+        atomic_store(&bnc_config.useTestBranchKey, useTestKey);
     }
 }
 
 + (BOOL)useTestBranchKey {
-    @synchronized (self) {
-        return bnc_useTestBranchKey;
-    }
+    return atomic_load(&bnc_config.useTestBranchKey);
 }
 
 + (void)setBranchKey:(NSString *)branchKey {
@@ -377,10 +431,11 @@ static NSString *bnc_branchKey = nil;
 
 + (void)setBranchKey:(NSString*)branchKey error:(NSError **)error {
     @synchronized (self) {
-        if (bnc_branchKey) {
+        NSString *currentKey = BNCConfigBranchKey();
+        if (currentKey) {
             if (branchKey &&
                 [branchKey isKindOfClass:[NSString class]] &&
-                [branchKey isEqualToString:bnc_branchKey]) {
+                [branchKey isEqualToString:currentKey]) {
                 return;
             }
 
@@ -401,11 +456,11 @@ static NSString *bnc_branchKey = nil;
         }
 
         if ([branchKey hasPrefix:@"key_test"]) {
-            bnc_useTestBranchKey = YES;
+            atomic_store(&bnc_config.useTestBranchKey, YES);
             [[BranchLogger shared] logWarning: @"You are using your test app's Branch Key. Remember to change it to live Branch Key for production deployment." error:nil];
 
         } else if ([branchKey hasPrefix:@"key_live"]) {
-            bnc_useTestBranchKey = NO;
+            atomic_store(&bnc_config.useTestBranchKey, NO);
 
         } else {
             NSString *errorMessage = [NSString stringWithFormat:@"Invalid Branch key format. Did you add your Branch key to your Info.plist? Passed key is '%@'.", branchKey];
@@ -414,19 +469,23 @@ static NSString *bnc_branchKey = nil;
             return;
         }
         [BranchConfigurationController sharedInstance].branchKeySource = BRANCH_KEY_SOURCE_SET_BRANCH_KEY_API;
-        bnc_branchKey = branchKey;
+        BNCConfigSetBranchKey(branchKey);
     }
 }
 
 + (NSString *)branchKey {
+    NSString *currentKey = BNCConfigBranchKey();
+    if (currentKey) return currentKey;
+
     @synchronized (self) {
-        if (bnc_branchKey) return bnc_branchKey;
+        currentKey = BNCConfigBranchKey();
+        if (currentKey) return currentKey;
         
         NSString *branchKey = nil;
         NSString *branchKeySource = @"Unknown";
         
         BranchJsonConfig *config = BranchJsonConfig.instance;
-        BOOL usingTestInstance = bnc_useTestBranchKey || config.useTestInstance;
+        BOOL usingTestInstance = self.useTestBranchKey || config.useTestInstance;
         branchKey = config.branchKey ?: usingTestInstance ? config.testKey : config.liveKey;
         [self setUseTestBranchKey:usingTestInstance];
         
@@ -446,18 +505,17 @@ static NSString *bnc_branchKey = nil;
         }
 
         self.branchKey = branchKey;
-        if (!bnc_branchKey) {
+        currentKey = BNCConfigBranchKey();
+        if (!currentKey) {
             [[BranchLogger shared] logError:@"Your Branch key is not set in your Info.plist file. See https://dev.branch.io/getting-started/sdk-integration-guide/guide/ios/#configure-xcode-project for configuration instructions." error:nil];
         }
         [BranchConfigurationController sharedInstance].branchKeySource = branchKeySource;
-        return bnc_branchKey;
+        return currentKey;
     }
 }
 
 + (BOOL)branchKeyIsSet {
-    @synchronized (self) {
-        return (bnc_branchKey.length) ? YES : NO;
-    }
+    return (BNCConfigBranchKey().length) ? YES : NO;
 }
 
 - (void)enableLogging {
@@ -542,6 +600,10 @@ static NSString *bnc_branchKey = nil;
     self.preferenceHelper.retryInterval = retryInterval;
 }
 
+- (void)setWarmResumeInterval:(NSTimeInterval)interval {
+    _warmResumeInterval = MAX(interval, 0);
+}
+
 + (void)setSDKWaitTimeForThirdPartyAPIs:(NSTimeInterval)waitTime {
     @synchronized(self) {
         if (waitTime <= 0) {
@@ -556,15 +618,42 @@ static NSString *bnc_branchKey = nil;
     }
 }
 
++ (void)enableColdStartTracing {
+    if (!BNCTraceStart(BNCTraceDefaultCapacity)) {
+        [[BranchLogger shared] logWarning:@"Failed to start cold start tracing." error:nil];
+    }
+}
+
+// Ends the cold start span and writes the trace, once
+- (void)finishColdStartTrace {
+    if (!BNCTraceIsEnabled() || !self.coldStartTraceID) return;
+    BNC_TRACE_ASYNC_END("cold_start", self.coldStartTraceID);
+    BNCTraceStop();
+
+    NSURL *url = [BNCURLForBranchDirectory() URLByAppendingPathComponent:@"BranchColdStartTrace.json"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        int error = BNCTraceWriteJSON(url.fileSystemRepresentation);
+        if (error) {
+            [[BranchLogger shared] logWarning:@"Failed to write cold start trace." error:[NSError errorWithDomain:NSPOSIXErrorDomain code:error userInfo:nil]];
+        } else {
+            [[BranchLogger shared] logDebug:[NSString stringWithFormat:@"Wrote cold start trace to %@", url.path] error:nil];
+        }
+    });
+}
+
++ (void)setUserAgentCollectionDeferred:(BOOL)deferred {
+    #if !TARGET_OS_TV
+    [BNCUserAgentCollector instance].deferCollection = deferred;
+    #endif
+}
+
 - (void)setRequestMetadataKey:(NSString *)key value:(NSString *)value {
     [self.preferenceHelper setRequestMetadataKey:key value:value];
 }
 
 
 + (BOOL)trackingDisabled {
-    @synchronized(self) {
-        return [BNCPreferenceHelper sharedInstance].trackingDisabled;
-    }
+    return [BNCPreferenceHelper sharedInstance].trackingDisabled;
 }
 
 + (void)setTrackingDisabled:(BOOL)disabled {
@@ -585,6 +674,7 @@ static NSString *bnc_branchKey = nil;
             [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"initializationStatus %ld", branch.initializationStatus] error:nil];
 
             [branch.linkCache clear];
+            [[BNCQRCodeCache sharedInstance] clear];
             // Release the lock in case it's locked:
             [BranchOpenRequest releaseOpenResponseLock];
         } else {
@@ -609,7 +699,7 @@ static NSString *bnc_branchKey = nil;
             bnc_disableAutomaticOpenTimer = nil;
         }
 
-        bnc_disableAutomaticOpenTracking = YES;
+        atomic_store(&bnc_config.automaticOpenTrackingDisabled, YES);
 
         if (timeout > 0) {
             bnc_disableAutomaticOpenTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
@@ -645,14 +735,12 @@ static NSString *bnc_branchKey = nil;
             bnc_disableAutomaticOpenTimer = nil;
         }
 
-        bnc_disableAutomaticOpenTracking = NO;
+        atomic_store(&bnc_config.automaticOpenTrackingDisabled, NO);
     }
 }
 
 + (BOOL)automaticOpenTrackingDisabled {
-    @synchronized (self) {
-        return bnc_disableAutomaticOpenTracking;
-    }
+    return atomic_load(&bnc_config.automaticOpenTrackingDisabled);
 }
 
 + (void)setReferrerGbraidValidityWindow:(NSTimeInterval)validityWindow{
@@ -709,6 +797,7 @@ static NSString *bnc_branchKey = nil;
             [branch clearNetworkQueue];
             branch.initializationStatus = BNCInitStatusUninitialized;
             [branch.linkCache clear];
+            [[BNCQRCodeCache sharedInstance] clear];
             // Release the lock in case it's locked:
             [BranchOpenRequest releaseOpenResponseLock];
         }
@@ -820,6 +909,7 @@ static NSString *bnc_branchKey = nil;
        explicitlyRequestedReferrable:(BOOL)explicitlyRequestedReferrable
       automaticallyDisplayController:(BOOL)automaticallyDisplayController {
 
+    BNC_TRACE_INSTANT("init_session");
     [self.class addBranchSDKVersionToCrashlyticsReport];
     self.shouldAutomaticallyDeepLink = automaticallyDisplayController;
 
@@ -1060,26 +1150,47 @@ static NSString *bnc_branchKey = nil;
 
 #pragma mark - async data collection
 
-- (void)loadUserAgent {
-    #if !TARGET_OS_TV
-    dispatch_async(self.isolationQueue, ^(){
-        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+// The stages run concurrently and nothing waits on the isolation queue for them.
+// Requests wait for requestBuildStages just before they are built, see processNextQueueItem.
+- (void)startStartupPipeline {
+    self.startupPipeline = [BNCStartupPipeline new];
+    BNCPreferenceHelper *preferenceHelper = self.preferenceHelper;
+
+    // the helper started loading in sharedInstance, reading a value waits for it
+    [self.startupPipeline addStage:BNCStartupStagePreferences dependencies:nil work:^(dispatch_block_t complete) {
+        [preferenceHelper randomizedBundleToken];
+        complete();
+    }];
+
+    [self.startupPipeline addStage:BNCStartupStageApplicationData dependencies:nil work:^(dispatch_block_t complete) {
+        [BNCApplication currentApplication];
+        complete();
+    }];
+
+    // the cached user agent is in the preferences
+    [self.startupPipeline addStage:BNCStartupStageUserAgent dependencies:@[ BNCStartupStagePreferences ] work:^(dispatch_block_t complete) {
+        #if !TARGET_OS_TV
         [[BNCUserAgentCollector instance] loadUserAgentWithCompletion:^(NSString * _Nullable userAgent) {
-            dispatch_semaphore_signal(semaphore);
+            complete();
         }];
-        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
-    });
+        #else
+        complete();
+        #endif
+    }];
+
+    #if !TARGET_OS_TV
+    // speculative, requests take what is ready by the deadline instead of waiting for the stage
+    [self.startupPipeline addStage:BNCStartupStageThirdPartySignals dependencies:@[ BNCStartupStagePreferences ] work:^(dispatch_block_t complete) {
+        [[BNCThirdPartySignals shared] gatherSignalsWithCompletion:complete];
+    }];
     #endif
+
+    [self.startupPipeline start];
 }
 
-- (void)loadApplicationData {
-    dispatch_async(self.isolationQueue, ^(){
-        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-        [BNCApplication loadCurrentApplicationWithCompletion:^(BNCApplication *application) {
-            dispatch_semaphore_signal(semaphore);
-        }];
-        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
-    });
+// Stages whose data goes into request bodies
+- (NSArray<NSString *> *)requestBuildStages {
+    return @[ BNCStartupStagePreferences, BNCStartupStageApplicationData, BNCStartupStageUserAgent ];
 }
 
 
@@ -1104,6 +1215,8 @@ static NSString *bnc_branchKey = nil;
 }
 
 - (void)handleATTAuthorizationStatus:(NSUInteger)status {
+    [[BNCDeviceInfo getInstance] invalidateSnapshot];
+
     // limits impact if the client fails to check that status = notDetermined before calling
     if ([BNCPreferenceHelper sharedInstance].hasCalledHandleATTAuthorizationStatus) {
         return;
@@ -1209,7 +1322,8 @@ static NSString *bnc_branchKey = nil;
     }
 
     // Clear cached links
-    self.linkCache = [[BNCLinkCache alloc] init];
+    [self.linkCache clear];
+    [[BNCQRCodeCache sharedInstance] clear];
     
     // Removed stored values
     self.preferenceHelper.userIdentity = nil;
@@ -1273,12 +1387,69 @@ static NSString *bnc_branchKey = nil;
 }
 
 - (NSDictionary *)getLatestReferringParamsSynchronous {
-    [BranchOpenRequest waitForOpenResponseLock];
-    NSDictionary *result = [self getLatestReferringParams];
-    [BranchOpenRequest releaseOpenResponseLock];
+    return [self getLatestReferringParamsSynchronousWithTimeout:0];
+}
+
+- (NSDictionary *)getLatestReferringParamsSynchronousWithTimeout:(NSTimeInterval)timeout {
+    __block NSDictionary *result = nil;
+    __block NSError *resultError = nil;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+
+    // resolved off the main queue, callers are often on it
+    [self getLatestReferringParamsWithTimeout:timeout queue:dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0) completion:^(NSDictionary *params, NSError *error) {
+        result = params;
+        resultError = error;
+        dispatch_semaphore_signal(semaphore);
+    }];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+
+    // nil params without an error just means there are none
+    if (resultError.code == BNCOpenResponseTimeoutError) {
+        [[BranchLogger shared] logWarning:@"Timed out waiting for the open response, returning the previous referring params." error:nil];
+        result = [self getLatestReferringParams];
+    }
     return result;
 }
 
+- (void)getLatestReferringParamsWithTimeout:(NSTimeInterval)timeout completion:(void (^)(NSDictionary *params, NSError *error))completion {
+    [self getLatestReferringParamsWithTimeout:timeout queue:dispatch_get_main_queue() completion:completion];
+}
+
+// Resolves once, with the params when the open response lock is released or with an error at the deadline.
+// The block queued on the lock stays there until the next open response, even after a timeout. It only holds
+// self weakly and the completion is dropped when the call resolves, so a timed-out call leaves only a small block behind.
+- (void)getLatestReferringParamsWithTimeout:(NSTimeInterval)timeout queue:(dispatch_queue_t)queue completion:(void (^)(NSDictionary *params, NSError *error))completion {
+    if (!completion) return;
+
+    __block callbackWithParams pending = [completion copy];
+    NSObject *lock = [NSObject new];
+    callbackWithParams resolve = ^(NSDictionary *params, NSError *error) {
+        callbackWithParams callback = nil;
+        @synchronized (lock) {
+            callback = pending;
+            pending = nil;
+        }
+        if (callback) callback(params, error);
+    };
+
+    __weak Branch *weakSelf = self;
+    [BranchOpenRequest notifyWhenOpenResponseLockReleased:^{
+        @synchronized (lock) {
+            if (!pending) return;
+        }
+        NSDictionary *params = [weakSelf getLatestReferringParams];
+        dispatch_async(queue, ^{
+            resolve(params, nil);
+        });
+    }];
+
+    if (timeout > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), queue, ^{
+            resolve(nil, [NSError branchErrorWithCode:BNCOpenResponseTimeoutError]);
+        });
+    }
+}
+
 - (BranchUniversalObject *)getLatestReferringBranchUniversalObject {
     NSDictionary *params = [self getLatestReferringParams];
     if ([[params objectForKey:BRANCH_INIT_KEY_CLICKED_BRANCH_LINK] isEqual:@1]) {
@@ -1421,7 +1592,92 @@ static NSString *bnc_branchKey = nil;
 - (void)getSpotlightUrlWithParams:(NSDictionary *)params callback:(callbackWithParams)callback {
     [self initSafetyCheck];
     dispatch_async(self.isolationQueue, ^(){
-        BranchSpotlightUrlRequest *req = [[BranchSpotlightUrlRequest alloc] initWithParams:params callback:callback];
+        __block BNCRequestCoalescerCompletion finishRequest = nil;
+        BranchSpotlightUrlRequest *req = [[BranchSpotlightUrlRequest alloc] initWithParams:params callback:^(NSDictionary *data, NSError *error) {
+            finishRequest(data, error);
+        }];
+
+        [self.spotlightUrlRequests performForKey:BNCRequestKeyForLinkData(req.linkData) work:^(BNCRequestCoalescerCompletion finish) {
+            finishRequest = finish;
+            [self.requestQueue enqueue:req];
+            [self processNextQueueItem];
+        } completion:^(id data, NSError *error) {
+            if (callback) callback(data, error);
+        }];
+    });
+}
+
+- (void)getShortUrlsForUniversalObjects:(NSArray<BranchUniversalObject *> *)universalObjects linkProperties:(NSArray<BranchLinkProperties *> *)linkProperties andCallback:(callbackWithUrls)callback {
+    if (universalObjects.count != linkProperties.count) {
+        NSError *error = [NSError branchErrorWithCode:BNCBadRequestError localizedMessage:@"Each universal object needs link properties."];
+        [[BranchLogger shared] logError:@"Could not generate URLs." error:error];
+        if (callback) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                callback(@[], error);
+            });
+        }
+        return;
+    }
+
+    [self initSafetyCheck];
+    dispatch_async(self.isolationQueue, ^(){
+        NSMutableArray *urls = [NSMutableArray arrayWithCapacity:universalObjects.count];
+        NSMutableArray<NSNumber *> *positions = [NSMutableArray new];
+        NSMutableArray<BranchShortUrlRequest *> *requests = [NSMutableArray new];
+        NSError *contentError = nil;
+
+        for (NSUInteger i = 0; i < universalObjects.count; i++) {
+            BranchUniversalObject *universalObject = universalObjects[i];
+            BranchLinkProperties *properties = linkProperties[i];
+            if (!universalObject.canonicalIdentifier && !universalObject.title) {
+                contentError = contentError ?: [NSError branchErrorWithCode:BNCContentIdentifierError localizedMessage:@"Could not generate a URL."];
+                [urls addObject:self.preferenceHelper.userUrl ?: [NSNull null]];
+                continue;
+            }
+
+            NSDictionary *params = [universalObject getParamsForServerRequestWithAddedLinkProperties:properties];
+            BNCLinkData *linkData = [self prepareLinkDataFor:properties.tags
+                                                    andAlias:properties.alias
+                                                     andType:BranchLinkTypeUnlimitedUse
+                                            andMatchDuration:properties.matchDuration
+                                                  andChannel:properties.channel
+                                                  andFeature:properties.feature
+                                                    andStage:properties.stage
+                                                 andCampaign:properties.campaign
+                                                   andParams:params
+                                              ignoreUAString:nil];
+            [requests addObject:[[BranchShortUrlRequest alloc] initWithTags:properties.tags
+                                                                      alias:properties.alias
+                                                                       type:BranchLinkTypeUnlimitedUse
+                                                              matchDuration:properties.matchDuration
+                                                                    channel:properties.channel
+                                                                    feature:properties.feature
+                                                                      stage:properties.stage
+                                                                   campaign:properties.campaign
+                                                                     params:params
+                                                                   linkData:linkData
+                                                                  linkCache:self.linkCache
+                                                                   callback:nil]];
+            [positions addObject:@(i)];
+            [urls addObject:[NSNull null]];
+        }
+
+        BranchShortUrlBatchRequest *req = [[BranchShortUrlBatchRequest alloc] initWithRequests:requests linkCache:self.linkCache callback:^(NSArray *batchUrls, NSError *error) {
+            for (NSUInteger i = 0; i < batchUrls.count; i++) {
+                urls[positions[i].unsignedIntegerValue] = batchUrls[i];
+            }
+            if (callback) {
+                // callback on main, like the single link methods
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    callback([urls copy], error ?: contentError);
+                });
+            }
+        }];
+
+        if (req.missCount == 0) {
+            [req processResponse:nil error:nil];
+            return;
+        }
         [self.requestQueue enqueue:req];
         [self processNextQueueItem];
     });
@@ -1634,7 +1890,11 @@ static NSString *bnc_branchKey = nil;
     @synchronized (self) {
         static dispatch_once_t onceToken = 0;
         dispatch_once(&onceToken, ^{
+            // Starts loading preferences in the background, set up everything that does not need them first
             BNCPreferenceHelper *preferenceHelper = [BNCPreferenceHelper sharedInstance];
+            BNCServerInterface *serverInterface = [[BNCServerInterface alloc] init];
+            BNCServerRequestQueue *requestQueue = [BNCServerRequestQueue getInstance];
+            BNCLinkCache *linkCache = [[BNCLinkCache alloc] initWithStorageURL:[BNCLinkCache defaultStorageURL]];
 
             // If there was stored key and it isn't the same as the currently used (or doesn't exist), we need to clean up
             // Note: Link Click Identifier is not cleared because of the potential for that to mess up a deep link
@@ -1647,8 +1907,9 @@ static NSString *bnc_branchKey = nil;
                 preferenceHelper.userUrl = nil;
                 preferenceHelper.installParams = nil;
                 preferenceHelper.sessionParams = nil;
+                [[BNCQRCodeCache sharedInstance] clear];
 
-                [[BNCServerRequestQueue getInstance] clearQueue];
+                [requestQueue clearQueue];
             }
 
             if(!preferenceHelper.firstAppLaunchTime){
@@ -1656,10 +1917,14 @@ static NSString *bnc_branchKey = nil;
             }
             
             preferenceHelper.lastRunBranchKey = key;
+
+            // Short links are persisted across launches, but only for the current Branch key and user URL
+            [linkCache updateContextWithBranchKey:key userUrl:preferenceHelper.userUrl];
+
             branch =
-                [[Branch alloc] initWithInterface:[[BNCServerInterface alloc] init]
-                    queue:[BNCServerRequestQueue getInstance]
-                    cache:[[BNCLinkCache alloc] init]
+                [[Branch alloc] initWithInterface:serverInterface
+                    queue:requestQueue
+                    cache:linkCache
                     preferenceHelper:preferenceHelper
                     key:key];
             
@@ -1706,20 +1971,27 @@ static NSString *bnc_branchKey = nil;
             return;
         }
 
-        BranchShortUrlRequest *req = [[BranchShortUrlRequest alloc] initWithTags:tags
-                                                                           alias:alias
-                                                                            type:type
-                                                                   matchDuration:duration
-                                                                         channel:channel
-                                                                         feature:feature
-                                                                           stage:stage
-                                                                        campaign:campaign
-                                                                          params:params
-                                                                        linkData:linkData
-                                                                       linkCache:self.linkCache
-                                                                        callback:callback];
-        [self.requestQueue enqueue:req];
-        [self processNextQueueItem];
+        // attach to an identical request that is already queued
+        [self.shortUrlRequests performForKey:BNCRequestKeyForLinkData(linkData) work:^(BNCRequestCoalescerCompletion finish) {
+            BranchShortUrlRequest *req = [[BranchShortUrlRequest alloc] initWithTags:tags
+                                                                               alias:alias
+                                                                                type:type
+                                                                       matchDuration:duration
+                                                                             channel:channel
+                                                                             feature:feature
+                                                                               stage:stage
+                                                                            campaign:campaign
+                                                                              params:params
+                                                                            linkData:linkData
+                                                                           linkCache:self.linkCache
+                                                                            callback:^(NSString *url, NSError *error) {
+                finish(url, error);
+            }];
+            [self.requestQueue enqueue:req];
+            [self processNextQueueItem];
+        } completion:^(id url, NSError *error) {
+            if (callback) callback(url, error);
+        }];
     });
 }
 
@@ -1756,28 +2028,32 @@ static NSString *bnc_branchKey = nil;
 
         shortURL = [self.linkCache objectForKey:linkData];
     } else {
-        BranchShortUrlSyncRequest *req =
-        [[BranchShortUrlSyncRequest alloc]
-         initWithTags:tags
-         alias:alias
-         type:type
-         matchDuration:duration
-         channel:channel
-         feature:feature
-         stage:stage
-         campaign:campaign
-         params:params
-         linkData:linkData
-         linkCache:self.linkCache];
-        
-        [[BranchLogger shared] logVerbose:@"Requesting Branch Link synchronously" error:nil];
-        BNCServerResponse *serverResponse = [req makeRequest:self.serverInterface key:self.class.branchKey];
-        shortURL = [req processResponse:serverResponse];
-        
-        // cache the link
-        if (shortURL) {
-            [self.linkCache setObject:shortURL forKey:linkData];
-        }
+        // concurrent callers for the same link wait for the first one's request
+        shortURL = [self.shortUrlSyncRequests performSynchronouslyForKey:BNCRequestKeyForLinkData(linkData) work:^id {
+            BranchShortUrlSyncRequest *req =
+            [[BranchShortUrlSyncRequest alloc]
+             initWithTags:tags
+             alias:alias
+             type:type
+             matchDuration:duration
+             channel:channel
+             feature:feature
+             stage:stage
+             campaign:campaign
+             params:params
+             linkData:linkData
+             linkCache:self.linkCache];
+
+            [[BranchLogger shared] logVerbose:@"Requesting Branch Link synchronously" error:nil];
+            BNCServerResponse *serverResponse = [req makeRequest:self.serverInterface key:self.class.branchKey];
+            NSString *url = [req processResponse:serverResponse];
+
+            // cache the link
+            if (url) {
+                [self.linkCache setObject:url forKey:linkData];
+            }
+            return url;
+        }];
     }
     
     return shortURL;
@@ -1910,11 +2186,9 @@ static NSString *bnc_branchKey = nil;
 - (void)applicationDidBecomeActive {
     [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"applicationDidBecomeActive"] error:nil];
 
-    @synchronized ([Branch class]) {
-        if (bnc_disableAutomaticOpenTracking) {
-            [[BranchLogger shared] logVerbose:@"applicationDidBecomeActive: automatic open tracking is disabled, skipping" error:nil];
-            return;
-        }
+    if ([Branch automaticOpenTrackingDisabled]) {
+        [[BranchLogger shared] logVerbose:@"applicationDidBecomeActive: automatic open tracking is disabled, skipping" error:nil];
+        return;
     }
 
     dispatch_async(self.isolationQueue, ^(){
@@ -1926,14 +2200,89 @@ static NSString *bnc_branchKey = nil;
         if (!Branch.trackingDisabled && self.initializationStatus != BNCInitStatusInitialized && !installOrOpenInQueue) {
             [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"applicationDidBecomeActive trackingDisabled %d initializationStatus %d installOrOpenInQueue %d", Branch.trackingDisabled, self.initializationStatus, installOrOpenInQueue] error:nil];
 
-            [self initUserSessionAndCallCallback:YES sceneIdentifier:nil urlString:nil reset:NO];
+            if ([self canWarmResume]) {
+                [self warmResume];
+            } else {
+                [self initUserSessionAndCallCallback:YES sceneIdentifier:nil urlString:nil reset:NO];
+            }
         }
     });
 }
 
+// Called on the isolation queue
+- (BOOL)canWarmResume {
+    NSDate *lastOpenDate = self.lastOpenDate;
+    if (self.warmResumeInterval <= 0 || !lastOpenDate) return NO;
+    if ([lastOpenDate timeIntervalSinceNow] < -self.warmResumeInterval) return NO;
+
+    @synchronized (self) {
+        if (self.deferInitForPluginRuntime || self.cachedURLString) return NO;
+    }
+
+    // an install, or a link, user activity or spotlight item waiting for the next open, needs a full open
+    BNCPreferenceHelper *preferenceHelper = self.preferenceHelper;
+    if (!preferenceHelper.randomizedBundleToken) return NO;
+    if (preferenceHelper.linkClickIdentifier.length ||
+        preferenceHelper.universalLinkUrl.length ||
+        preferenceHelper.spotlightIdentifier.length ||
+        preferenceHelper.externalIntentURI.length) {
+        return NO;
+    }
+
+    // the cached session is only what the next open returns if it didn't come from a link
+    return ![[self getLatestReferringParams][BRANCH_INIT_KEY_CLICKED_BRANCH_LINK] boolValue];
+}
+
+// Called on the isolation queue. The cached session goes through the usual success path right away, with its
+// notifications, and the open is sent in the background. The open response lock stays held until that open
+// returns, so synchronous readers get the server's params.
+- (void)warmResume {
+    [[BranchLogger shared] logDebug:@"Warm resume, calling back with the cached session" error:nil];
+    self.initializationStatus = BNCInitStatusInitialized;
+    [BranchOpenRequest setWaitNeededForOpenResponseLock];
+
+    NSDictionary *servedParams = [self getLatestReferringParams];
+    BranchOpenRequest *req = [[BranchOpenRequest alloc] initWithCallback:^(BOOL success, NSError *error) {
+        [self warmResumeOpenDidFinishWithError:error servedParams:servedParams];
+    }];
+    req.traceCallback = bnc_tracingCallback;
+    [self.requestQueue insert:req at:0];
+    [self processNextQueueItem];
+
+    dispatch_async(dispatch_get_main_queue(), ^ {
+        [self sendWillStartSessionNotification];
+        [self handleInitSuccessAndCallCallback:YES sceneIdentifier:nil];
+    });
+}
+
+// The background open can still find a link, deferred or matched on the server, that the cached session didn't
+// have. That session is delivered with a second success callback. A failed open ends the session the way a failed
+// full open does, without calling back again, so the next request or foreground opens again.
+- (void)warmResumeOpenDidFinishWithError:(NSError *)error servedParams:(NSDictionary *)servedParams {
+    if (error) {
+        [[BranchLogger shared] logDebug:@"Background open after warm resume failed" error:error];
+        dispatch_async(dispatch_get_main_queue(), ^ {
+            [self handleInitFailure:error callCallback:NO sceneIdentifier:nil];
+        });
+        return;
+    }
+
+    self.lastOpenDate = [NSDate date];
+    NSDictionary *params = [self getLatestReferringParams];
+    if ([params[BRANCH_INIT_KEY_CLICKED_BRANCH_LINK] boolValue] && ![params isEqualToDictionary:servedParams]) {
+        [[BranchLogger shared] logDebug:@"Background open after warm resume found a link, calling back again" error:nil];
+        dispatch_async(dispatch_get_main_queue(), ^ {
+            [self handleInitSuccessAndCallCallback:YES sceneIdentifier:nil];
+        });
+    }
+}
+
 - (void)applicationWillResignActive {
     [[BranchLogger shared] logVerbose:@"applicationWillResignActive" error:nil];
 
+    // don't leave preference changes waiting on the persist window while the app may be suspended
+    [self.preferenceHelper flush];
+
     dispatch_async(self.isolationQueue, ^(){
         if (!Branch.trackingDisabled) {
             self.initializationStatus = BNCInitStatusUninitialized;
@@ -2097,13 +2446,19 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
                 }
             }
             
+            // build the request once the data it reads is loaded, usually already the case
             dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
-            dispatch_async(queue, ^ {
+            uint64_t traceID = (BNCTraceIsEnabled()) ? BNCTraceNextIdentifier() : 0;
+            BNC_TRACE_ASYNC_BEGIN("request_wait_for_startup", traceID);
+            [self.startupPipeline notifyWhenStagesComplete:[self requestBuildStages] queue:queue block:^{
+                BNC_TRACE_ASYNC_END("request_wait_for_startup", traceID);
+                BNC_TRACE_ASYNC_BEGIN(NSStringFromClass(req.class).UTF8String, traceID);
                 [req makeRequest:self.serverInterface key:self.class.branchKey callback:
                     ^(BNCServerResponse* response, NSError* error) {
+                        BNC_TRACE_ASYNC_END(NSStringFromClass(req.class).UTF8String, traceID);
                         [self processRequest:req response:response error:error];
                 }];
-            });
+            }];
         }
     }
     else {
@@ -2111,6 +2466,13 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
     }
 }
 
+// Queued link requests were dropped and will never call back, so callers waiting on them are failed
+- (void)requestQueueDidClear {
+    NSError *error = [NSError branchErrorWithCode:BNCGeneralError localizedMessage:@"The request queue was cleared."];
+    [self.shortUrlRequests failAllWithError:error];
+    [self.spotlightUrlRequests failAllWithError:error];
+}
+
 - (void)clearNetworkQueue {
     dispatch_semaphore_wait(self.processing_sema, DISPATCH_TIME_FOREVER);
     self.networkCount = 0;
@@ -2180,8 +2542,10 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
         }
     }
     
+    uint64_t traceID = (BNCTraceIsEnabled()) ? BNCTraceNextIdentifier() : 0;
+    BNC_TRACE_ASYNC_BEGIN("isolation_queue_wait", traceID);
     dispatch_async(self.isolationQueue, ^(){
-
+        BNC_TRACE_ASYNC_END("isolation_queue_wait", traceID);
         
         // If the session is not yet initialized  OR
         // If the session is already initialized or is initializing but we need to reset it.
@@ -2190,25 +2554,27 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
         }
         // If the session was initialized, but callCallback was specified, do so.
         else if (callCallback && self.initializationStatus == BNCInitStatusInitialized) {
-            // callback on main, this is generally what the client expects and maintains our previous behavior
-            dispatch_async(dispatch_get_main_queue(), ^ {
-                if (self.sceneSessionInitWithCallback) {
-                    BNCInitSessionResponse *response = [BNCInitSessionResponse new];
-                    response.params = [self getLatestReferringParams];
-                    response.universalObject = [self getLatestReferringBranchUniversalObject];
-                    response.linkProperties = [self getLatestReferringBranchLinkProperties];
-                    response.sceneIdentifier = sceneIdentifier;
-
-                    self.sceneSessionInitWithCallback(response, nil);
-                }
-            });
+            [self callInitCallbackWithCachedSessionForSceneIdentifier:sceneIdentifier];
         }
     });
 }
 
-// only called from initUserSessionAndCallCallback!
-- (void)initializeSessionAndCallCallback:(BOOL)callCallback sceneIdentifier:(NSString *)sceneIdentifier urlString:(NSString *)urlString {
+- (void)callInitCallbackWithCachedSessionForSceneIdentifier:(NSString *)sceneIdentifier {
+    // callback on main, this is generally what the client expects and maintains our previous behavior
+    dispatch_async(dispatch_get_main_queue(), ^ {
+        if (self.sceneSessionInitWithCallback) {
+            BNCInitSessionResponse *response = [BNCInitSessionResponse new];
+            response.params = [self getLatestReferringParams];
+            response.universalObject = [self getLatestReferringBranchUniversalObject];
+            response.linkProperties = [self getLatestReferringBranchLinkProperties];
+            response.sceneIdentifier = sceneIdentifier;
+
+            self.sceneSessionInitWithCallback(response, nil);
+        }
+    });
+}
 
+- (void)sendWillStartSessionNotification {
     // BranchDelegate willStartSessionWithURL notification
     NSURL *URL = (self.preferenceHelper.referringURL.length) ? [NSURL URLWithString:self.preferenceHelper.referringURL] : nil;
     if ([self.delegate respondsToSelector:@selector(branch:willStartSessionWithURL:)]) {
@@ -2219,9 +2585,18 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
     NSMutableDictionary *userInfo = [NSMutableDictionary new];
     userInfo[BranchURLKey] = URL;
     [[NSNotificationCenter defaultCenter] postNotificationName:BranchWillStartSessionNotification object:self userInfo:userInfo];
+}
+
+// only called from initUserSessionAndCallCallback!
+- (void)initializeSessionAndCallCallback:(BOOL)callCallback sceneIdentifier:(NSString *)sceneIdentifier urlString:(NSString *)urlString {
+
+    [self sendWillStartSessionNotification];
     
     // Prepare callback block
     callbackWithStatus initSessionCallback = ^(BOOL success, NSError *error) {
+        if (!error) {
+            self.lastOpenDate = [NSDate date];
+        }
         // callback on main, this is generally what the client expects and maintains our previous behavior
         dispatch_async(dispatch_get_main_queue(), ^ {
             if (error) {
@@ -2281,9 +2656,13 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
 
 - (void)handleInitSuccessAndCallCallback:(BOOL)callCallback sceneIdentifier:(NSString *)sceneIdentifier {
 
+    BNC_TRACE_BEGIN("init_success_callback");
     self.initializationStatus = BNCInitStatusInitialized;
     [[BranchLogger shared] logVerbose:[NSString stringWithFormat:@"initializationStatus %ld", self.initializationStatus] error:nil];
 
+    // The open response may have changed the user URL, which invalidates cached links
+    [self.linkCache updateContextWithBranchKey:self.class.branchKey userUrl:self.preferenceHelper.userUrl];
+
     NSDictionary *latestReferringParams = [self getLatestReferringParams];
 
     if ([latestReferringParams[@"_branch_validate"] isEqualToString:@"060514"]) {
@@ -2315,13 +2694,15 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
     }
     [self sendOpenNotificationWithLinkParameters:latestReferringParams error:nil];
 
-    [self.urlFilter updatePatternListFromServerWithCompletion:nil];
+    [self.urlFilter updatePatternListFromServerWhenIdle];
 
     if (self.shouldAutomaticallyDeepLink) {
         dispatch_async(dispatch_get_main_queue(), ^ {
             [self automaticallyDeeplinkWithReferringParams:latestReferringParams];
         });
     }
+    BNC_TRACE_END("init_success_callback");
+    [self finishColdStartTrace];
 }
 
 // TODO: can we deprecate and remove this, it doesn't work well.
@@ -2517,6 +2898,7 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
     }
 
     [self sendOpenNotificationWithLinkParameters:@{} error:error];
+    [self finishColdStartTrace];
 }
 
 - (void)dealloc {
@@ -2580,6 +2962,8 @@ static inline void BNCPerformBlockOnMainThreadSync(dispatch_block_t block) {
     [[BNCServerRequestQueue getInstance] clearQueue];
     [BranchOpenRequest releaseOpenResponseLock];
     [BNCPreferenceHelper clearAll];
+    [[NSFileManager defaultManager] removeItemAtURL:[BNCLinkCache defaultStorageURL] error:nil];
+    [[BNCQRCodeCache sharedInstance] clear];
 }
 
 @end
@@ -24,6 +24,7 @@
 #import "BNCRequestFactory.h"
 
 #import "BNCServerAPI.h"
+#import "BNCTrace.h"
 #import "BNCInAppBrowser.h"
 
 @interface BranchOpenRequest ()
@@ -59,6 +60,12 @@
 }
 
 - (void)processResponse:(BNCServerResponse *)response error:(NSError *)error {
+    BNC_TRACE_BEGIN("process_open_response");
+    [self processOpenResponse:response error:error];
+    BNC_TRACE_END("process_open_response");
+}
+
+- (void)processOpenResponse:(BNCServerResponse *)response error:(NSError *)error {
     
     if (self.traceCallback) {
         self.traceCallback(self.urlString, self.requestParams, response.data, error, self.requestServiceURL);
@@ -89,96 +96,99 @@
         userIdentity = [userIdentity stringValue];
     }
     
-    if ([data objectForKey:BRANCH_RESPONSE_KEY_RANDOMIZED_DEVICE_TOKEN]) {
-        preferenceHelper.randomizedDeviceToken = data[BRANCH_RESPONSE_KEY_RANDOMIZED_DEVICE_TOKEN];
-        if (!preferenceHelper.randomizedDeviceToken) {
-            // fallback to deprecated name. Fingerprinting was removed long ago, hence the name change.
-            preferenceHelper.randomizedDeviceToken = data[@"device_fingerprint_id"];
+    // Session state from the response is persisted as one transaction, so a crash cannot leave a partial install on disk.
+    [preferenceHelper performBatchUpdates:^{
+        if ([data objectForKey:BRANCH_RESPONSE_KEY_RANDOMIZED_DEVICE_TOKEN]) {
+            preferenceHelper.randomizedDeviceToken = data[BRANCH_RESPONSE_KEY_RANDOMIZED_DEVICE_TOKEN];
+            if (!preferenceHelper.randomizedDeviceToken) {
+                // fallback to deprecated name. Fingerprinting was removed long ago, hence the name change.
+                preferenceHelper.randomizedDeviceToken = data[@"device_fingerprint_id"];
+            }
         }
-    }
    
-    if (data[BRANCH_RESPONSE_KEY_USER_URL]) {
-        preferenceHelper.userUrl = data[BRANCH_RESPONSE_KEY_USER_URL];
-    }
-    preferenceHelper.userIdentity = userIdentity;
-    if ([data objectForKey:BRANCH_RESPONSE_KEY_SESSION_ID])
-        preferenceHelper.sessionID = data[BRANCH_RESPONSE_KEY_SESSION_ID];
-    preferenceHelper.previousAppBuildDate = [BNCApplication currentApplication].currentBuildDate;
-
-    NSString *sessionData = data[BRANCH_RESPONSE_KEY_SESSION_DATA];
-    if (sessionData == nil || [sessionData isKindOfClass:[NSString class]]) {
-    } else
-    if ([sessionData isKindOfClass:[NSDictionary class]]) {
-        [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Received session data of type '%@' data is '%@'.", NSStringFromClass(sessionData.class), sessionData] error:nil];
-        sessionData = [BNCEncodingUtils encodeDictionaryToJsonString:(NSDictionary*)sessionData];
-    } else
-    if ([sessionData isKindOfClass:[NSArray class]]) {
-        [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Received session data of type '%@' data is '%@'.", NSStringFromClass(sessionData.class), sessionData] error:nil];
-        sessionData = [BNCEncodingUtils encodeArrayToJsonString:(NSArray*)sessionData];
-    } else {
-        [[BranchLogger shared] logError:[NSString stringWithFormat:@"Received session data of type '%@' data is '%@'.", NSStringFromClass(sessionData.class), sessionData] error:error];
-        sessionData = nil;
-    }
+        if (data[BRANCH_RESPONSE_KEY_USER_URL]) {
+            preferenceHelper.userUrl = data[BRANCH_RESPONSE_KEY_USER_URL];
+        }
+        preferenceHelper.userIdentity = userIdentity;
+        if ([data objectForKey:BRANCH_RESPONSE_KEY_SESSION_ID])
+            preferenceHelper.sessionID = data[BRANCH_RESPONSE_KEY_SESSION_ID];
+        preferenceHelper.previousAppBuildDate = [BNCApplication currentApplication].currentBuildDate;
+
+        NSString *sessionData = data[BRANCH_RESPONSE_KEY_SESSION_DATA];
+        if (sessionData == nil || [sessionData isKindOfClass:[NSString class]]) {
+        } else
+        if ([sessionData isKindOfClass:[NSDictionary class]]) {
+            [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Received session data of type '%@' data is '%@'.", NSStringFromClass(sessionData.class), sessionData] error:nil];
+            sessionData = [BNCEncodingUtils encodeDictionaryToJsonString:(NSDictionary*)sessionData];
+        } else
+        if ([sessionData isKindOfClass:[NSArray class]]) {
+            [[BranchLogger shared] logWarning:[NSString stringWithFormat:@"Received session data of type '%@' data is '%@'.", NSStringFromClass(sessionData.class), sessionData] error:nil];
+            sessionData = [BNCEncodingUtils encodeArrayToJsonString:(NSArray*)sessionData];
+        } else {
+            [[BranchLogger shared] logError:[NSString stringWithFormat:@"Received session data of type '%@' data is '%@'.", NSStringFromClass(sessionData.class), sessionData] error:error];
+            sessionData = nil;
+        }
 
-    // Update session params
+        // Update session params
 
-    if (preferenceHelper.spotlightIdentifier) {
-        NSMutableDictionary *sessionDataDict =
-        [NSMutableDictionary dictionaryWithDictionary: [BNCEncodingUtils decodeJsonStringToDictionary:sessionData]];
-        NSDictionary *spotlightDic = @{BRANCH_RESPONSE_KEY_SPOTLIGHT_IDENTIFIER:preferenceHelper.spotlightIdentifier};
-        [sessionDataDict addEntriesFromDictionary:spotlightDic];
-        sessionData = [BNCEncodingUtils encodeDictionaryToJsonString:sessionDataDict];
-    }
+        if (preferenceHelper.spotlightIdentifier) {
+            NSMutableDictionary *sessionDataDict =
+            [NSMutableDictionary dictionaryWithDictionary: [BNCEncodingUtils decodeJsonStringToDictionary:sessionData]];
+            NSDictionary *spotlightDic = @{BRANCH_RESPONSE_KEY_SPOTLIGHT_IDENTIFIER:preferenceHelper.spotlightIdentifier};
+            [sessionDataDict addEntriesFromDictionary:spotlightDic];
+            sessionData = [BNCEncodingUtils encodeDictionaryToJsonString:sessionDataDict];
+        }
     
-    preferenceHelper.sessionParams = sessionData;
-
-    // Scenarios:
-    // If no data, data isn't from a link click, or isReferrable is false, don't set, period.
-    // Otherwise,
-    // * On Install: set.
-    // * On Open and installParams set: don't set.
-    if (sessionData.length) {
-        NSDictionary *sessionDataDict = [BNCEncodingUtils decodeJsonStringToDictionary:sessionData];
-        BOOL dataIsFromALinkClick = [sessionDataDict[BRANCH_RESPONSE_KEY_CLICKED_BRANCH_LINK] isEqual:@1];
-
-        if (dataIsFromALinkClick && self.isInstall) {
-            preferenceHelper.installParams = sessionData;
+        preferenceHelper.sessionParams = sessionData;
+
+        // Scenarios:
+        // If no data, data isn't from a link click, or isReferrable is false, don't set, period.
+        // Otherwise,
+        // * On Install: set.
+        // * On Open and installParams set: don't set.
+        if (sessionData.length) {
+            NSDictionary *sessionDataDict = [BNCEncodingUtils decodeJsonStringToDictionary:sessionData];
+            BOOL dataIsFromALinkClick = [sessionDataDict[BRANCH_RESPONSE_KEY_CLICKED_BRANCH_LINK] isEqual:@1];
+
+            if (dataIsFromALinkClick && self.isInstall) {
+                preferenceHelper.installParams = sessionData;
+            }
         }
-    }
 
-    NSString *referringURL = nil;
-    if (self.urlString.length > 0) {
-        referringURL = self.urlString;
-    } else {
-        NSDictionary *sessionDataDict = [BNCEncodingUtils decodeJsonStringToDictionary:sessionData];
-        NSString *link = sessionDataDict[BRANCH_RESPONSE_KEY_BRANCH_REFERRING_LINK];
-        if ([link isKindOfClass:[NSString class]]) {
-            if (link.length) {
-                referringURL = link;
+        NSString *referringURL = nil;
+        if (self.urlString.length > 0) {
+            referringURL = self.urlString;
+        } else {
+            NSDictionary *sessionDataDict = [BNCEncodingUtils decodeJsonStringToDictionary:sessionData];
+            NSString *link = sessionDataDict[BRANCH_RESPONSE_KEY_BRANCH_REFERRING_LINK];
+            if ([link isKindOfClass:[NSString class]]) {
+                if (link.length) {
+                    referringURL = link;
+                }
             }
         }
-    }
 
-    // Clear link identifiers so they don't get reused on the next open
-    preferenceHelper.linkClickIdentifier = nil;
-    preferenceHelper.spotlightIdentifier = nil;
-    preferenceHelper.universalLinkUrl = nil;
-    preferenceHelper.externalIntentURI = nil;
-    preferenceHelper.referringURL = referringURL;
-    preferenceHelper.initialReferrer = nil;
-    preferenceHelper.dropURLOpen = NO;
-    preferenceHelper.uxType = nil;
-    preferenceHelper.urlLoadMs = nil;
+        // Clear link identifiers so they don't get reused on the next open
+        preferenceHelper.linkClickIdentifier = nil;
+        preferenceHelper.spotlightIdentifier = nil;
+        preferenceHelper.universalLinkUrl = nil;
+        preferenceHelper.externalIntentURI = nil;
+        preferenceHelper.referringURL = referringURL;
+        preferenceHelper.initialReferrer = nil;
+        preferenceHelper.dropURLOpen = NO;
+        preferenceHelper.uxType = nil;
+        preferenceHelper.urlLoadMs = nil;
     
-    NSString *string = BNCStringFromWireFormat(data[BRANCH_RESPONSE_KEY_RANDOMIZED_BUNDLE_TOKEN]);
-    if (!string) {
-        // fallback to deprecated name. The old name was easily confused with the setIdentity, hence the name change.
-        string = BNCStringFromWireFormat(data[@"identity_id"]);
-    }
+        NSString *string = BNCStringFromWireFormat(data[BRANCH_RESPONSE_KEY_RANDOMIZED_BUNDLE_TOKEN]);
+        if (!string) {
+            // fallback to deprecated name. The old name was easily confused with the setIdentity, hence the name change.
+            string = BNCStringFromWireFormat(data[@"identity_id"]);
+        }
     
-    if (string) {
-        preferenceHelper.randomizedBundleToken = string;
-    }
+        if (string) {
+            preferenceHelper.randomizedBundleToken = string;
+        }
+    }];
     
     [BranchOpenRequest releaseOpenResponseLock];
     
@@ -399,6 +409,11 @@ static BOOL openRequestWaitQueueIsSuspended = NO;
     });
 }
 
++ (void) notifyWhenOpenResponseLockReleased:(dispatch_block_t)block {
+    // queued blocks run once the suspended queue is resumed
+    dispatch_async(openRequestWaitQueue, block);
+}
+
 + (void) releaseOpenResponseLock {
     @synchronized (self) {
         if (openRequestWaitQueueIsSuspended) {
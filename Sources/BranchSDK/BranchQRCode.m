@@ -9,6 +9,7 @@
 #import "BranchQRCode.h"
 #import "Branch.h"
 #import "BNCQRCodeCache.h"
+#import "BNCQRCodeGenerator.h"
 #import "BNCConfig.h"
 #import "BranchConstants.h"
 #import "NSError+Branch.h"
@@ -71,10 +72,11 @@
     
     settings[@"image_format"] = (self.imageFormat == BranchQRCodeImageFormatJPEG) ? @"JPEG" : @"PNG";
     
+    UIImage *logoImage = nil;
     if (self.centerLogo) {
         NSData *data=[NSData dataWithContentsOfURL:[NSURL URLWithString: self.centerLogo]];
-        UIImage *image=[UIImage imageWithData:data];
-        if (image == nil) {
+        logoImage=[UIImage imageWithData:data];
+        if (logoImage == nil) {
             [[BranchLogger shared] logWarning:@"QR code center logo was an invalid URL string." error:nil];
         } else {
             settings[@"center_logo_url"] = self.centerLogo;
@@ -97,17 +99,18 @@
     parameters[BRANCH_REQUEST_KEY_REQUEST_CREATION_TIME_STAMP] = BNCWireFormatFromDate(timestamp);
     parameters[BRANCH_REQUEST_KEY_REQUEST_UUID] = [BNCServerRequest generateRequestUUIDFromDate:timestamp];
     
-    NSData *cachedQRCode = [[BNCQRCodeCache sharedInstance] checkQRCodeCache:parameters];
-    if (cachedQRCode) {
-        completion(cachedQRCode, nil);
-        return;
-    }
-    
-    [self callQRCodeAPI:parameters completion:^(NSData * _Nullable qrCode, NSError * _Nullable error){
-        if (completion != nil) {
-            if (qrCode != nil) {
-                [[BNCQRCodeCache sharedInstance] addQRCodeToCache:qrCode withParams:parameters];
+    [[BNCQRCodeCache sharedInstance] qrCodeForParams:parameters fetch:^(BNCQRCodeCacheFetchCompletion done) {
+        [self generateQRCode:buo linkProperties:lp centerLogo:logoImage completion:^(NSData * _Nullable qrCode, BOOL cacheable) {
+            if (qrCode) {
+                done(qrCode, nil, cacheable);
+            } else {
+                [self callQRCodeAPI:parameters completion:^(NSData * _Nullable qrCode, NSError * _Nullable error) {
+                    done(qrCode, error, YES);
+                }];
             }
+        }];
+    } completion:^(NSData * _Nullable qrCode, NSError * _Nullable error) {
+        if (completion != nil) {
             completion(qrCode, error);
         }
     }];
@@ -128,6 +131,41 @@
     }];
 }
 
+// Renders the QR code on device. Completes with nil when the style or link needs the QR code service.
+// A QR code for the offline long link fallback is not cacheable, the next request should get the short link.
+- (void)generateQRCode:(nullable BranchUniversalObject *)buo
+        linkProperties:(nullable BranchLinkProperties *)lp
+            centerLogo:(nullable UIImage *)centerLogo
+            completion:(void(^)(NSData * _Nullable qrCode, BOOL cacheable))completion {
+
+    BNCQRCodeGenerator *generator = [BNCQRCodeGenerator new];
+    generator.codeColor = self.codeColor;
+    generator.backgroundColor = self.backgroundColor;
+    generator.centerLogo = centerLogo;
+    generator.width = self.width.integerValue;
+    generator.margin = self.margin.integerValue;
+    generator.imageFormat = self.imageFormat;
+
+    if (![generator supportsStyle]) {
+        completion(nil);
+        return;
+    }
+
+    BranchUniversalObject *universalObject = buo ?: [BranchUniversalObject new];
+    BranchLinkProperties *linkProperties = lp ?: [BranchLinkProperties new];
+
+    // Falls back to a long link when offline, which still resolves once scanned
+    [universalObject getShortUrlWithLinkProperties:linkProperties andCallback:^(NSString * _Nullable url, NSError * _Nullable error) {
+        if (url.length == 0 || error.code == BNCContentIdentifierError) {
+            completion(nil, NO);
+            return;
+        }
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            completion([generator imageDataForString:url], error == nil);
+        });
+    }];
+}
+
 - (void)callQRCodeAPI:(nullable NSDictionary *)params
            completion:(void(^)(NSData * _Nullable qrCode, NSError * _Nullable error))completion {
     
@@ -151,9 +189,11 @@
             if ([NSError branchDNSBlockingError:error]) {
                 NSError *dnsError = [NSError branchErrorWithCode:BNCDNSAdBlockerError];
                 [[BranchLogger shared] logError:[NSString stringWithFormat:@"Possible DNS Ad Blocker. Giving up on QR code request. Underlying error: %@", error] error:dnsError];
+                completion(nil, dnsError);
             } else if ([NSError branchVPNBlockingError:error]) {
                 NSError *vpnError = [NSError branchErrorWithCode:BNCVPNAdBlockerError];
                 [[BranchLogger shared] logError:[NSString stringWithFormat:@"Possible VPN Ad Blocker. Giving up on QR code request. Underlying error: %@", error] error:vpnError];
+                completion(nil, vpnError);
             } else {
                 [[BranchLogger shared] logError:@"QR Code request failed" error:error];
                 completion(nil, error);
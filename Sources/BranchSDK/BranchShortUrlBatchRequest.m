@@ -0,0 +1,129 @@
+//
+//  BranchShortUrlBatchRequest.m
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BranchShortUrlBatchRequest.h"
+#import "BNCRequestFactory.h"
+#import "BNCServerAPI.h"
+#import "BranchConstants.h"
+#import "NSError+Branch.h"
+#import "BranchLogger.h"
+
+@interface BranchShortUrlBatchRequest ()
+@property (nonatomic, strong) NSMutableArray *urls;
+@property (nonatomic, strong) NSArray<BranchShortUrlRequest *> *pendingRequests;
+@property (nonatomic, strong) NSError *firstError;
+@property (nonatomic, copy) callbackWithUrls callback;
+@end
+
+@implementation BranchShortUrlBatchRequest
+
+- (instancetype)initWithRequests:(NSArray<BranchShortUrlRequest *> *)requests linkCache:(BNCLinkCache *)linkCache callback:(callbackWithUrls)callback {
+    if ((self = [super init])) {
+        _callback = callback;
+        _urls = [NSMutableArray arrayWithCapacity:requests.count];
+
+        // positions in the output waiting on each distinct link
+        NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *positions = [NSMutableDictionary new];
+        NSMutableArray<NSString *> *pendingKeys = [NSMutableArray new];
+
+        for (NSUInteger i = 0; i < requests.count; i++) {
+            BNCLinkData *linkData = requests[i].linkData;
+            NSString *cachedUrl = [linkCache objectForKey:linkData];
+            [_urls addObject:cachedUrl ?: [NSNull null]];
+            if (cachedUrl) continue;
+
+            // link data that is not valid JSON is never shared
+            NSString *key = linkData.digest ?: [NSUUID UUID].UUIDString;
+            if (!positions[key]) {
+                positions[key] = [NSMutableArray new];
+                [pendingKeys addObject:key];
+            }
+            [positions[key] addObject:@(i)];
+        }
+
+        // the first request for each link goes to the server and answers for its duplicates
+        NSMutableArray<BranchShortUrlRequest *> *pendingRequests = [NSMutableArray arrayWithCapacity:pendingKeys.count];
+        __weak BranchShortUrlBatchRequest *weakSelf = self;
+        for (NSString *key in pendingKeys) {
+            NSArray<NSNumber *> *indexes = positions[key];
+            NSMutableArray<callbackWithUrl> *callbacks = [NSMutableArray new];
+            for (NSNumber *index in indexes) {
+                callbackWithUrl callback = requests[index.unsignedIntegerValue].callback;
+                if (callback) [callbacks addObject:callback];
+            }
+
+            BranchShortUrlRequest *request = requests[indexes.firstObject.unsignedIntegerValue];
+            request.callback = ^(NSString * _Nullable url, NSError * _Nullable error) {
+                [weakSelf setUrl:url error:error atIndexes:indexes];
+                for (callbackWithUrl callback in callbacks) {
+                    callback(url, error);
+                }
+            };
+            [pendingRequests addObject:request];
+        }
+        _pendingRequests = pendingRequests;
+    }
+    return self;
+}
+
+- (NSUInteger)missCount {
+    return self.pendingRequests.count;
+}
+
+- (void)setUrl:(NSString *)url error:(NSError *)error atIndexes:(NSArray<NSNumber *> *)indexes {
+    for (NSNumber *index in indexes) {
+        self.urls[index.unsignedIntegerValue] = url ?: [NSNull null];
+    }
+    if (error && !self.firstError) {
+        self.firstError = error;
+    }
+}
+
+- (void)makeRequest:(BNCServerInterface *)serverInterface key:(NSString *)key callback:(BNCServerCallback)callback {
+    BNCRequestFactory *factory = [[BNCRequestFactory alloc] initWithBranchKey:key UUID:self.requestUUID TimeStamp:self.requestCreationTimeStamp];
+
+    NSMutableArray<NSDictionary *> *links = [NSMutableArray arrayWithCapacity:self.pendingRequests.count];
+    for (BranchShortUrlRequest *request in self.pendingRequests) {
+        [links addObject:[factory dataForShortURLWithLinkDataDictionary:[request.linkData.data mutableCopy] isSpotlightRequest:request.isSpotlightRequest]];
+    }
+
+    NSString *url = [NSString stringWithFormat:@"%@/%@", [[BNCServerAPI sharedInstance] linkBulkServiceURL], key];
+    [serverInterface postRequestWithArray:links url:url key:key callback:callback];
+}
+
+- (void)processResponse:(BNCServerResponse *)response error:(NSError *)error {
+    NSArray *results = response.data;
+    if (!error && self.pendingRequests.count && (![results isKindOfClass:NSArray.class] || results.count != self.pendingRequests.count)) {
+        error = [NSError branchErrorWithCode:BNCBadRequestError localizedMessage:@"Unexpected response from the bulk link endpoint."];
+    }
+
+    for (NSUInteger i = 0; i < self.pendingRequests.count; i++) {
+        BranchShortUrlRequest *request = self.pendingRequests[i];
+        if (error) {
+            [request processResponse:nil error:error];
+            continue;
+        }
+
+        NSDictionary *result = results[i];
+        if ([result isKindOfClass:NSDictionary.class] && [result[BRANCH_RESPONSE_KEY_URL] isKindOfClass:NSString.class]) {
+            BNCServerResponse *linkResponse = [BNCServerResponse new];
+            linkResponse.statusCode = response.statusCode;
+            linkResponse.data = result;
+            linkResponse.requestId = response.requestId;
+            [request processResponse:linkResponse error:nil];
+        } else {
+            NSString *message = [result isKindOfClass:NSDictionary.class] ? [result[@"error"] description] : nil;
+            [request processResponse:nil error:[NSError branchErrorWithCode:BNCBadRequestError localizedMessage:message]];
+        }
+    }
+
+    if (self.callback) {
+        self.callback([self.urls copy], self.firstError);
+    }
+}
+
+@end
@@ -27,7 +27,6 @@
 @property (strong, nonatomic) NSDictionary *params;
 @property (strong, nonatomic) BNCLinkCache *linkCache;
 @property (strong, nonatomic) BNCLinkData *linkData;
-@property (strong, nonatomic) callbackWithUrl callback;
 
 @end
 
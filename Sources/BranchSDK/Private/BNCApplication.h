@@ -45,7 +45,7 @@
 /// The date this app was installed on this device.
 @property (nonatomic, readonly, strong) NSDate*_Nullable currentInstallDate;
 
-/// The date this app was first installed on this device.
+/// The date this app was first installed on this device. Read from the keychain on first access.
 @property (nonatomic, readonly, strong) NSDate*_Nullable firstInstallDate;
 
 /// The team identifier for the app.
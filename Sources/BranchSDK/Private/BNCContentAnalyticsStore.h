@@ -0,0 +1,59 @@
+//
+//  BNCContentAnalyticsStore.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Content discovery events in their own append-only segment file, kept out of the preferences.
+
+ Each event is one line appended to the file, so saving an event costs the same however many are stored.
+ Drained events are skipped by moving the start offset in the file header, and the file is rewritten once
+ drained bytes pile up. When the byte limit is reached the oldest events are trimmed.
+ File I/O runs on the store's serial queue, appends never block the caller.
+ */
+@interface BNCContentAnalyticsStore : NSObject
+
+/// The store for `url`, shared within the process so appends to one file are serialized.
++ (BNCContentAnalyticsStore *)storeWithURL:(NSURL *)url;
+
+- (instancetype)initWithURL:(NSURL *)url;
+
+/// Store file name in the Branch directory.
++ (NSURL *)defaultURL;
+
+/// Maximum file size, the oldest events are dropped to stay under it. Default 256 KB.
+@property (atomic, assign) NSUInteger byteLimit;
+
+/// Bytes of events not yet drained.
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+
+- (void)appendEvent:(NSDictionary *)event sessionID:(NSString *)sessionID;
+
+/// Every event not yet drained, grouped by session ID in the order they were appended.
+- (NSMutableDictionary<NSString *, NSMutableArray *> *)eventsBySession;
+
+/**
+ Passes events, oldest first, in batches of up to `batchSize` grouped by session ID.
+ Returning YES removes the batch and continues, NO keeps it and stops.
+ The handler runs on the store's queue and must not call back into the store.
+ */
+- (void)drainEventsWithBatchSize:(NSUInteger)batchSize handler:(BOOL (^)(NSDictionary<NSString *, NSArray *> *batch))handler;
+
+- (void)removeAllEvents;
+
+/// Waits for pending appends.
+- (void)synchronize;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -28,6 +28,17 @@
 
 - (void)checkAdvertisingIdentifier;
 
+/**
+ Device fields of the v2 `user_data` dictionary, including idfa and idfv. Callers remove what the attribution level excludes.
+ The dictionary is immutable and shared. It is rebuilt only after a locale, user agent, plugin or network path change, when
+ the app reports an ATT status, or when the app becomes active, since ATT status and the advertising identifier can change
+ in Settings and the ATT prompt itself deactivates the app.
+ */
+- (NSDictionary *)userDataSnapshot;
+
+/// Rebuilds the user data snapshot on the next read.
+- (void)invalidateSnapshot;
+
 @property (nonatomic, copy, readwrite) NSString *hardwareId;
 @property (nonatomic, copy, readwrite) NSString *hardwareIdType;
 @property (nonatomic, assign, readwrite) BOOL isRealHardwareId;
@@ -0,0 +1,109 @@
+//
+//  BNCKVStore.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+// Log structured key value store in a memory mapped file.
+// Every change appends a typed record, an in-memory hash index points at the latest record per key,
+// and compaction rewrites the live records once superseded ones pass a threshold.
+// Plain C with no platform dependencies beyond POSIX so it can be built and benchmarked on any host.
+// Not thread safe, callers serialize access.
+
+#ifndef BNCKVStore_h
+#define BNCKVStore_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BNCKVStore BNCKVStore;
+typedef struct BNCKVCompaction BNCKVCompaction;
+
+enum {
+    // Compaction is due once garbage is at least this many bytes and more than the live bytes
+    BNCKVStoreCompactionMinGarbage = 32 * 1024
+};
+
+/// Callback for BNCKVStoreEnumerate. Pointers are only valid during the call.
+typedef void (*BNCKVStoreEnumerator)(const char *key, size_t keyLength, uint8_t type, const void *value, size_t valueLength, void *context);
+
+/**
+ Opens or creates the store at `path`. An unreadable file is reset to an empty store.
+ Records after the first damaged one, such as a write torn by a crash, are discarded.
+ Returns NULL and sets `error` to an errno value on failure.
+ */
+BNCKVStore *BNCKVStoreOpen(const char *path, int *error);
+
+/// Unmaps and closes the store. Changes not synced may still be written by the OS.
+void BNCKVStoreClose(BNCKVStore *store);
+
+/// Appends a record for `key`. An identical value for the key is not written again. Returns 0 or an errno value.
+int BNCKVStorePut(BNCKVStore *store, const char *key, size_t keyLength, uint8_t type, const void *value, size_t valueLength);
+
+/// Appends a tombstone for `key` if it is present. Returns 0 or an errno value.
+int BNCKVStoreDelete(BNCKVStore *store, const char *key, size_t keyLength);
+
+/**
+ Finds the latest value for `key` in constant time. `value` points into the mapping and is only
+ valid until the next put, delete or compaction.
+ */
+bool BNCKVStoreGet(const BNCKVStore *store, const char *key, size_t keyLength, uint8_t *type, const void **value, size_t *valueLength);
+
+/// Calls `enumerator` for each live key, in no particular order.
+void BNCKVStoreEnumerate(const BNCKVStore *store, BNCKVStoreEnumerator enumerator, void *context);
+
+size_t BNCKVStoreCount(const BNCKVStore *store);
+
+/// Bytes used by the latest record of each key.
+size_t BNCKVStoreLiveBytes(const BNCKVStore *store);
+
+/// Bytes used by superseded records and tombstones.
+size_t BNCKVStoreGarbageBytes(const BNCKVStore *store);
+
+bool BNCKVStoreNeedsCompaction(const BNCKVStore *store);
+
+/**
+ Rewrites the live records to a new file that atomically replaces the old one. Returns 0 or an errno value.
+ The store keeps its current file and mapping until the new one is mapped and indexed, so a failure changes nothing.
+ Same as the three steps below without letting other calls in between.
+ */
+int BNCKVStoreCompact(BNCKVStore *store);
+
+/**
+ Compaction in steps, so callers only need to serialize access to the store for the cheap ones.
+ Begin copies the live records in memory. Write saves and syncs the copy to a new file without touching the store.
+ Finish appends records written since Begin and replaces the store's file, it returns ESTALE if the store was cleared
+ or compacted in between. Always free the compaction, which removes the new file if it was not used.
+ */
+BNCKVCompaction *BNCKVStoreCompactionBegin(BNCKVStore *store, int *error);
+int BNCKVCompactionWrite(BNCKVCompaction *compaction);
+int BNCKVStoreCompactionFinish(BNCKVStore *store, BNCKVCompaction *compaction);
+void BNCKVCompactionFree(BNCKVCompaction *compaction);
+
+/// Flushes the mapping to disk. Returns 0 or an errno value.
+int BNCKVStoreSync(BNCKVStore *store);
+
+/// Removes every key. Returns 0 or an errno value.
+int BNCKVStoreClear(BNCKVStore *store);
+
+/**
+ Starts a batch. Puts and deletes until the commit are visible to this store at once, but the file only
+ covers them after BNCKVStoreCommitBatch, so a crash keeps either all of the batch or none of it.
+ Compaction and clearing are refused during a batch. Returns 0 or an errno value.
+ */
+int BNCKVStoreBeginBatch(BNCKVStore *store);
+
+/// Flushes the batch's records, then publishes them with a single header update. Returns 0 or an errno value.
+int BNCKVStoreCommitBatch(BNCKVStore *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BNCKVStore_h */
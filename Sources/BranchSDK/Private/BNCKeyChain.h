@@ -58,4 +58,19 @@
  */
 + (NSString * _Nullable) securityAccessGroup;
 
+/**
+ Number of SecItem calls made by this process. Reads are served from memory after the first read of a service.
+
+ The cache is per process. Items written by another process sharing the access group, such as an App Clip or an
+ app extension, or changed by iCloud keychain sync, are not seen until `clearCache` or the next launch.
+ If reading a whole service fails, for example while the device is locked, items are read one at a time and
+ cached individually, and the whole service read is not tried again for a minute.
+ */
++ (NSUInteger) roundTripCount;
+
+/**
+ Drops the cached items. The next read of a service fetches it from the keychain again.
+ */
++ (void) clearCache;
+
 @end
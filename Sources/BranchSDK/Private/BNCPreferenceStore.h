@@ -0,0 +1,64 @@
+//
+//  BNCPreferenceStore.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Preference storage backed by `BNCKVStore`.
+
+ Strings, numbers, dates and data are stored as typed records, other property list values as a keyed archive.
+ A change appends one record instead of rewriting the file. Compaction runs in the background once
+ superseded records pass the store's threshold.
+ */
+@interface BNCPreferenceStore : NSObject
+
+/// The store for `url`, shared within the process so there is only one mapping of each file. Nil if the file cannot be mapped.
++ (nullable BNCPreferenceStore *)storeWithURL:(NSURL *)url;
+
+/// Opens or creates the store. Returns nil if the file cannot be mapped.
+- (nullable instancetype)initWithURL:(NSURL *)url;
+
+/// Every stored value, decoded.
+- (NSMutableDictionary *)dictionary;
+
+- (nullable id)objectForKey:(NSString *)key;
+
+/// Passing nil removes the key.
+- (void)setObject:(nullable id)object forKey:(NSString *)key;
+
+- (void)removeAllObjects;
+
+/**
+ Runs `updates` as one transaction. Changes made by `updates` are flushed together and then committed with a
+ single header write, so after a crash the file has either all of them or none.
+ */
+- (void)performBatchUpdates:(void (NS_NOESCAPE ^)(void))updates;
+
+/// Flushes the mapping to disk and schedules a compaction if one is due.
+- (void)synchronize;
+
+/// Rewrites the file with only the live records. Normally scheduled by `synchronize`.
+- (void)compact;
+
+@property (nonatomic, assign, readonly) NSUInteger count;
+@property (nonatomic, assign, readonly) NSUInteger garbageBytes;
+
+/// Key and value bytes appended since the store was opened.
+@property (nonatomic, assign, readonly) NSUInteger bytesWritten;
+
+/// Store file name in the Branch directory.
++ (NSURL *)defaultURL;
+
+@end
+
+NS_ASSUME_NONNULL_END
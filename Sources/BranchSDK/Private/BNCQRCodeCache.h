@@ -10,11 +10,60 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+typedef void (^BNCQRCodeCacheCompletion)(NSData * _Nullable qrCode, NSError * _Nullable error);
+
+// Pass NO for `cacheable` to deliver a QR code without storing it, e.g. one for a fallback link.
+typedef void (^BNCQRCodeCacheFetchCompletion)(NSData * _Nullable qrCode, NSError * _Nullable error, BOOL cacheable);
+
+/**
+ Two tier cache of QR code images.
+
+ Images are kept in a memory LRU bounded by `memoryBytesLimit` and written through to files in a
+ directory bounded by `diskBytesLimit`. Entries are keyed by a hash of the canonical JSON request
+ parameters, ignoring the per request timestamp and UUID.
+ */
 @interface BNCQRCodeCache : NSObject
 
 + (BNCQRCodeCache *) sharedInstance;
-- (void)addQRCodeToCache:(NSData *)qrCodeData withParams:(NSMutableDictionary *)parameters;
-- (NSData *)checkQRCodeCache:(NSMutableDictionary *)parameters;
+
+/// In memory only cache.
+- (instancetype)init;
+
+/// Cache with a disk tier in `directoryURL`. Passing `nil` is the same as `init`.
+- (instancetype)initWithDirectoryURL:(nullable NSURL *)directoryURL NS_DESIGNATED_INITIALIZER;
+
+/// Directory under `BNCURLForBranchDirectory()` used by the shared instance.
++ (NSURL *)defaultDirectoryURL;
+
+/// Cache key for the QR code request parameters, nil if the parameters are not valid JSON.
++ (nullable NSString *)cacheKeyForParams:(NSDictionary *)parameters;
+
+- (void)addQRCodeToCache:(NSData *)qrCodeData withParams:(NSDictionary *)parameters;
+- (nullable NSData *)checkQRCodeCache:(NSDictionary *)parameters;
+
+/**
+ Returns the cached QR code for the parameters, or calls `fetch` to load it.
+ Concurrent misses for the same parameters share one fetch; successful, cacheable results are cached.
+ */
+- (void)qrCodeForParams:(NSDictionary *)parameters
+                  fetch:(void (^)(BNCQRCodeCacheFetchCompletion done))fetch
+             completion:(BNCQRCodeCacheCompletion)completion;
+
+/// Removes all entries, in memory and on disk. Called whenever the link cache and preferences are reset.
+- (void)clear;
+
+/// Waits for pending disk writes to finish.
+- (void)synchronize;
+
+@property (assign, nonatomic) NSUInteger memoryBytesLimit;  // Default 2 MB
+@property (assign, nonatomic) NSUInteger diskBytesLimit;    // Default 10 MB
+@property (assign, nonatomic) NSTimeInterval timeToLive;   // Default 7 days, in memory and on disk
+
+@property (assign, nonatomic, readonly) NSUInteger count;
+@property (assign, nonatomic, readonly) NSUInteger memoryBytes;
+
+// Number of fetches started by qrCodeForParams:fetch:completion:
+@property (assign, nonatomic, readonly) NSUInteger fetchCount;
 
 @end
 
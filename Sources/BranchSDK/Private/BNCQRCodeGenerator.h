@@ -0,0 +1,37 @@
+//
+//  BNCQRCodeGenerator.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if __has_feature(modules)
+@import UIKit;
+#else
+#import <UIKit/UIKit.h>
+#endif
+#import "BranchQRCode.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Renders QR code images on device with `BNCQREncoder`, mirroring the styles of the QR code service.
+ */
+@interface BNCQRCodeGenerator : NSObject
+
+@property (nonatomic, strong, nullable) UIColor *codeColor;         // Default black
+@property (nonatomic, strong, nullable) UIColor *backgroundColor;   // Default white
+@property (nonatomic, strong, nullable) UIImage *centerLogo;
+@property (nonatomic, assign) NSInteger width;                      // Image side in pixels
+@property (nonatomic, assign) NSInteger margin;                     // Border in pixels
+@property (nonatomic, assign) BranchQRCodeImageFormat imageFormat;
+
+/// NO when a style setting can only be rendered by the QR code service.
+- (BOOL)supportsStyle;
+
+/// Encoded PNG or JPEG image, or nil when the string or style cannot be rendered locally.
+- (nullable NSData *)imageDataForString:(NSString *)string;
+
+@end
+
+NS_ASSUME_NONNULL_END
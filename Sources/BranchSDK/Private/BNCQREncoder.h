@@ -0,0 +1,63 @@
+//
+//  BNCQREncoder.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+// QR code (ISO/IEC 18004) encoder for byte mode payloads, versions 1 to 40.
+// Plain C with no platform dependencies so it can be built and tested on any host.
+
+#ifndef BNCQREncoder_h
+#define BNCQREncoder_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    BNCQRErrorCorrectionLow = 0,    // ~7% recovery
+    BNCQRErrorCorrectionMedium,     // ~15% recovery
+    BNCQRErrorCorrectionQuartile,   // ~25% recovery
+    BNCQRErrorCorrectionHigh        // ~30% recovery
+} BNCQRErrorCorrection;
+
+enum {
+    BNCQRVersionMin = 1,
+    BNCQRVersionMax = 40,
+    BNCQRMaskAuto = -1
+};
+
+typedef struct {
+    int version;
+    int size;                           // modules per side, 17 + 4 * version
+    BNCQRErrorCorrection errorCorrection;
+    int mask;
+    uint8_t *modules;                   // size * size, row major, 1 is dark
+} BNCQRCode;
+
+/**
+ Encodes `length` bytes of `data`, using the smallest version that fits.
+ The error correction level is raised above `minErrorCorrection` when that does not need a larger version.
+ Pass BNCQRMaskAuto to pick the mask with the lowest penalty score, or 0 to 7 to force one.
+ Returns NULL when the payload does not fit in version 40 or allocation fails.
+ */
+BNCQRCode *BNCQRCodeCreate(const uint8_t *data, size_t length, BNCQRErrorCorrection minErrorCorrection, int mask);
+
+void BNCQRCodeRelease(BNCQRCode *code);
+
+/// Returns true for a dark module. Coordinates outside the symbol are light.
+bool BNCQRCodeGetModule(const BNCQRCode *code, int x, int y);
+
+/// Maximum payload in bytes for the version and error correction level.
+size_t BNCQRCodeByteCapacity(int version, BNCQRErrorCorrection errorCorrection);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BNCQREncoder_h */
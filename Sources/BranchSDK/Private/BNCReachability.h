@@ -12,12 +12,19 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Posted on a background queue when the network path changes.
+extern NSString * const BNCReachabilityDidChangeNotification;
+
 @interface BNCReachability : NSObject
 
 + (BNCReachability *)shared;
 
+/// wifi, mobile or nil when offline. Kept up to date by path change callbacks, so this makes no system call.
 - (nullable NSString *)reachabilityStatus;
 
+/// The first IPv4 address of an active interface, refreshed on path changes and when the app becomes active.
+- (nullable NSString *)localIPAddress;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,52 @@
+//
+//  BNCRequestCoalescer.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^BNCRequestCoalescerCompletion)(id _Nullable result, NSError * _Nullable error);
+
+/**
+ Runs one request per key at a time. Callers that ask for a key while its request is in flight are
+ attached to that request and receive its result, instead of starting another one.
+ */
+@interface BNCRequestCoalescer : NSObject
+
+/**
+ Calls `work` if no request for `key` is in flight, otherwise only queues `completion`.
+ `work` must call `finish` exactly once. Every queued completion is then called on the thread that calls `finish`.
+ */
+- (void)performForKey:(id<NSCopying>)key
+                 work:(void (^)(BNCRequestCoalescerCompletion finish))work
+           completion:(nullable BNCRequestCoalescerCompletion)completion;
+
+/**
+ Synchronous variant. The first caller runs `work`, concurrent callers for `key` block until it returns
+ and get the same result.
+ */
+- (nullable id)performSynchronouslyForKey:(id<NSCopying>)key work:(id _Nullable (^)(void))work;
+
+/**
+ Ends every request in flight, for when their work will never finish. Queued completions are called with
+ `error` on the current thread, synchronous waiters return nil. A later `finish` from the abandoned work is ignored.
+ */
+- (void)failAllWithError:(NSError *)error;
+
+/// Number of keys with a request in flight.
+@property (nonatomic, assign, readonly) NSUInteger inFlightCount;
+
+/// Number of callers attached to a request that was already in flight.
+@property (nonatomic, assign, readonly) NSUInteger coalescedCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -22,6 +22,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSString *)standardEventServiceURL;
 - (NSString *)customEventServiceURL;
 - (NSString *)linkServiceURL;
+- (NSString *)linkBulkServiceURL;
 - (NSString *)qrcodeServiceURL;
 - (NSString *)latdServiceURL;
 - (NSString *)validationServiceURL;
@@ -0,0 +1,51 @@
+//
+//  BNCStartupPipeline.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Startup work as a graph of named stages.
+
+ A stage runs on a concurrent queue once the stages it depends on are complete, so independent stages run
+ at the same time. Consumers wait for only the stages they read instead of for everything queued before them.
+ The duration of each stage is logged and kept in `stageTimings`.
+ */
+@interface BNCStartupPipeline : NSObject
+
+/**
+ Adds a stage. `work` must call `complete` exactly once, from any thread.
+ Dependencies must be added before the stages that depend on them. Stages added after `start` run as soon as they are ready.
+ */
+- (void)addStage:(NSString *)name dependencies:(nullable NSArray<NSString *> *)dependencies work:(void (^)(dispatch_block_t complete))work;
+
+/// Starts every stage whose dependencies are complete.
+- (void)start;
+
+/// Calls `block` on `queue` once every stage in `stages` is complete. Unknown stages are treated as complete.
+- (void)notifyWhenStagesComplete:(NSArray<NSString *> *)stages queue:(dispatch_queue_t)queue block:(dispatch_block_t)block;
+
+/// Waits up to `timeout` seconds for `stages`. Returns NO on timeout.
+- (BOOL)waitForStages:(NSArray<NSString *> *)stages timeout:(NSTimeInterval)timeout;
+
+/// YES for unknown stages.
+- (BOOL)isStageComplete:(NSString *)name;
+
+/// Milliseconds each completed stage took from when its dependencies were met.
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, NSNumber *> *stageTimings;
+
+/// Milliseconds from `start` to the completion of each completed stage.
+@property (nonatomic, copy, readonly) NSDictionary<NSString *, NSNumber *> *stageCompletionTimes;
+
+@end
+
+NS_ASSUME_NONNULL_END
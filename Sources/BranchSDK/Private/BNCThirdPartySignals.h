@@ -0,0 +1,54 @@
+//
+//  BNCThirdPartySignals.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if !TARGET_OS_TV
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+@class BNCPreferenceHelper;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ ODM info and the AdServices attribution token, gathered ahead of the requests that send them.
+
+ Gathering starts at SDK init and sets a deadline of `thirdPartyAPIsWaitTime` from then. A request built before the
+ deadline waits only for what is left of it, one built after takes whatever is ready without waiting.
+ ODM info is cached in the preferences with its validity window, the attribution token in memory for `attributionTokenValidityWindow`.
+ */
+@interface BNCThirdPartySignals : NSObject
+
++ (BNCThirdPartySignals *)shared;
+
+- (instancetype)initWithPreferenceHelper:(BNCPreferenceHelper *)preferenceHelper;
+
+/// Starts loading the signals that are missing or expired, unless a load is running. `completion` is called on a background queue once it is done.
+- (void)gatherSignalsWithCompletion:(nullable dispatch_block_t)completion;
+
+/// Waits for the running load until its deadline. Starts a load first if none was started.
+- (void)waitForSignalsUntilDeadline;
+
+/// Valid ODM info, nil if there is none.
+@property (atomic, copy, readonly, nullable) NSString *odmInfo;
+
+/// The attribution token while it is valid, nil if it is not loaded or expired.
+@property (atomic, copy, readonly, nullable) NSString *appleAttributionToken;
+
+/// Apple accepts a token for 24 hours.
+@property (atomic, assign, readwrite) NSTimeInterval attributionTokenValidityWindow;
+
+// Overridden in tests
+- (void)loadODMInfoWithCompletion:(void (^)(void))completion;
+- (nullable NSString *)loadAppleAttributionToken;
+
+@end
+
+NS_ASSUME_NONNULL_END
+#endif
@@ -0,0 +1,72 @@
+//
+//  BNCTimingRing.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+// Fixed capacity ring of request round trip times.
+// Any thread records without locking, a full ring overwrites the oldest records.
+// Summaries aggregate the records not yet consumed into count, min, max and percentiles per endpoint.
+// Plain C with C11 atomics so it can be built and stress tested on any host.
+
+#ifndef BNCTimingRing_h
+#define BNCTimingRing_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BNCTimingRing BNCTimingRing;
+
+enum {
+    BNCTimingRingDefaultCapacity = 256
+};
+
+typedef struct {
+    uint32_t endpoint;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t last;      // most recently recorded
+} BNCTimingSummary;
+
+/// Callback for BNCTimingRingSummarize, called once per endpoint in ascending endpoint order.
+typedef void (*BNCTimingSummaryHandler)(const BNCTimingSummary *summary, void *context);
+
+/// Creates a ring holding at least `capacity` records, rounded up to a power of two. Returns NULL if out of memory.
+BNCTimingRing *BNCTimingRingCreate(size_t capacity);
+
+void BNCTimingRingRelease(BNCTimingRing *ring);
+
+/// Stable identifier for an endpoint name.
+uint32_t BNCTimingRingEndpointID(const char *endpoint, size_t length);
+
+/// Records a round trip. Lock free and safe from any thread.
+void BNCTimingRingRecord(BNCTimingRing *ring, uint32_t endpoint, uint32_t milliseconds);
+
+/**
+ Summarizes the records not yet consumed and returns how many were summarized.
+ With `consume` they are not summarized again, records still being written are left for the next call.
+ `dropped`, if not NULL, is set to the number of records overwritten before they were consumed.
+ */
+size_t BNCTimingRingSummarize(BNCTimingRing *ring, bool consume, BNCTimingSummaryHandler handler, void *context, uint64_t *dropped);
+
+/// Number of records not yet consumed, at most the capacity.
+size_t BNCTimingRingPendingCount(const BNCTimingRing *ring);
+
+/// Marks every record consumed.
+void BNCTimingRingReset(BNCTimingRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BNCTimingRing_h */
@@ -0,0 +1,90 @@
+//
+//  BNCTrace.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+// Opt-in span tracing for cold start, exported in the Chrome trace event format, which Perfetto also reads.
+// Events go into a buffer allocated when tracing starts, a full buffer drops new events.
+// When tracing is off the macros cost one relaxed atomic load.
+// Plain C with C11 atomics so it can be built and stress tested on any host.
+
+#ifndef BNCTrace_h
+#define BNCTrace_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    BNCTraceDefaultCapacity = 2048,
+    BNCTraceNameLength = 48
+};
+
+// Chrome trace event phases
+typedef enum {
+    BNCTracePhaseBegin = 'B',       // span on the recording thread, ended by BNCTracePhaseEnd on the same thread
+    BNCTracePhaseEnd = 'E',
+    BNCTracePhaseAsyncBegin = 'b',  // span that may end on another thread, matched by name and identifier
+    BNCTracePhaseAsyncEnd = 'e',
+    BNCTracePhaseInstant = 'i'
+} BNCTracePhase;
+
+typedef struct {
+    char name[BNCTraceNameLength];  // truncated
+    char phase;
+    uint64_t thread;
+    uint64_t identifier;            // async spans only
+    uint64_t timestamp;             // microseconds, monotonic
+} BNCTraceEvent;
+
+extern atomic_bool BNCTraceEnabled;
+
+static inline bool BNCTraceIsEnabled(void) {
+    return atomic_load_explicit(&BNCTraceEnabled, memory_order_relaxed);
+}
+
+/**
+ Starts recording into a buffer of at least `capacity` events, discarding any earlier events.
+ The buffer is allocated on the first start and kept. Returns false if it cannot be allocated.
+ */
+bool BNCTraceStart(size_t capacity);
+
+/// Stops recording. Recorded events stay available.
+void BNCTraceStop(void);
+
+/// Records an event if tracing is on. Prefer the macros, they skip the call when tracing is off.
+void BNCTraceRecord(BNCTracePhase phase, const char *name, uint64_t identifier);
+
+/// A new identifier for an async span.
+uint64_t BNCTraceNextIdentifier(void);
+
+/// Copies up to `capacity` recorded events in the order they were recorded and returns how many were copied.
+/// `dropped`, if not NULL, is set to the number of events that did not fit in the buffer.
+size_t BNCTraceCopyEvents(BNCTraceEvent *events, size_t capacity, uint64_t *dropped);
+
+/// Writes the recorded events as a Chrome trace JSON object. Returns 0 or an errno value.
+int BNCTraceWriteJSON(const char *path);
+
+#define BNC_TRACE_BEGIN(name) \
+    do { if (BNCTraceIsEnabled()) BNCTraceRecord(BNCTracePhaseBegin, (name), 0); } while (0)
+#define BNC_TRACE_END(name) \
+    do { if (BNCTraceIsEnabled()) BNCTraceRecord(BNCTracePhaseEnd, (name), 0); } while (0)
+#define BNC_TRACE_ASYNC_BEGIN(name, identifier) \
+    do { if (BNCTraceIsEnabled()) BNCTraceRecord(BNCTracePhaseAsyncBegin, (name), (identifier)); } while (0)
+#define BNC_TRACE_ASYNC_END(name, identifier) \
+    do { if (BNCTraceIsEnabled()) BNCTraceRecord(BNCTracePhaseAsyncEnd, (name), (identifier)); } while (0)
+#define BNC_TRACE_INSTANT(name) \
+    do { if (BNCTraceIsEnabled()) BNCTraceRecord(BNCTracePhaseInstant, (name), 0); } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BNCTrace_h */
@@ -39,6 +39,9 @@ NS_ASSUME_NONNULL_BEGIN
 // Refreshes the list of ignored URL regex patterns from the server
 - (void)updatePatternListFromServerWithCompletion:(void (^_Nullable) (void))completion;
 
+// Refreshes the list once the main run loop is idle
+- (void)updatePatternListFromServerWhenIdle;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,47 @@
+//
+//  BNCURLPatternMatcher.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Matches URL strings against a list of regular expressions, returning the first pattern in list order that matches.
+
+ Each pattern is analyzed for conditions every match must meet, such as a literal prefix like `fb` in `^fb\d+:`
+ or a scheme list like `(http|https):`. A URL only runs the expressions whose conditions it meets, and results are
+ the same as running every expression in order.
+ */
+@interface BNCURLPatternMatcher : NSObject
+
+/// Compiles the patterns. Invalid patterns are logged and skipped.
+- (instancetype)initWithPatterns:(NSArray<NSString *> *)patterns NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Restores a matcher from `dictionaryRepresentation` without analyzing the patterns again.
+/// Expressions are compiled when first needed. Returns nil if the dictionary is not from this format.
+- (nullable instancetype)initWithDictionary:(NSDictionary *)dictionary NS_DESIGNATED_INITIALIZER;
+
+/// The analyzed patterns as a property list.
+- (NSDictionary *)dictionaryRepresentation;
+
+/// The patterns that compiled, in list order.
+@property (nonatomic, copy, readonly) NSArray<NSString *> *patterns;
+
+/// Returns the first pattern that matches the string, or nil.
+- (nullable NSString *)patternMatchingString:(NSString *)string;
+
+/// Number of expressions the string would run, for testing the pre-filter.
+- (NSUInteger)candidateCountForString:(NSString *)string;
+
+@end
+
+NS_ASSUME_NONNULL_END
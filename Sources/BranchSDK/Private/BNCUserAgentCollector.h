@@ -22,10 +22,20 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (BNCUserAgentCollector *)instance;
 
-@property (nonatomic, copy, readwrite) NSString *userAgent;
+@property (atomic, copy, readwrite) NSString *userAgent;
+
+/**
+ When there is no user agent saved for this OS build, complete at once with the previous OS build's user agent or
+ a synthesized one, and collect the real one from WebKit once the main thread is idle. Requests built after that
+ get the real user agent. NO by default.
+ */
+@property (atomic, assign, readwrite) BOOL deferCollection;
 
 - (void)loadUserAgentWithCompletion:(void (^)(NSString * _Nullable userAgent))completion;
 
+/// A user agent in the format WebKit reports, built from the device model and OS version.
+- (NSString *)synthesizedUserAgent;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -22,6 +22,7 @@
 + (void) waitForOpenResponseLock;
 + (void) releaseOpenResponseLock;
 + (void) setWaitNeededForOpenResponseLock;
++ (void) notifyWhenOpenResponseLockReleased:(dispatch_block_t)block;  // does not block, runs block on a background queue
 
 - (id)initWithCallback:(callbackWithStatus)callback;
 - (id)initWithCallback:(callbackWithStatus)callback isInstall:(BOOL)isInstall;
@@ -0,0 +1,28 @@
+//
+//  BranchShortUrlBatchRequest.h
+//  Branch
+//
+//  Copyright © 2026 Branch, Inc. All rights reserved.
+//
+
+#import "BNCServerRequest.h"
+#import "BranchShortUrlRequest.h"
+
+/**
+ Creates the short links for several BranchShortUrlRequests with one call to the bulk link endpoint.
+
+ Links already in the link cache are answered locally, and requests with the same link data share
+ one entry in the batch. Each result is handled by its BranchShortUrlRequest, so new links are cached
+ and failures fall back to long links exactly as for a single request.
+ */
+@interface BranchShortUrlBatchRequest : BNCServerRequest
+
+/// The callback receives one entry per request, in order: the URL string, or NSNull if none could be made.
+- (instancetype _Nonnull)initWithRequests:(NSArray<BranchShortUrlRequest *> * _Nonnull)requests
+                                linkCache:(BNCLinkCache * _Nullable)linkCache
+                                 callback:(callbackWithUrls _Nullable)callback;
+
+/// Number of distinct links that were not in the cache and need the server.
+@property (nonatomic, assign, readonly) NSUInteger missCount;
+
+@end
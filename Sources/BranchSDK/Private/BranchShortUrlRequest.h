@@ -12,6 +12,8 @@
 @interface BranchShortUrlRequest : BNCServerRequest
 
 @property (nonatomic, assign) BOOL isSpotlightRequest;
+@property (nonatomic, strong, readonly) BNCLinkData *linkData;
+@property (nonatomic, strong) callbackWithUrl callback;
 
 - (id)initWithTags:(NSArray *)tags alias:(NSString *)alias type:(BranchLinkType)type matchDuration:(NSInteger)duration channel:(NSString *)channel feature:(NSString *)feature stage:(NSString *)stage campaign:(NSString *)campaign params:(NSDictionary *)params linkData:(BNCLinkData *)linkData linkCache:(BNCLinkCache *)linkCache callback:(callbackWithUrl)callback;
 
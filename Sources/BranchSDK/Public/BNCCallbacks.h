@@ -16,6 +16,7 @@
 
 typedef void (^callbackWithParams) (NSDictionary * _Nullable params, NSError * _Nullable error);
 typedef void (^callbackWithUrl) (NSString * _Nullable url, NSError * _Nullable error);
+typedef void (^callbackWithUrls) (NSArray * _Nonnull urls, NSError * _Nullable error);
 typedef void (^callbackWithStatus) (BOOL changed, NSError * _Nullable error);
 typedef void (^callbackWithList) (NSArray * _Nullable list, NSError * _Nullable error);
 typedef void (^callbackWithUrlAndSpotlightIdentifier) (NSString * _Nullable url, NSString * _Nullable spotlightIdentifier, NSError * _Nullable error);
@@ -8,8 +8,48 @@
 
 #import "BNCLinkData.h"
 
+/**
+ A bounded LRU cache of short links keyed by `BNCLinkData`.
+
+ Entries expire after `timeToLive` and the least recently used entries are evicted once either
+ `countLimit` or `totalBytesLimit` is exceeded. A cache created with a storage URL is loaded
+ lazily on first use and written back to disk in the background, so links survive app launches.
+ */
 @interface BNCLinkCache : NSObject
+
+/// In memory only cache.
+- (instancetype)init;
+
+/// Cache persisted to `storageURL`. Passing `nil` is the same as `init`.
+- (instancetype)initWithStorageURL:(NSURL *)storageURL NS_DESIGNATED_INITIALIZER;
+
+/// File under `BNCURLForBranchDirectory()` used by the shared Branch instance.
++ (NSURL *)defaultStorageURL;
+
 - (void)setObject:(NSString *)anObject forKey:(BNCLinkData *)aKey;
 - (NSString *)objectForKey:(BNCLinkData *)aKey;
 - (void) clear;
+
+/**
+ Links are only valid for the Branch key and user URL they were created with.
+ Drops all entries, in memory and on disk, when either value differs from the previous context.
+ */
+- (void)updateContextWithBranchKey:(NSString *)branchKey userUrl:(NSString *)userUrl;
+
+/// Writes any pending changes to disk and waits for the write to finish.
+- (void)synchronize;
+
+@property (assign, nonatomic) NSUInteger countLimit;        // Default 128 entries
+@property (assign, nonatomic) NSUInteger totalBytesLimit;   // Default 64 KB of link and key data
+@property (assign, nonatomic) NSTimeInterval timeToLive;    // Default 7 days
+
+@property (assign, nonatomic, readonly) NSUInteger count;
+@property (assign, nonatomic, readonly) NSUInteger totalBytes;
+
+// Lookup statistics since creation or the last resetStatistics
+@property (assign, nonatomic, readonly) NSUInteger hitCount;
+@property (assign, nonatomic, readonly) NSUInteger missCount;
+@property (assign, nonatomic, readonly) double hitRate;
+- (void)resetStatistics;
+
 @end
@@ -32,4 +32,10 @@ typedef NS_ENUM(NSUInteger, BranchLinkType) {
 - (void)setupMatchDuration:(NSUInteger)duration;
 - (void)setupIgnoreUAString:(NSString *)ignoreUAString;
 
+/// The link data as JSON with sorted keys, or nil if it holds values JSON cannot represent.
+- (NSString *)canonicalJSONString;
+
+/// SHA-256 of `canonicalJSONString`. Unlike `hash` it is the same across launches. Nil when there is no canonical JSON.
+- (NSString *)digest;
+
 @end
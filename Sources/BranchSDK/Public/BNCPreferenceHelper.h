@@ -59,6 +59,7 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory(void);
 @property (nonatomic, copy, readwrite) NSString *patternListURL;
 @property (strong, nonatomic) NSArray<NSString *> *savedURLPatternList;
 @property (assign, nonatomic) NSInteger savedURLPatternListVersion;
+@property (copy, nonatomic) NSString *savedURLPatternListETag;
 @property (assign, nonatomic) BOOL dropURLOpen;
 
 @property (assign, nonatomic) BOOL trackingDisabled;
@@ -86,6 +87,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory(void);
 @property (copy, nonatomic) NSString *uxType;
 @property (strong, nonatomic) NSDate *urlLoadMs;
 
+// Time the first preference read waited on the background load
+@property (atomic, assign, readonly) NSTimeInterval loadBlockedTime;
+
 - (void) clearTrackingInformation;
 
 + (BNCPreferenceHelper *)sharedInstance;
@@ -98,6 +102,8 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory(void);
 - (void)addInstrumentationDictionaryKey:(NSString *)key value:(NSString *)value;
 - (NSMutableDictionary *)instrumentationDictionary;
 - (NSDictionary *)instrumentationParameters; // a safe copy to use in a POST body
+- (NSDictionary *)takeInstrumentationParameters; // same, round trip times are only sent once
+- (void)addRoundTripTime:(NSTimeInterval)milliseconds forEndpoint:(NSString *)endpoint;
 - (void)clearInstrumentationDictionary;
 
 - (void)saveBranchAnalyticsData:(NSDictionary *)analyticsData;
@@ -107,6 +113,9 @@ NSURL* /* _Nonnull */ BNCURLForBranchDirectory(void);
 - (void)saveContentAnalyticsManifest:(NSDictionary *)cdManifest;
 
 - (NSMutableString*) sanitizedMutableBaseURL:(NSString*)baseUrl;
+- (void) flush;        //  Archives pending changes now and queues the write.
+- (void) performBatchUpdates:(void (NS_NOESCAPE ^)(void))updates;  //  Writes made by updates are persisted together in one flush when it returns.
+- (void) preloadPersistenceDict;  //  Loads preferences on a background queue, the first read waits only if it is not done.
 - (void) synchronize;  //  Flushes preference queue to persistence.
 + (void) clearAll;
 - (BOOL) eeaRegionInitialized;
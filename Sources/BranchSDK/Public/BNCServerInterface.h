@@ -28,6 +28,12 @@ typedef void (^BNCServerCallback)(BNCServerResponse *response, NSError *error);
                 key:(NSString *)key
            callback:(BNCServerCallback)callback;
 
+// Posts a JSON array, such as the bulk link endpoint expects
+- (void)postRequestWithArray:(NSArray<NSDictionary *> *)post
+                         url:(NSString *)url
+                         key:(NSString *)key
+                    callback:(BNCServerCallback)callback;
+
 - (void)genericHTTPRequest:(NSURLRequest *)request
                retryNumber:(NSInteger)retryNumber
                   callback:(BNCServerCallback)callback
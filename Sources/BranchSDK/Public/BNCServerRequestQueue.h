@@ -9,6 +9,9 @@
 #import "BNCServerRequest.h"
 @class BranchOpenRequest;
 
+/// Posted by clearQueue. Requests removed from the queue never get a response.
+extern NSString * const BNCServerRequestQueueDidClearNotification;
+
 @interface BNCServerRequestQueue : NSObject
 
 - (void)enqueue:(BNCServerRequest *)request;
@@ -754,6 +754,20 @@ Sets a custom base safetrack URL for non-linking calls to the Branch API.
  */
 - (void)setNetworkTimeout:(NSTimeInterval)timeout;
 
+/**
+ Serve foregrounds that follow a recent open from the cached session.
+
+ When the app becomes active within `interval` seconds of the last open, with no link, user activity or
+ spotlight item waiting, the init callback gets the latest referring params right away and the open is sent
+ in the background. Foregrounds with new link data always wait for a full open.
+
+ If the background open returns a session from a link, such as a deferred deep link, the init callback is
+ called a second time with that session.
+
+ @param interval Number of seconds since the last open. Default is 0, which disables warm resume.
+ */
+- (void)setWarmResumeInterval:(NSTimeInterval)interval;
+
 /**
  Set the SDK wait time for third party APIs (for fetching ODM info and Apple Attribution Token) to finish
  This timeout should be > 0 and <= 10 seconds.
@@ -762,6 +776,25 @@ Sets a custom base safetrack URL for non-linking calls to the Branch API.
  */
 + (void)setSDKWaitTimeForThirdPartyAPIs:(NSTimeInterval)waitTime;
 
+/**
+ Send the install or open without waiting for WebKit to report the browser user agent.
+
+ WebKit is asked for the user agent on first launch and after every OS update, which starts a web view and
+ delays the first request. When deferred, the first request uses the user agent saved on the previous OS version,
+ or one synthesized in the same format, and the real one is collected once the app is idle. Call before `getInstance`.
+
+ @param deferred Defer user agent collection. Default is NO.
+ */
++ (void)setUserAgentCollectionDeferred:(BOOL)deferred;
+
+/**
+ Record where the SDK spends time from `getInstance` to the first init callback, for debugging startup latency.
+
+ Spans are written as Chrome trace event JSON to BranchColdStartTrace.json in the Branch directory, normally under Application Support.
+ Open the file in Perfetto or chrome://tracing. Call before `getInstance`. Tracing stops after the first init callback.
+ */
++ (void)enableColdStartTracing;
+
 /**
  Disable callouts to ad networks for all events for a user; by default Branch sends callouts to ad networks.
  
@@ -985,6 +1018,24 @@ extern BranchAttributionLevel const BranchAttributionLevelNone;
  */
 - (nullable NSDictionary*) getLatestReferringParamsSynchronous;
 
+/**
+ Returns the most recent referral parameters for this user, waiting at most `timeout` seconds for an open in progress.
+ If the open has not responded by then, the parameters from the previous session are returned.
+ @warning This call blocks the calling thread.
+
+ @param timeout Maximum number of seconds to wait. Zero or less waits until the open responds.
+ */
+- (nullable NSDictionary *)getLatestReferringParamsSynchronousWithTimeout:(NSTimeInterval)timeout;
+
+/**
+ Calls `completion` on the main thread with the most recent referral parameters once any open in progress has responded,
+ without blocking the calling thread. In Swift this can be awaited.
+
+ @param timeout Maximum number of seconds to wait. Zero or less waits until the open responds.
+ @param completion Called once, with the parameters, or with an error if the open did not respond within `timeout`.
+ */
+- (void)getLatestReferringParamsWithTimeout:(NSTimeInterval)timeout completion:(void (^)(NSDictionary * _Nullable params, NSError * _Nullable error))completion;
+
 /**
  Tells Branch to act as though initSession hadn't been called. Will require another open call (this is done automatically, internally).
  */
@@ -1539,6 +1590,20 @@ extern BranchAttributionLevel const BranchAttributionLevelNone;
  */
 - (void)getSpotlightUrlWithParams:(NSDictionary *)params callback:(callbackWithParams)callback;
 
+/**
+ Get short urls for several universal objects with a single request to Branch.
+
+ Links already in the link cache are returned without a request, and identical links are only created once.
+ When a link cannot be created its long url is returned in its place, as with the single link methods.
+
+ This method should only be invoked after initSession completes, either within the callback or after a delay.
+
+ @param universalObjects The content to create links for.
+ @param linkProperties Link properties for each universal object, in the same order. Must have the same count as `universalObjects`.
+ @param callback Called on the main thread with one entry per universal object, in order: the url string, or NSNull when no url could be made. The error is the first one encountered.
+ */
+- (void)getShortUrlsForUniversalObjects:(NSArray<BranchUniversalObject *> *)universalObjects linkProperties:(NSArray<BranchLinkProperties *> *)linkProperties andCallback:(nullable callbackWithUrls)callback;
+
 #pragma mark - Content Discovery methods
 #if !TARGET_OS_TV
 